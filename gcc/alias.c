@@ -1028,6 +1028,26 @@ output_dependence (mem, x)
 		&& ! MEM_IN_STRUCT_P (mem) && ! rtx_addr_varies_p (mem)));
 }
 
+/* Loop dependence: MEM and X are two memory references, at least one
+   of them a store, that may be executed in different iterations of a
+   loop.  The registers in their addresses may then hold unrelated
+   values, so only the base values of the addresses and the alias sets
+   can tell them apart.  */
+
+int
+loop_dependence (mem, x)
+     rtx mem;
+     rtx x;
+{
+  if (MEM_VOLATILE_P (x) && MEM_VOLATILE_P (mem))
+    return 1;
+
+  if (DIFFERENT_ALIAS_SETS_P (x, mem))
+    return 0;
+
+  return base_alias_check (XEXP (x, 0), XEXP (mem, 0));
+}
+
 
 static HARD_REG_SET argument_registers;
 
@@ -0,0 +1,768 @@
+/* Lay out the basic blocks of a function using profile data.
+   Copyright (C) 1999 Free Software Foundation, Inc.
+
+This file is part of GNU CC.
+
+GNU CC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+GNU CC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GNU CC; see the file COPYING.  If not, write to
+the Free Software Foundation, 59 Temple Place - Suite 330,
+Boston, MA 02111-1307, USA.  */
+
+
+/* This pass reorders the basic blocks of a function so that the paths
+   taken most often in a profiled run fall through, and so that the
+   blocks that were never executed end up at the end of the function,
+   out of the way of the instruction cache.
+
+   It uses the REG_EXEC_COUNT notes that profile.c puts on the first
+   insn of each basic block and the REG_BR_PROB notes it puts on the
+   conditional jumps when -fbranch-probabilities is given.  A function
+   without such notes is left alone.
+
+   The pass runs after reload and the second scheduling pass, so that
+   nothing later undoes the layout, and before the last jump
+   optimization pass, which deletes the jumps to the next insn that the
+   new layout leaves behind.  Delayed branch scheduling then fills the
+   slots of the branches in their final direction.
+
+   The blocks are put together into chains in the manner of Pettis and
+   Hansen: the arcs between blocks are visited from the most to the
+   least often taken, and an arc joins the chain ending in its source
+   block to the chain starting with its destination block, which makes
+   the arc a fallthrough.  The chain holding the entry block comes
+   first, the other chains follow in their original order, and the
+   chains of blocks that were never executed come last.  Finally, each
+   block whose fallthrough successor is no longer next gets a jump to
+   it, and each conditional jump to the next block is inverted.
+
+   Blocks are not moved across exception regions or lexical scopes, so
+   functions that have exception regions or non-local labels, and
+   functions with nested scopes when generating debugging information,
+   are left alone.  */
+
+#include "config.h"
+#include "system.h"
+#include "rtl.h"
+#include "insn-config.h"
+#include "insn-flags.h"
+#include "flags.h"
+#include "basic-block.h"
+#include "output.h"
+#include "toplev.h"
+
+/* A basic block of the function being reordered.  */
+
+struct reorder_block
+{
+  /* The first insn of the block, a CODE_LABEL or the first insn after a
+     jump or barrier, and the last insn of the block that is not a
+     dispatch table or barrier.  */
+  rtx head, end;
+
+  /* The insns that move with the block: the notes in front of HEAD
+     through the barrier and dispatch table after END.  */
+  rtx first, last;
+
+  /* How many times the block was executed, or -1 if not known.  */
+  HOST_WIDE_INT count;
+
+  /* The block control falls into after END and the block the jump at END
+     goes to, or -1, and how many times each of these arcs was taken.  */
+  int fall, target;
+  HOST_WIDE_INT fall_count, target_count;
+
+  /* Nonzero if control falls off the end of the function after END.  */
+  char falls_out;
+
+  /* The chain holding the block, and the block after it in that chain,
+     or -1.  */
+  int chain, next;
+};
+
+/* A chain of blocks that are laid out one after the other.  */
+
+struct reorder_chain
+{
+  /* The first and last block of the chain, and its number of blocks.  */
+  int head, tail, size;
+
+  /* Nonzero if the chain holds the entry block, or a block that falls off
+     the end of the function.  */
+  char has_entry, falls_out;
+
+  /* Nonzero if the blocks of the chain were never executed.  */
+  char cold;
+};
+
+/* An arc from SRC to DEST, taken COUNT times.  FALL is nonzero if DEST
+   follows SRC in the original layout.  */
+
+struct reorder_arc
+{
+  int src, dest;
+  HOST_WIDE_INT count;
+  int fall;
+};
+
+static struct reorder_block *blocks;
+static struct reorder_chain *chains;
+static int n_blocks;
+
+static int scan_blocks		PROTO ((rtx, int *));
+static void find_blocks		PROTO ((rtx, int *));
+static HOST_WIDE_INT block_exec_count PROTO ((struct reorder_block *));
+static HOST_WIDE_INT entry_arc_count PROTO ((int));
+static HOST_WIDE_INT entry_block_count PROTO ((void));
+static int compute_counts	PROTO ((void));
+static int compare_arcs		PROTO ((const GENERIC_PTR, const GENERIC_PTR));
+static void join_chains		PROTO ((int, int));
+static int layout_blocks	PROTO ((int *));
+static void relink_blocks	PROTO ((int *));
+static rtx block_label		PROTO ((struct reorder_block *));
+static void emit_jump_to	PROTO ((rtx, rtx));
+static void fixup_jumps		PROTO ((int *));
+static void dump_layout		PROTO ((FILE *, int *));
+
+/* Return nonzero if INSN is a dispatch table.  */
+
+#define DISPATCH_TABLE_P(INSN)					\
+  (GET_CODE (INSN) == JUMP_INSN					\
+   && (GET_CODE (PATTERN (INSN)) == ADDR_VEC			\
+       || GET_CODE (PATTERN (INSN)) == ADDR_DIFF_VEC))
+
+/* Return nonzero if INSN, a CODE_LABEL, only labels a dispatch table.  */
+
+#define TABLE_LABEL_P(INSN)					\
+  (next_nonnote_insn (INSN) != 0				\
+   && DISPATCH_TABLE_P (next_nonnote_insn (INSN)))
+
+/* Count the basic blocks of the insns starting with F, and return the
+   count, or zero if the function must be left alone.  Set *HAVE_COUNTS
+   to nonzero if some insn carries a REG_EXEC_COUNT note.  */
+
+static int
+scan_blocks (f, have_counts)
+     rtx f;
+     int *have_counts;
+{
+  enum rtx_code prev_code = JUMP_INSN;
+  int count = 0;
+  rtx insn;
+
+  *have_counts = 0;
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    {
+      enum rtx_code code = GET_CODE (insn);
+
+      if (code == NOTE)
+	{
+	  switch (NOTE_LINE_NUMBER (insn))
+	    {
+	    case NOTE_INSN_EH_REGION_BEG:
+	    case NOTE_INSN_EH_REGION_END:
+	      return 0;
+
+	    case NOTE_INSN_BLOCK_BEG:
+	    case NOTE_INSN_BLOCK_END:
+	      if (write_symbols != NO_DEBUG)
+		return 0;
+	      break;
+	    }
+	  continue;
+	}
+
+      if ((code == CODE_LABEL && ! TABLE_LABEL_P (insn))
+	  || (GET_RTX_CLASS (code) == 'i'
+	      && (prev_code == JUMP_INSN || prev_code == BARRIER)
+	      && ! DISPATCH_TABLE_P (insn)))
+	count++;
+
+      if (GET_RTX_CLASS (code) == 'i'
+	  && find_reg_note (insn, REG_EXEC_COUNT, NULL_RTX))
+	*have_counts = 1;
+
+      if (! DISPATCH_TABLE_P (insn))
+	prev_code = code;
+    }
+
+  return count;
+}
+
+/* Fill in BLOCKS for the insns starting with F.  UID_BLOCK is indexed by
+   insn uid and receives the number of the block holding each insn.  */
+
+static void
+find_blocks (f, uid_block)
+     rtx f;
+     int *uid_block;
+{
+  enum rtx_code prev_code = JUMP_INSN;
+  rtx insn, last_nonnote = 0;
+  struct reorder_block *bb;
+  int b;
+
+  for (b = get_max_uid () - 1; b >= 0; b--)
+    uid_block[b] = -1;
+
+  b = -1;
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    {
+      enum rtx_code code = GET_CODE (insn);
+
+      if (code != NOTE
+	  && ((code == CODE_LABEL && ! TABLE_LABEL_P (insn))
+	      || (GET_RTX_CLASS (code) == 'i'
+		  && (prev_code == JUMP_INSN || prev_code == BARRIER)
+		  && ! DISPATCH_TABLE_P (insn))))
+	{
+	  /* The notes in front of the new block go with it; the entry
+	     block also takes everything before its first insn.  */
+	  if (b >= 0)
+	    blocks[b].last = last_nonnote;
+	  bb = &blocks[++b];
+	  bb->first = b == 0 ? f : NEXT_INSN (last_nonnote);
+	  bb->head = bb->end = insn;
+	}
+
+      if (b >= 0)
+	{
+	  uid_block[INSN_UID (insn)] = b;
+	  if (GET_RTX_CLASS (code) == 'i' && ! DISPATCH_TABLE_P (insn))
+	    blocks[b].end = insn;
+	}
+
+      if (code != NOTE)
+	{
+	  last_nonnote = insn;
+	  if (! DISPATCH_TABLE_P (insn))
+	    prev_code = code;
+	}
+    }
+
+  /* The last block keeps the notes at the end of the function.  */
+  blocks[b].last = get_last_insn ();
+
+  /* Now find the successors of each block.  */
+  for (b = 0; b < n_blocks; b++)
+    {
+      rtx end = blocks[b].end;
+      rtx next = next_nonnote_insn (end);
+
+      bb = &blocks[b];
+      bb->fall = bb->target = -1;
+      bb->falls_out = 0;
+      bb->chain = b;
+      bb->next = -1;
+
+      if (GET_CODE (end) == JUMP_INSN && JUMP_LABEL (end) != 0
+	  && (simplejump_p (end) || condjump_p (end))
+	  && INSN_UID (JUMP_LABEL (end)) < get_max_uid ()
+	  && ! INSN_DELETED_P (JUMP_LABEL (end)))
+	bb->target = uid_block[INSN_UID (JUMP_LABEL (end))];
+
+      /* Nothing falls into a dispatch table.  */
+      if (next == 0)
+	bb->falls_out = 1;
+      else if (GET_CODE (next) != BARRIER
+	       && ! (GET_CODE (next) == CODE_LABEL && TABLE_LABEL_P (next)))
+	bb->fall = b + 1;
+    }
+}
+
+/* Return the execution count of the block BB from its REG_EXEC_COUNT
+   note, or -1 if it has none.  */
+
+static HOST_WIDE_INT
+block_exec_count (bb)
+     struct reorder_block *bb;
+{
+  rtx insn, note;
+
+  for (insn = bb->head; ; insn = NEXT_INSN (insn))
+    {
+      if (GET_RTX_CLASS (GET_CODE (insn)) == 'i'
+	  && (note = find_reg_note (insn, REG_EXEC_COUNT, NULL_RTX)) != 0)
+	return INTVAL (XEXP (note, 0)) < 0 ? 0 : INTVAL (XEXP (note, 0));
+      if (insn == bb->end)
+	return -1;
+    }
+}
+
+/* Return how many times the arc from the entry block to block S was
+   taken: the count of S less the counts of the arcs coming into it
+   from the other blocks.  Return -1 if S, or another block going to it,
+   has no count yet.  */
+
+static HOST_WIDE_INT
+entry_arc_count (s)
+     int s;
+{
+  HOST_WIDE_INT count;
+  int b;
+
+  if (s <= 0 || blocks[s].count < 0)
+    return -1;
+
+  count = blocks[s].count;
+  for (b = 1; b < n_blocks; b++)
+    {
+      struct reorder_block *bb = &blocks[b];
+
+      if (bb->fall != s && bb->target != s)
+	continue;
+      if (bb->count < 0)
+	return -1;
+      if (bb->fall == s)
+	count -= bb->fall_count;
+      if (bb->target == s)
+	count -= bb->target_count;
+    }
+  return count < 0 ? 0 : count;
+}
+
+/* Return the execution count of the entry block, which has lost its
+   REG_EXEC_COUNT note, from the arcs leaving it.  If only one of the
+   two arcs of a conditional jump is known, scale it by the REG_BR_PROB
+   note of the jump.  Return -1 if that cannot be done.  */
+
+static HOST_WIDE_INT
+entry_block_count ()
+{
+  struct reorder_block *entry = &blocks[0];
+  HOST_WIDE_INT fall, target;
+  rtx note;
+  int prob;
+
+  if (entry->fall < 0 && entry->target < 0)
+    return -1;
+  if (entry->target < 0 || entry->target == entry->fall)
+    return entry_arc_count (entry->fall);
+  if (entry->fall < 0)
+    return entry_arc_count (entry->target);
+
+  fall = entry_arc_count (entry->fall);
+  target = entry_arc_count (entry->target);
+  if (fall >= 0 && target >= 0)
+    return fall + target;
+
+  note = find_reg_note (entry->end, REG_BR_PROB, NULL_RTX);
+  if (note == 0)
+    return -1;
+  prob = INTVAL (XEXP (note, 0));
+  if (fall >= 0 && prob < REG_BR_PROB_BASE)
+    return ((double) fall * REG_BR_PROB_BASE
+	    / (REG_BR_PROB_BASE - prob) + 0.5);
+  if (target >= 0 && prob > 0)
+    return (double) target * REG_BR_PROB_BASE / prob + 0.5;
+  return -1;
+}
+
+/* Find the execution count of each block and of each arc between blocks.
+   Blocks whose first insns were deleted since profile.c put the notes
+   there get the sum of the counts of the arcs coming in, except for the
+   entry block, which gets its count from the arcs going out.  Return zero
+   if the entry block was never executed or its count cannot be found,
+   and there is nothing to go by.  */
+
+static int
+compute_counts ()
+{
+  HOST_WIDE_INT *in = (HOST_WIDE_INT *) alloca (n_blocks
+						* sizeof (HOST_WIDE_INT));
+  char *in_unknown = (char *) alloca (n_blocks);
+  int b, changed;
+
+  for (b = 0; b < n_blocks; b++)
+    blocks[b].count = block_exec_count (&blocks[b]);
+
+  do
+    {
+      changed = 0;
+      bzero ((char *) in, n_blocks * sizeof (HOST_WIDE_INT));
+      bzero (in_unknown, n_blocks);
+
+      for (b = 0; b < n_blocks; b++)
+	{
+	  struct reorder_block *bb = &blocks[b];
+	  rtx note;
+
+	  bb->fall_count = bb->target_count = 0;
+	  if (bb->count < 0)
+	    {
+	      if (bb->fall >= 0)
+		in_unknown[bb->fall] = 1;
+	      if (bb->target >= 0)
+		in_unknown[bb->target] = 1;
+	      continue;
+	    }
+
+	  if (bb->fall >= 0 && bb->target >= 0)
+	    {
+	      note = find_reg_note (bb->end, REG_BR_PROB, NULL_RTX);
+	      if (note == 0)
+		bb->target_count = bb->count / 2;
+	      else if (INTVAL (XEXP (note, 0)) > 0)
+		bb->target_count
+		  = ((double) bb->count * INTVAL (XEXP (note, 0))
+		     + REG_BR_PROB_BASE / 2) / REG_BR_PROB_BASE;
+	      if (bb->target_count > bb->count)
+		bb->target_count = bb->count;
+	      bb->fall_count = bb->count - bb->target_count;
+	    }
+	  else if (bb->fall >= 0)
+	    bb->fall_count = bb->count;
+	  else if (bb->target >= 0)
+	    bb->target_count = bb->count;
+
+	  if (bb->fall >= 0)
+	    in[bb->fall] += bb->fall_count;
+	  if (bb->target >= 0)
+	    in[bb->target] += bb->target_count;
+	}
+
+      for (b = 1; b < n_blocks; b++)
+	if (blocks[b].count < 0 && ! in_unknown[b])
+	  {
+	    blocks[b].count = in[b];
+	    changed = 1;
+	  }
+
+      /* Once nothing more comes from the arcs coming in, the arcs of the
+	 other blocks are final, and may give the count of the entry.  */
+      if (! changed && blocks[0].count < 0
+	  && (blocks[0].count = entry_block_count ()) >= 0)
+	changed = 1;
+    }
+  while (changed);
+
+  return blocks[0].count > 0;
+}
+
+/* Compare two arcs for qsort: the arc taken more often comes first, then
+   the arc that is a fallthrough already, then the arc met first.  */
+
+static int
+compare_arcs (x, y)
+     const GENERIC_PTR x;
+     const GENERIC_PTR y;
+{
+  const struct reorder_arc *a = (const struct reorder_arc *) x;
+  const struct reorder_arc *b = (const struct reorder_arc *) y;
+
+  if (a->count != b->count)
+    return a->count > b->count ? -1 : 1;
+  if (a->fall != b->fall)
+    return b->fall - a->fall;
+  if (a->src != b->src)
+    return a->src - b->src;
+  return a->dest - b->dest;
+}
+
+/* Put the chain starting with block DEST after the chain ending with
+   block SRC.  */
+
+static void
+join_chains (src, dest)
+     int src, dest;
+{
+  struct reorder_chain *c1 = &chains[blocks[src].chain];
+  struct reorder_chain *c2 = &chains[blocks[dest].chain];
+  int keep, b;
+
+  blocks[src].next = dest;
+
+  /* Renumber the blocks of the smaller chain.  */
+  if (c1->size >= c2->size)
+    {
+      keep = blocks[src].chain;
+      for (b = dest; b >= 0; b = blocks[b].next)
+	blocks[b].chain = keep;
+      c1->tail = c2->tail;
+    }
+  else
+    {
+      keep = blocks[dest].chain;
+      for (b = c1->head; b != dest; b = blocks[b].next)
+	blocks[b].chain = keep;
+      c2->head = c1->head;
+    }
+
+  chains[keep].size = c1->size + c2->size;
+  chains[keep].has_entry = c1->has_entry | c2->has_entry;
+  chains[keep].falls_out = c1->falls_out | c2->falls_out;
+}
+
+/* Chain the blocks together and store the new order of the blocks in
+   ORDER.  Return nonzero if it differs from the old one.  */
+
+static int
+layout_blocks (order)
+     int *order;
+{
+  struct reorder_arc *arcs
+    = (struct reorder_arc *) alloca (2 * n_blocks * sizeof *arcs);
+  char *placed = (char *) alloca (n_blocks);
+  int n_arcs = 0;
+  int b, i, n, pass;
+
+  for (b = 0; b < n_blocks; b++)
+    {
+      struct reorder_block *bb = &blocks[b];
+      struct reorder_chain *c = &chains[b];
+
+      c->head = c->tail = b;
+      c->size = 1;
+      c->has_entry = b == 0;
+      c->falls_out = bb->falls_out;
+      c->cold = bb->count == 0;
+
+      /* Only an arc between two blocks that were both executed, or both
+	 not, can become a fallthrough; nothing can fall into the entry
+	 block.  */
+      if (bb->fall > 0
+	  && (blocks[bb->fall].count == 0) == c->cold)
+	{
+	  arcs[n_arcs].src = b;
+	  arcs[n_arcs].dest = bb->fall;
+	  arcs[n_arcs].count = bb->fall_count;
+	  arcs[n_arcs++].fall = 1;
+	}
+      if (bb->target > 0 && bb->target != b && bb->target != bb->fall
+	  && (blocks[bb->target].count == 0) == c->cold)
+	{
+	  arcs[n_arcs].src = b;
+	  arcs[n_arcs].dest = bb->target;
+	  arcs[n_arcs].count = bb->target_count;
+	  arcs[n_arcs++].fall = 0;
+	}
+    }
+
+  qsort (arcs, n_arcs, sizeof *arcs, compare_arcs);
+
+  for (i = 0; i < n_arcs; i++)
+    {
+      int src = arcs[i].src, dest = arcs[i].dest;
+      struct reorder_chain *c1 = &chains[blocks[src].chain];
+      struct reorder_chain *c2 = &chains[blocks[dest].chain];
+
+      /* The chain that falls off the end of the function has to come
+	 last, and the one with the entry block first.  */
+      if (c1 != c2 && c1->tail == src && c2->head == dest
+	  && ! c1->falls_out && ! (c1->has_entry && c2->falls_out))
+	join_chains (src, dest);
+    }
+
+  /* The chain of the entry block first, then the other chains of blocks
+     that were executed, then the others, and the chain falling off the
+     end of the function last.  */
+  bzero (placed, n_blocks);
+  n = 0;
+  for (pass = 0; pass < 4; pass++)
+    for (b = 0; b < n_blocks; b++)
+      {
+	struct reorder_chain *c = &chains[blocks[b].chain];
+
+	if (placed[b] || c->head != b)
+	  continue;
+	if (pass == 0 ? ! c->has_entry
+	    : pass == 3 ? 0
+	    : c->falls_out || c->cold != (pass == 2))
+	  continue;
+
+	for (i = b; i >= 0; i = blocks[i].next)
+	  {
+	    placed[i] = 1;
+	    order[n++] = i;
+	  }
+      }
+
+  if (n != n_blocks)
+    abort ();
+
+  for (b = 0; b < n_blocks; b++)
+    if (order[b] != b)
+      return 1;
+  return 0;
+}
+
+/* Link the insns of the blocks in the order given by ORDER.  */
+
+static void
+relink_blocks (order)
+     int *order;
+{
+  rtx last = 0;
+  int i;
+
+  for (i = 0; i < n_blocks; i++)
+    {
+      struct reorder_block *bb = &blocks[order[i]];
+
+      PREV_INSN (bb->first) = last;
+      if (last)
+	NEXT_INSN (last) = bb->first;
+      last = bb->last;
+    }
+
+  NEXT_INSN (last) = 0;
+  set_last_insn (last);
+}
+
+/* Return a label for the block BB, making one if needed.  */
+
+static rtx
+block_label (bb)
+     struct reorder_block *bb;
+{
+  if (GET_CODE (bb->head) != CODE_LABEL)
+    {
+      rtx label = gen_label_rtx ();
+      int i;
+
+      emit_label_after (label, PREV_INSN (bb->head));
+
+      /* Start the block of flow.c at the label, so that reorg.c still
+	 knows what registers are live there.  */
+      for (i = 0; i < n_basic_blocks; i++)
+	if (basic_block_head[i] == bb->head)
+	  basic_block_head[i] = label;
+      bb->head = label;
+    }
+  return bb->head;
+}
+
+/* Emit a jump to LABEL after INSN.  */
+
+static void
+emit_jump_to (label, insn)
+     rtx label, insn;
+{
+  rtx jump = emit_jump_insn_after (gen_jump (label), insn);
+
+  JUMP_LABEL (jump) = label;
+  LABEL_NUSES (label)++;
+  emit_barrier_after (jump);
+}
+
+/* Now that the blocks are in the order ORDER, make every block reach its
+   successors again.  */
+
+static void
+fixup_jumps (order)
+     int *order;
+{
+  int i, b;
+
+  /* Keep redirect_jump from deleting the labels of the blocks.  */
+  for (b = 0; b < n_blocks; b++)
+    if (GET_CODE (blocks[b].head) == CODE_LABEL)
+      LABEL_NUSES (blocks[b].head)++;
+
+  for (i = 0; i < n_blocks; i++)
+    {
+      struct reorder_block *bb = &blocks[order[i]];
+      int next = i + 1 < n_blocks ? order[i + 1] : -1;
+
+      if (bb->falls_out && next >= 0)
+	abort ();
+
+      if (bb->fall < 0 || bb->fall == next)
+	continue;
+
+      /* If the conditional jump at the end goes to the next block, make
+	 it go to the old fallthrough block instead.  */
+      if (bb->target >= 0 && bb->target == next
+	  && invert_jump (bb->end, block_label (&blocks[bb->fall])))
+	continue;
+
+      emit_jump_to (block_label (&blocks[bb->fall]), bb->end);
+    }
+
+  for (b = 0; b < n_blocks; b++)
+    if (GET_CODE (blocks[b].head) == CODE_LABEL)
+      LABEL_NUSES (blocks[b].head)--;
+}
+
+/* Write the new layout given by ORDER to FILE.  */
+
+static void
+dump_layout (file, order)
+     FILE *file;
+     int *order;
+{
+  int i;
+
+  fprintf (file, "\n%d basic blocks, new order:\n", n_blocks);
+  for (i = 0; i < n_blocks; i++)
+    {
+      struct reorder_block *bb = &blocks[order[i]];
+
+      fprintf (file, ";; block %d, insn %d, count ", order[i],
+	       INSN_UID (bb->head));
+      fprintf (file, HOST_WIDE_INT_PRINT_DEC, bb->count);
+      if (bb->fall >= 0)
+	fprintf (file, ", falls into %d", bb->fall);
+      if (bb->target >= 0)
+	fprintf (file, ", jumps to %d", bb->target);
+      if (bb->count == 0)
+	fprintf (file, ", cold");
+      fprintf (file, "\n");
+    }
+  fprintf (file, "\n");
+}
+
+/* Reorder the basic blocks of the function whose first insn is F, using
+   the execution counts from profile.c.  FILE is the dump file, if any.  */
+
+void
+reorder_basic_blocks (f, file)
+     rtx f;
+     FILE *file;
+{
+  int have_counts;
+  int *uid_block, *order;
+
+  if (nonlocal_label_rtx_list () != 0)
+    return;
+
+  n_blocks = scan_blocks (f, &have_counts);
+  if (n_blocks <= 1 || ! have_counts)
+    return;
+
+  blocks = (struct reorder_block *) xmalloc (n_blocks * sizeof *blocks);
+  chains = (struct reorder_chain *) xmalloc (n_blocks * sizeof *chains);
+  order = (int *) xmalloc (n_blocks * sizeof (int));
+  uid_block = (int *) xmalloc (get_max_uid () * sizeof (int));
+
+  find_blocks (f, uid_block);
+
+  if (! compute_counts ())
+    {
+      if (file)
+	fprintf (file, blocks[0].count < 0
+		 ? "\nNo count for the entry block, not reordered.\n\n"
+		 : "\nEntry block never executed, not reordered.\n\n");
+    }
+  else if (layout_blocks (order))
+    {
+      relink_blocks (order);
+      fixup_jumps (order);
+      if (file)
+	dump_layout (file, order);
+    }
+
+  free (uid_block);
+  free (order);
+  free (chains);
+  free (blocks);
+}
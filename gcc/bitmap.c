@@ -47,6 +47,10 @@ static void bitmap_element_free		PROTO((bitmap, bitmap_element *));
 static bitmap_element *bitmap_element_allocate PROTO((void));
 static int bitmap_element_zerop		PROTO((bitmap_element *));
 static void bitmap_element_link		PROTO((bitmap, bitmap_element *));
+static void bitmap_element_insert	PROTO((bitmap, bitmap_element *,
+					       bitmap_element *));
+static void bitmap_operation_in_place	PROTO((bitmap, bitmap,
+					       enum bitmap_bits));
 static bitmap_element *bitmap_find_bit	PROTO((bitmap, unsigned int));
 
 /* Free a bitmap element */
@@ -213,19 +217,47 @@ bitmap_element_link (head, element)
   head->indx = indx;
 }
 
-/* Clear a bitmap by freeing the linked list.  */
+/* Link ELEMENT into bitmap HEAD just after PREV, or at the front of the
+   list if PREV is zero.  The caller must know that this keeps the list
+   sorted.  */
+
+static INLINE void
+bitmap_element_insert (head, prev, element)
+     bitmap head;
+     bitmap_element *prev;
+     bitmap_element *element;
+{
+  bitmap_element *next = prev ? prev->next : head->first;
+
+  element->prev = prev;
+  element->next = next;
+  if (prev)
+    prev->next = element;
+  else
+    head->first = element;
+  if (next)
+    next->prev = element;
+}
+
+/* Clear a bitmap by freeing the linked list.  The list is put on the
+   free list as a whole, in its original order, so that the next bitmap
+   built in increasing order gets back the same elements in the same
+   order; bitmaps that are repeatedly cleared and refilled, as regsets
+   are, then keep their elements close together.  */
 
 INLINE void
 bitmap_clear (head)
      bitmap head;
 {
-  bitmap_element *element, *next;
+  bitmap_element *last;
 
-  for (element = head->first; element != 0; element = next)
+  if (head->first != 0)
     {
-      next = element->next;
-      element->next = bitmap_free;
-      bitmap_free = element;
+      for (last = head->first; last->next != 0; last = last->next)
+	;
+
+      last->next = bitmap_free;
+      bitmap_free = head->first;
     }
 
   head->first = head->current =  0;
@@ -239,16 +271,31 @@ bitmap_copy (to, from)
      bitmap from;
 {
   bitmap_element *from_ptr, *to_ptr = 0;
+  bitmap_element *reuse;
 #if BITMAP_ELEMENT_WORDS != 2
   int i;
 #endif
 
-  bitmap_clear (to);
+  if (to == from)
+    return;
+
+  /* Overwrite the elements TO already has before taking any from the
+     free list, so that copying into a bitmap does not move it.  */
+  reuse = to->first;
+  to->first = to->current = 0;
 
   /* Copy elements in forward direction one at a time */
   for (from_ptr = from->first; from_ptr; from_ptr = from_ptr->next)
     {
-      bitmap_element *to_elt = bitmap_element_allocate ();
+      bitmap_element *to_elt;
+
+      if (reuse != 0)
+	{
+	  to_elt = reuse;
+	  reuse = reuse->next;
+	}
+      else
+	to_elt = bitmap_element_allocate ();
 
       to_elt->indx = from_ptr->indx;
 
@@ -277,6 +324,15 @@ bitmap_copy (to, from)
 
       to_ptr = to_elt;
     }
+
+  /* Free whatever TO had left over.  */
+  if (reuse != 0)
+    {
+      bitmap_head rest;
+
+      rest.first = reuse;
+      bitmap_clear (&rest);
+    }
 }
 
 /* Find a bitmap element that would hold a bitmap's bit.
@@ -387,6 +443,144 @@ bitmap_bit_p (head, bit)
     (ptr->bits[word_num] & (((unsigned HOST_WIDE_INT) 1) << bit_num)) != 0;
 }
 
+/* Combine bitmap FROM into bitmap TO using a specific bit manipulation,
+   reusing the elements TO already has instead of building a new list.
+   TO and FROM must be different bitmaps.  */
+
+static void
+bitmap_operation_in_place (to, from, operation)
+     bitmap to;
+     bitmap from;
+     enum bitmap_bits operation;
+{
+  bitmap_element *to_ptr = to->first;
+  bitmap_element *from_ptr = from->first;
+  bitmap_element *prev = 0;
+  bitmap_element *next;
+#if BITMAP_ELEMENT_WORDS != 2
+  int i;
+#endif
+
+  switch (operation)
+    {
+    default:
+      abort ();
+
+    case BITMAP_IOR:
+      /* Merge FROM into TO, copying the elements TO does not have.  */
+      while (from_ptr != 0)
+	{
+	  if (to_ptr != 0 && to_ptr->indx < from_ptr->indx)
+	    {
+	      prev = to_ptr;
+	      to_ptr = to_ptr->next;
+	      continue;
+	    }
+
+	  if (to_ptr != 0 && to_ptr->indx == from_ptr->indx)
+	    {
+#if BITMAP_ELEMENT_WORDS == 2
+	      to_ptr->bits[0] |= from_ptr->bits[0];
+	      to_ptr->bits[1] |= from_ptr->bits[1];
+#else
+	      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+		to_ptr->bits[i] |= from_ptr->bits[i];
+#endif
+	      prev = to_ptr;
+	      to_ptr = to_ptr->next;
+	    }
+	  else
+	    {
+	      next = bitmap_element_allocate ();
+	      next->indx = from_ptr->indx;
+#if BITMAP_ELEMENT_WORDS == 2
+	      next->bits[0] = from_ptr->bits[0];
+	      next->bits[1] = from_ptr->bits[1];
+#else
+	      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+		next->bits[i] = from_ptr->bits[i];
+#endif
+	      bitmap_element_insert (to, prev, next);
+	      prev = next;
+	    }
+
+	  from_ptr = from_ptr->next;
+	}
+      break;
+
+    case BITMAP_AND:
+    case BITMAP_AND_COMPL:
+      /* Only TO's own elements can survive; free the ones that become
+	 zero.  */
+      for (; to_ptr != 0; to_ptr = next)
+	{
+	  next = to_ptr->next;
+
+	  while (from_ptr != 0 && from_ptr->indx < to_ptr->indx)
+	    from_ptr = from_ptr->next;
+
+	  if (from_ptr == 0 || from_ptr->indx != to_ptr->indx)
+	    {
+	      /* FROM has no bits here; AND_COMPL leaves the element
+		 alone.  */
+	      if (operation == BITMAP_AND_COMPL)
+		{
+		  prev = to_ptr;
+		  continue;
+		}
+#if BITMAP_ELEMENT_WORDS == 2
+	      to_ptr->bits[0] = to_ptr->bits[1] = 0;
+#else
+	      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+		to_ptr->bits[i] = 0;
+#endif
+	    }
+	  else if (operation == BITMAP_AND)
+	    {
+#if BITMAP_ELEMENT_WORDS == 2
+	      to_ptr->bits[0] &= from_ptr->bits[0];
+	      to_ptr->bits[1] &= from_ptr->bits[1];
+#else
+	      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+		to_ptr->bits[i] &= from_ptr->bits[i];
+#endif
+	    }
+	  else
+	    {
+#if BITMAP_ELEMENT_WORDS == 2
+	      to_ptr->bits[0] &= ~ from_ptr->bits[0];
+	      to_ptr->bits[1] &= ~ from_ptr->bits[1];
+#else
+	      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+		to_ptr->bits[i] &= ~ from_ptr->bits[i];
+#endif
+	    }
+
+	  if (! bitmap_element_zerop (to_ptr))
+	    {
+	      prev = to_ptr;
+	      continue;
+	    }
+
+	  /* Unlink the element and put it on the free list.  */
+	  if (prev)
+	    prev->next = next;
+	  else
+	    to->first = next;
+	  if (next)
+	    next->prev = prev;
+
+	  to_ptr->next = bitmap_free;
+	  bitmap_free = to_ptr;
+	}
+      break;
+    }
+
+  to->current = to->first;
+  if (to->current)
+    to->indx = to->current->indx;
+}
+
 /* Store in bitmap TO the result of combining bitmap FROM1 and
    FROM2 using a specific bit manipulation.  */
 
@@ -412,8 +606,21 @@ bitmap_operation (to, from1, from2, operation)
   int i;
 #endif
 
-  /* To simplify things, always create a new list.  If the old list was one
-     of the inputs, free it later.  Otherwise, free it now.  */
+  /* The common forms `A = A op B' and `A = B op A' (for a commutative
+     op) can be done without building a new list.  */
+  if (to == from1 && to != from2)
+    {
+      bitmap_operation_in_place (to, from2, operation);
+      return;
+    }
+  if (to == from2 && to != from1 && operation != BITMAP_AND_COMPL)
+    {
+      bitmap_operation_in_place (to, from1, operation);
+      return;
+    }
+
+  /* Otherwise, to simplify things, always create a new list.  If the old
+     list was one of the inputs, free it later.  Otherwise, free it now.  */
   if (to == from1 || to == from2)
     {
       delete_list = to->first;
@@ -530,13 +737,72 @@ bitmap_ior_and_compl (to, from1, from2)
      bitmap from1;
      bitmap from2;
 {
-  bitmap_head tmp;
+  bitmap_element *from1_ptr;
+  bitmap_element *from2_ptr = from2->first;
+  bitmap_element *from2_tmp;
+  bitmap_element *to_ptr = to->first;
+  bitmap_element *prev = 0;
+  bitmap_element *elt;
+  unsigned HOST_WIDE_INT bits[BITMAP_ELEMENT_WORDS];
+  int i;
 
-  tmp.first = tmp.current = 0;
+  /* TO | (TO & ~FROM2) is just TO, and TO | (FROM1 & ~TO) is TO | FROM1.  */
+  if (to == from1)
+    return;
+  if (to == from2)
+    {
+      bitmap_operation_in_place (to, from1, BITMAP_IOR);
+      return;
+    }
+
+  /* Otherwise walk all three lists together, merging the new bits into TO
+     without making a temporary bitmap.  */
+  for (from1_ptr = from1->first; from1_ptr != 0; from1_ptr = from1_ptr->next)
+    {
+      while (from2_ptr != 0 && from2_ptr->indx < from1_ptr->indx)
+	from2_ptr = from2_ptr->next;
+
+      from2_tmp = (from2_ptr != 0 && from2_ptr->indx == from1_ptr->indx
+		   ? from2_ptr : &bitmap_zero);
+
+#if BITMAP_ELEMENT_WORDS == 2
+      bits[0] = from1_ptr->bits[0] & ~ from2_tmp->bits[0];
+      bits[1] = from1_ptr->bits[1] & ~ from2_tmp->bits[1];
+      if ((bits[0] | bits[1]) == 0)
+	continue;
+#else
+      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+	bits[i] = from1_ptr->bits[i] & ~ from2_tmp->bits[i];
+      for (i = BITMAP_ELEMENT_WORDS - 1; i >= 0; i--)
+	if (bits[i] != 0)
+	  break;
+      if (i < 0)
+	continue;
+#endif
+
+      while (to_ptr != 0 && to_ptr->indx < from1_ptr->indx)
+	{
+	  prev = to_ptr;
+	  to_ptr = to_ptr->next;
+	}
+
+      if (to_ptr != 0 && to_ptr->indx == from1_ptr->indx)
+	elt = to_ptr;
+      else
+	{
+	  elt = bitmap_element_allocate ();
+	  elt->indx = from1_ptr->indx;
+	  bitmap_element_insert (to, prev, elt);
+	  prev = elt;
+	}
+
+      for (i = 0; i < BITMAP_ELEMENT_WORDS; i++)
+	elt->bits[i] |= bits[i];
+    }
 
-  bitmap_operation (&tmp, from1, from2, BITMAP_AND_COMPL);
-  bitmap_operation (to, to, &tmp, BITMAP_IOR);
-  bitmap_clear (&tmp);
+  to->current = to->first;
+  if (to->current)
+    to->indx = to->current->indx;
 }
 
 /* Initialize a bitmap header.  */
@@ -18,10 +18,12 @@ along with GNU CC; see the file COPYING.  If not, write to
 the Free Software Foundation, 59 Temple Place - Suite 330,
 Boston, MA 02111-1307, USA.  */
 
-/* Number of words to use for each element in the linked list.  */
+/* Number of words to use for each element in the linked list.  Regsets
+   are fairly dense, so a wider element means fewer links to follow and
+   longer runs of straight word operations.  */
 
 #ifndef BITMAP_ELEMENT_WORDS
-#define BITMAP_ELEMENT_WORDS 2
+#define BITMAP_ELEMENT_WORDS 4
 #endif
 
 /* Number of bits in each actual element of a bitmap.  We get slightly better
@@ -40,6 +40,19 @@ Boston, MA 02111-1307, USA. */
 # include <sys/resource.h>
 #endif
 
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+# ifndef MAP_FAILED
+#  define MAP_FAILED ((void *) -1)
+# endif
+#endif
+
+/* Files at least this big are mapped into memory rather than read,
+   if possible; see map_file.  */
+#ifndef MMAP_THRESHOLD
+#define MMAP_THRESHOLD (64 * 1024)
+#endif
+
 typedef unsigned char U_CHAR;
 
 #include "gansidecl.h"
@@ -510,6 +523,103 @@ struct include_file {
 static struct include_file *include_hashtab[INCLUDE_HASHSIZE];
 static struct include_file *include_ino_hashtab[INCLUDE_HASHSIZE];
 
+/* Persistent cache of include files, kept from one run to the next in
+   the file named by -iheadercache.
+
+   For each header, the cache records its inode, modification time and size,
+   a hash of its contents, the macro whose definition makes including
+   it again a no-op (see record_control_macro), and its text with the
+   comments replaced by whitespace.
+
+   A later run that includes the header when its guard macro is
+   already defined skips it after a stat, without opening and reading
+   it, even the first time.  A run that does process the header takes
+   its text from the cache, so that rescan does not have to skip the
+   comments again.  If only the modification time changed, the hash
+   of the contents tells whether the entry is still good.  A header
+   modified too recently to be told apart from a rewrite in the same
+   second is always read and hashed (see HC_MTIME).
+
+   None of this depends on the macros defined when the header is
+   included, so one cache can serve compilations with different -D
+   options.  The stripped text does depend on the handling of `//'
+   comments and of trigraphs; that is part of its key.  */
+
+struct header_cache_entry {
+  struct header_cache_entry *next;	/* For header_cache_hashtab.  */
+  char *fname;
+  long dev;
+  long ino;
+  long mtime;
+  long size;
+  unsigned long hash;		/* Hash of the contents of the file.  */
+  U_CHAR *control_macro;	/* Guard macro, or 0 if none is known.  */
+  U_CHAR *text;			/* Stripped contents, or 0 if not cached.  */
+  long length;			/* Length of TEXT.  */
+  int flags;			/* HC_* flags, below.  */
+  struct include_file *inc;	/* Include file processed in this run.  */
+};
+
+/* Flags of a header cache entry.  */
+
+#define HC_CPLUSPLUS_COMMENTS 1	/* `//' comments were stripped.  */
+#define HC_TRIGRAPHS 2		/* Trigraphs were replaced.  */
+#define HC_MISSING_NEWLINE 4	/* The file did not end in a newline.  */
+#define HC_NO_TEXT 8		/* The comments could not be removed.  */
+
+#define HC_KEY_FLAGS (HC_CPLUSPLUS_COMMENTS | HC_TRIGRAPHS)
+
+/* A header cache file starts with HEADER_CACHE_MAGIC, padded to a
+   multiple of sizeof (long), and then the size of a record.  Each
+   entry is a record followed by the file name, the guard macro and
+   the text, each with a null after it and padded likewise.  */
+
+#define HEADER_CACHE_MAGIC "cccp header cache 1\n"
+
+struct header_cache_record {
+  long fname_length;
+  long macro_length;		/* -1 if there is no guard macro.  */
+  long text_length;		/* -1 if the text is not cached.  */
+  long dev;
+  long ino;
+  long mtime;
+  long size;
+  unsigned long hash;
+  long flags;
+};
+
+#define HC_ALIGN(N) \
+  (((N) + sizeof (long) - 1) & ~(sizeof (long) - 1))
+
+/* Nonzero if header cache entry HC describes the file whose status
+   is *ST, as far as can be told without reading it.  */
+
+#define HC_FRESH(HC, ST) \
+  ((HC)->dev == (long) (ST)->st_dev && (HC)->ino == (long) (ST)->st_ino \
+   && (HC)->mtime == (long) (ST)->st_mtime \
+   && (HC)->size == (long) (ST)->st_size)
+
+/* The modification time to record for a file whose status is *ST.
+   A file modified in the second this run started or later could be
+   rewritten within that second after it was read, keeping its size
+   and time; its time is recorded as -1, which HC_FRESH never matches,
+   so that a later run reads it and checks its hash instead.  */
+
+#define HC_MTIME(ST) \
+  ((ST)->st_mtime < header_cache_time ? (long) (ST)->st_mtime : -1L)
+
+#define HEADER_CACHE_HASHSIZE 1021
+static struct header_cache_entry *header_cache_hashtab[HEADER_CACHE_HASHSIZE];
+
+/* Name of the header cache file, or 0 if there is none.  */
+static char *header_cache_name;
+
+/* Nonzero if the header cache changed in this run.  */
+static int header_cache_changed;
+
+/* The time this run started, for HC_MTIME.  */
+static time_t header_cache_time;
+
 /* Global list of strings read in from precompiled files.  This list
    is kept in the order the strings are read in, with new strings being
    added at the end through stringlist_tailp.  We use this list to output
@@ -902,6 +1012,8 @@ static int deps_column;
 static int ignore_srcdir;
 
 static int safe_read PROTO((int, char *, int));
+static U_CHAR *map_file PROTO((int, size_t));
+static void unmap_file PROTO((U_CHAR *, size_t));
 static void safe_write PROTO((int, char *, int));
 static void eprint_string PROTO((char *, size_t));
 
@@ -941,6 +1053,17 @@ static int lookup_ino_include PROTO((struct include_file *));
 static void finclude PROTO((int, struct include_file *, FILE_BUF *, int, struct file_name_list *));
 static void record_control_macro PROTO((struct include_file *, U_CHAR *));
 
+static void read_header_cache PROTO((char *));
+static void write_header_cache PROTO((void));
+static void write_header_cache_string PROTO((FILE *, U_CHAR *, long));
+static struct header_cache_entry *lookup_header_cache PROTO((char *));
+static struct header_cache_entry *lookup_guarded_header PROTO((char *, struct stat *));
+static struct header_cache_entry *enter_header_cache PROTO((struct include_file *, U_CHAR *, int, unsigned long, int));
+static int header_cache_flags PROTO((void));
+static int header_cache_strip_p PROTO((void));
+static unsigned long header_cache_hash PROTO((U_CHAR *, int));
+static U_CHAR *strip_comments PROTO((U_CHAR *, int, int *));
+
 static char *check_precompiled PROTO((int, struct stat *, char *, char **));
 static int check_preconditions PROTO((char *));
 static void pcfinclude PROTO((U_CHAR *, U_CHAR *, U_CHAR *, FILE_BUF *));
@@ -1087,6 +1210,74 @@ safe_read (desc, ptr, len)
   return len - left;
 }
 
+/* Map the regular file open on descriptor DESC, which is SIZE bytes
+   long, into memory, if it is big enough for that to be cheaper than
+   reading it.  Return its address, or 0 if it was not mapped; then
+   the caller should read it instead.
+
+   The mapping is private and writable, since the input is modified
+   in place by trigraph_pcp and newline_fix.  The caller may store a
+   newline and a null after the contents, so at least two bytes must
+   be addressable there.  The rest of the last page of the file reads
+   as zeros; if that leaves too little room, map an extra page of zeros
+   after the file.  Release the mapping with unmap_file (BUF, SIZE).  */
+
+static U_CHAR *
+map_file (desc, size)
+     int desc ATTRIBUTE_UNUSED;
+     size_t size ATTRIBUTE_UNUSED;
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  size_t pagesize;
+  char *buf;
+
+  if (size < MMAP_THRESHOLD || size + 2 < size)
+    return 0;
+
+#ifdef _SC_PAGESIZE
+  pagesize = sysconf (_SC_PAGESIZE);
+#else
+  pagesize = getpagesize ();
+#endif
+
+  if (size % pagesize != 0 && size % pagesize <= pagesize - 2)
+    buf = (char *) mmap (0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+			 desc, 0);
+  else
+    {
+#ifdef MAP_ANONYMOUS
+      buf = (char *) mmap (0, size + pagesize, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (buf != (char *) MAP_FAILED
+	  && mmap (buf, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+		   desc, 0) == (char *) MAP_FAILED)
+	{
+	  munmap (buf, size + pagesize);
+	  buf = (char *) MAP_FAILED;
+	}
+#else
+      buf = (char *) MAP_FAILED;
+#endif
+    }
+
+  if (buf != (char *) MAP_FAILED)
+    return (U_CHAR *) buf;
+#endif
+  return 0;
+}
+
+/* Release BUF, the contents of a file SIZE bytes long mapped by map_file.  */
+
+static void
+unmap_file (buf, size)
+     U_CHAR *buf ATTRIBUTE_UNUSED;
+     size_t size ATTRIBUTE_UNUSED;
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  munmap ((char *) buf, size + 2);
+#endif
+}
+
 /* Write LEN bytes at PTR to descriptor DESC,
    retrying if necessary, and treating any real error as fatal.
    If MAX_WRITE_LEN is defined, write at most that many bytes at a time.  */
@@ -1350,6 +1541,12 @@ main (argc, argv)
 	if (!strcmp (argv[i], "-ifoutput")) {
 	  output_conditionals = 1;
 	}
+	if (!strcmp (argv[i], "-iheadercache")) {
+	  if (i + 1 == argc)
+	    fatal ("Filename missing after `-iheadercache' option");
+	  else
+	    header_cache_name = argv[++i];
+	}
 	if (!strcmp (argv[i], "-isystem")) {
 	  struct file_name_list *dirtmp;
 
@@ -1731,6 +1928,11 @@ main (argc, argv)
     }
   }
 
+  if (header_cache_name) {
+    header_cache_time = time ((time_t *) 0);
+    read_header_cache (header_cache_name);
+  }
+
   /* Add dirs from CPATH after dirs from -I.  */
   /* There seems to be confusion about what CPATH should do,
      so for the moment it is not documented.  */
@@ -2209,9 +2411,14 @@ main (argc, argv)
     size_t s = (size_t) st.st_size;
     if (s != st.st_size || s + 2 < s)
       memory_full ();
-    fp->buf = (U_CHAR *) xmalloc (s + 2);
-    fp->length = safe_read (f, (char *) fp->buf, s);
-    if (fp->length < 0) goto perror;
+    fp->buf = map_file (f, s);
+    if (fp->buf)
+      fp->length = s;
+    else {
+      fp->buf = (U_CHAR *) xmalloc (s + 2);
+      fp->length = safe_read (f, (char *) fp->buf, s);
+      if (fp->length < 0) goto perror;
+    }
   }
   fp->bufp = fp->buf;
   fp->if_stack = if_stack;
@@ -2297,6 +2504,10 @@ main (argc, argv)
 
   if (errors)
     exit (FATAL_EXIT_CODE);
+
+  if (header_cache_name)
+    write_header_cache ();
+
   exit (SUCCESS_EXIT_CODE);
 
  perror:
@@ -5025,6 +5236,9 @@ open_include_file (filename, searchptr, importing, pinc)
 							strlen (fname),
 							INCLUDE_HASHSIZE)];
   struct include_file *inc, *head = *phead;
+  struct header_cache_entry *hc = 0;
+  struct stat st;
+
   for (inc = head; inc; inc = inc->next)
     if (!strcmp (fname, inc->fname))
       break;
@@ -5033,18 +5247,26 @@ open_include_file (filename, searchptr, importing, pinc)
       || ! inc->control_macro
       || (inc->control_macro[0] && ! lookup (inc->control_macro, -1, -1))) {
 
-    fd = open (fname, O_RDONLY, 0);
+    /* If the header cache knows that FNAME is guarded by a macro that
+       is defined, there is no need to read it.  */
+    if (!inc && !importing && header_cache_name)
+      hc = lookup_guarded_header (fname, &st);
 
-    if (fd < 0)
+    if (! hc)
       {
-#ifdef VMS
-	/* if #include <dir/file> fails, try again with hacked spec.  */
-	if (!hack_vms_include_specification (fname, 0))
-	  return fd;
 	fd = open (fname, O_RDONLY, 0);
+
 	if (fd < 0)
+	  {
+#ifdef VMS
+	    /* if #include <dir/file> fails, try again with hacked spec.  */
+	    if (!hack_vms_include_specification (fname, 0))
+	      return fd;
+	    fd = open (fname, O_RDONLY, 0);
+	    if (fd < 0)
 #endif
-	  return fd;
+	      return fd;
+	  }
       }
 
     if (!inc) {
@@ -5054,14 +5276,23 @@ open_include_file (filename, searchptr, importing, pinc)
       inc->fname = fname;
       inc->control_macro = 0;
       inc->deps_output = 0;
-      if (fstat (fd, &inc->st) != 0)
+      if (hc)
+	inc->st = st;
+      else if (fstat (fd, &inc->st) != 0)
 	pfatal_with_name (fname);
       *phead = inc;
 
       /* Look for another file with the same inode and device.  */
-      if (lookup_ino_include (inc)
-	  && inc->control_macro
-	  && (!inc->control_macro[0] || lookup (inc->control_macro, -1, -1))) {
+      if (hc)
+	{
+	  lookup_ino_include (inc);
+	  if (! inc->control_macro)
+	    inc->control_macro = hc->control_macro;
+	}
+      else if (lookup_ino_include (inc)
+	       && inc->control_macro
+	       && (!inc->control_macro[0]
+		   || lookup (inc->control_macro, -1, -1))) {
 	close (fd);
 	fd = -2;
       }
@@ -5176,6 +5407,10 @@ finclude (f, inc, op, system_header_p, dirptr)
   int i;
   FILE_BUF *fp;			/* For input stack frame */
   int missing_newline = 0;
+  struct header_cache_entry *hc = 0;
+  unsigned long hash = 0;
+  int cached = 0;
+  size_t mapped_size = 0;	/* Nonzero if fp->buf is mapped.  */
 
   CHECK_DEPTH (return;);
 
@@ -5194,13 +5429,36 @@ finclude (f, inc, op, system_header_p, dirptr)
     size_t s = (size_t) inc->st.st_size;
     if (s != inc->st.st_size || s + 2 < s)
       memory_full ();
-    fp->buf = (U_CHAR *) xmalloc (s + 2);
-    fp->bufp = fp->buf;
 
-    /* Read the file contents, knowing that s is an upper bound
-       on the number of bytes we can read.  */
-    fp->length = safe_read (f, (char *) fp->buf, s);
-    if (fp->length < 0) goto nope;
+    if (header_cache_name)
+      hc = lookup_header_cache (fname);
+    if (hc && hc->text && HC_FRESH (hc, &inc->st)
+	&& (hc->flags & HC_KEY_FLAGS) == header_cache_flags ()
+	&& header_cache_strip_p ()) {
+      /* Use the text from the header cache instead of reading the
+	 file.  It is a copy, since rescan can modify its input.  */
+      fp->buf = (U_CHAR *) xmalloc (hc->length + 2);
+      bcopy ((char *) hc->text, (char *) fp->buf, hc->length);
+      fp->length = hc->length;
+      missing_newline = (hc->flags & HC_MISSING_NEWLINE) != 0;
+      cached = 1;
+    } else {
+      fp->buf = map_file (f, s);
+      if (fp->buf) {
+	fp->length = s;
+	mapped_size = s;
+      } else {
+	fp->buf = (U_CHAR *) xmalloc (s + 2);
+
+	/* Read the file contents, knowing that s is an upper bound
+	   on the number of bytes we can read.  */
+	fp->length = safe_read (f, (char *) fp->buf, s);
+	if (fp->length < 0) goto nope;
+      }
+      if (header_cache_name)
+	hash = header_cache_hash (fp->buf, fp->length);
+    }
+    fp->bufp = fp->buf;
   }
   else if (S_ISDIR (inc->st.st_mode)) {
     error ("directory `%s' specified in #include", fname);
@@ -5230,9 +5488,10 @@ finclude (f, inc, op, system_header_p, dirptr)
     fp->length = st_size;
   }
 
-  if ((fp->length > 0 && fp->buf[fp->length - 1] != '\n')
-      /* Backslash-newline at end is not good enough.  */
-      || (fp->length > 1 && fp->buf[fp->length - 2] == '\\')) {
+  if (! cached
+      && ((fp->length > 0 && fp->buf[fp->length - 1] != '\n')
+	  /* Backslash-newline at end is not good enough.  */
+	  || (fp->length > 1 && fp->buf[fp->length - 2] == '\\'))) {
     fp->buf[fp->length++] = '\n';
     missing_newline = 1;
   }
@@ -5247,9 +5506,24 @@ finclude (f, inc, op, system_header_p, dirptr)
   indepth++;
   input_file_stack_tick++;
 
-  if (!no_trigraphs)
+  if (!no_trigraphs && !cached)
     trigraph_pcp (fp);
 
+  if (cached)
+    hc->inc = inc;
+  else if (header_cache_name && S_ISREG (inc->st.st_mode))
+    {
+      hc = enter_header_cache (inc, fp->buf, fp->length, hash,
+			       missing_newline);
+      if (hc->text && header_cache_strip_p ())
+	{
+	  /* Scan the stripped text, as a later run would.  */
+	  bcopy ((char *) hc->text, (char *) fp->buf, hc->length);
+	  fp->length = hc->length;
+	  fp->buf[fp->length] = '\0';
+	}
+    }
+
   output_line_directive (fp, op, 0, enter_file);
   rescan (op, 0);
 
@@ -5262,7 +5536,10 @@ finclude (f, inc, op, system_header_p, dirptr)
   indepth--;
   input_file_stack_tick++;
   output_line_directive (&instack[indepth], op, 0, leave_file);
-  free (fp->buf);
+  if (mapped_size)
+    unmap_file (fp->buf, mapped_size);
+  else
+    free (fp->buf);
   return;
 
  nope:
@@ -5285,6 +5562,442 @@ record_control_macro (inc, macro_name)
   if (!inc->control_macro || inc->control_macro[0])
     inc->control_macro = macro_name;
 }
+
+/* Return the flags of the settings that affect the text of an include
+   file as stored in the header cache, and the guard macro found in it.  */
+
+static int
+header_cache_flags ()
+{
+  return ((cplusplus_comments ? HC_CPLUSPLUS_COMMENTS : 0)
+	  | (no_trigraphs ? 0 : HC_TRIGRAPHS));
+}
+
+/* Return nonzero if include files can be read with their comments
+   already removed.  That is not so if the comments are to be output,
+   or if anything other than whitespace would be made of them.  */
+
+static int
+header_cache_strip_p ()
+{
+  return (! traditional && ! put_out_comments && ! for_lint
+	  && ! warn_comments && ! lang_asm && dump_macros == dump_none
+	  && (no_trigraphs || ! warn_trigraphs));
+}
+
+/* Return a hash of the LENGTH bytes at BUF.  */
+
+static unsigned long
+header_cache_hash (buf, length)
+     U_CHAR *buf;
+     int length;
+{
+  register unsigned long hash = 2166136261UL;
+  register U_CHAR *p = buf, *limit = buf + length;
+
+  while (p < limit)
+    hash = ((hash ^ *p++) * 16777619UL) & 0xffffffffUL;
+  return hash;
+}
+
+/* Return the header cache entry for the include file FNAME,
+   or 0 if there is none.  */
+
+static struct header_cache_entry *
+lookup_header_cache (fname)
+     char *fname;
+{
+  struct header_cache_entry *hc;
+
+  hc = header_cache_hashtab[hashf ((U_CHAR *) fname, strlen (fname),
+				   HEADER_CACHE_HASHSIZE)];
+  for (; hc; hc = hc->next)
+    if (!strcmp (fname, hc->fname))
+      return hc;
+  return 0;
+}
+
+/* If the header cache says that including FNAME is a no-op because
+   its guard macro is defined, and FNAME has not changed since, return
+   its entry and store the status of FNAME into *ST.  Otherwise return 0.  */
+
+static struct header_cache_entry *
+lookup_guarded_header (fname, st)
+     char *fname;
+     struct stat *st;
+{
+  struct header_cache_entry *hc = lookup_header_cache (fname);
+
+  if (hc && hc->control_macro
+      && (hc->flags & HC_KEY_FLAGS) == header_cache_flags ()
+      && lookup (hc->control_macro, -1, -1)
+      && stat (fname, st) == 0
+      && HC_FRESH (hc, st))
+    return hc;
+  return 0;
+}
+
+/* Enter the include file INC into the header cache, now that its
+   LENGTH bytes of contents have been read into BUF and had trigraphs
+   replaced.  HASH is the hash of the contents as read.  MISSING_NEWLINE
+   is nonzero if a newline had to be added at the end.
+   Return the entry; its text is that of BUF without the comments,
+   if that could be made.  */
+
+static struct header_cache_entry *
+enter_header_cache (inc, buf, length, hash, missing_newline)
+     struct include_file *inc;
+     U_CHAR *buf;
+     int length;
+     unsigned long hash;
+     int missing_newline;
+{
+  struct header_cache_entry *hc = lookup_header_cache (inc->fname);
+  int flags = header_cache_flags () | (missing_newline ? HC_MISSING_NEWLINE
+				       : 0);
+  int strip = header_cache_strip_p ();
+  int new_length;
+
+  if (! hc)
+    {
+      char *fname = inc->fname;
+      struct header_cache_entry **bucket
+	= &header_cache_hashtab[hashf ((U_CHAR *) fname, strlen (fname),
+				       HEADER_CACHE_HASHSIZE)];
+
+      hc = (struct header_cache_entry *)
+	xcalloc (1, sizeof (struct header_cache_entry));
+      hc->fname = xmalloc (strlen (fname) + 1);
+      strcpy (hc->fname, fname);
+      hc->next = *bucket;
+      *bucket = hc;
+    }
+  else if (hc->hash == hash && hc->size == (long) inc->st.st_size
+	   && (hc->flags & ~HC_NO_TEXT) == flags
+	   && (hc->text || (hc->flags & HC_NO_TEXT) || ! strip))
+    {
+      /* The contents are unchanged; only the file status may differ.  */
+      if (hc->dev != (long) inc->st.st_dev
+	  || hc->ino != (long) inc->st.st_ino
+	  || hc->mtime != HC_MTIME (&inc->st))
+	header_cache_changed = 1;
+      hc->dev = (long) inc->st.st_dev;
+      hc->ino = (long) inc->st.st_ino;
+      hc->mtime = HC_MTIME (&inc->st);
+      hc->inc = inc;
+      return hc;
+    }
+
+  hc->dev = (long) inc->st.st_dev;
+  hc->ino = (long) inc->st.st_ino;
+  hc->mtime = HC_MTIME (&inc->st);
+  hc->size = (long) inc->st.st_size;
+  hc->hash = hash;
+  hc->control_macro = 0;
+  hc->text = strip ? strip_comments (buf, length, &new_length) : 0;
+  hc->length = hc->text ? new_length : 0;
+  hc->flags = flags | (strip && ! hc->text ? HC_NO_TEXT : 0);
+  hc->inc = inc;
+  header_cache_changed = 1;
+  return hc;
+}
+
+/* Return a copy of the LENGTH bytes at BUF with each comment replaced
+   by a space and the newlines within it, as rescan would, and store
+   the new length into *PLENGTH.  Comments within directives are left
+   alone, since handle_directive treats them specially.
+
+   Return 0 if the file has anything that might be read differently
+   once its comments are gone: unterminated comments or literals,
+   backslash-newlines next to comment delimiters, or a `#' after a
+   comment that started partway along an earlier line.  */
+
+static U_CHAR *
+strip_comments (buf, length, plength)
+     U_CHAR *buf;
+     int length;
+     int *plength;
+{
+  U_CHAR *result = (U_CHAR *) xmalloc (length + 2);
+  register U_CHAR *ip = buf, *op = result;
+  U_CHAR *limit = buf + length;
+  /* Nonzero if only whitespace and comments precede IP on its line.  */
+  int beg_of_line = 1;
+  /* Nonzero within a preprocessing directive.  */
+  int directive = 0;
+  /* Nonzero if a comment that started after other text on its line
+     ended on this line.  */
+  int after_multiline = 0;
+
+  while (ip < limit) {
+    register U_CHAR c = *ip;
+
+    if (c == '\n') {
+      *op++ = *ip++;
+      beg_of_line = 1;
+      directive = 0;
+      after_multiline = 0;
+    } else if (c == '\\' && ip + 1 < limit && ip[1] == '\n') {
+      *op++ = *ip++;
+      *op++ = *ip++;
+    } else if (is_hor_space[c]) {
+      *op++ = *ip++;
+    } else if (c == '"' || c == '\'') {
+      U_CHAR *start = ip++;
+
+      for (;;) {
+	if (ip >= limit || *ip == '\n' || *ip == 0)
+	  goto fail;
+	if (*ip == '\\') {
+	  ip += 2;
+	  continue;
+	}
+	if (*ip++ == c)
+	  break;
+      }
+      bcopy ((char *) start, (char *) op, ip - start);
+      op += ip - start;
+      beg_of_line = 0;
+    } else if (c == '/' && ip + 1 < limit
+	       && (ip[1] == '*' || (cplusplus_comments && ip[1] == '/'))) {
+      U_CHAR *start = ip;
+      int newlines = 0;
+
+      if (ip[1] == '/') {
+	for (ip += 2; ip < limit && *ip != '\n'; ip++)
+	  if (*ip == '\\' || *ip == 0)
+	    goto fail;
+      } else {
+	for (ip += 2; ; ip++) {
+	  if (ip + 1 >= limit || *ip == 0)
+	    goto fail;
+	  if (*ip == '\\' && ip[1] == '\n')
+	    goto fail;
+	  if (*ip == '*' && ip[1] == '/')
+	    break;
+	  if (*ip == '\n')
+	    newlines++;
+	}
+	ip += 2;
+      }
+
+      if (directive) {
+	bcopy ((char *) start, (char *) op, ip - start);
+	op += ip - start;
+      } else {
+	*op++ = ' ';
+	if (newlines && ! beg_of_line)
+	  after_multiline = 1;
+	while (newlines--)
+	  *op++ = '\n';
+      }
+    } else if (c == '/' && ip + 2 < limit && ip[1] == '\\' && ip[2] == '\n') {
+      goto fail;
+    } else if (c == 0) {
+      goto fail;
+    } else {
+      if (c == '#' || c == '%') {
+	if (after_multiline)
+	  goto fail;
+	if (beg_of_line)
+	  directive = 1;
+      }
+      *op++ = *ip++;
+      beg_of_line = 0;
+    }
+  }
+
+  *plength = op - result;
+  return result;
+
+ fail:
+  free (result);
+  return 0;
+}
+
+/* Read the header cache file NAME, if it exists.
+   A file that is not a header cache is ignored, and replaced later.  */
+
+static void
+read_header_cache (name)
+     char *name;
+{
+  int fd = open (name, O_RDONLY, 0);
+  size_t magic_length = HC_ALIGN (sizeof HEADER_CACHE_MAGIC - 1);
+  struct header_cache_record rec;
+  long record_size;
+  struct stat st;
+  size_t size;
+  char *buf, *p, *limit;
+
+  if (fd < 0)
+    return;
+  if (fstat (fd, &st) != 0 || ! S_ISREG (st.st_mode)
+      || (size = st.st_size) < magic_length + sizeof (long)
+      || size != st.st_size)
+    {
+      close (fd);
+      return;
+    }
+
+  /* The entries point into the buffer, which is kept for the whole run.  */
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  buf = (char *) mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (buf == (char *) MAP_FAILED)
+#endif
+    {
+      buf = xmalloc (size);
+      if (safe_read (fd, buf, size) != size)
+	{
+	  free (buf);
+	  close (fd);
+	  return;
+	}
+    }
+  close (fd);
+
+  if (strncmp (buf, HEADER_CACHE_MAGIC, sizeof HEADER_CACHE_MAGIC - 1) != 0)
+    return;
+  bcopy (buf + magic_length, (char *) &record_size, sizeof record_size);
+  if (record_size != sizeof rec)
+    return;
+
+  limit = buf + size;
+  for (p = buf + magic_length + sizeof (long);
+       limit - p >= sizeof rec; ) {
+    struct header_cache_entry *hc, **bucket;
+    char *fname, *macro, *text;
+
+    bcopy (p, (char *) &rec, sizeof rec);
+    p += sizeof rec;
+
+    /* Check that each string fits in the file and ends in a null.  */
+#define HC_STRING(VAR, LENGTH) \
+    if ((LENGTH) < 0)							\
+      VAR = 0;								\
+    else if ((LENGTH) >= limit - p || p[LENGTH] != '\0')		\
+      break;								\
+    else								\
+      VAR = p, p += HC_ALIGN ((LENGTH) + 1)
+    HC_STRING (fname, rec.fname_length);
+    HC_STRING (macro, rec.macro_length);
+    HC_STRING (text, rec.text_length);
+#undef HC_STRING
+
+    if (! fname || p > limit || lookup_header_cache (fname))
+      break;
+
+    hc = (struct header_cache_entry *)
+      xmalloc (sizeof (struct header_cache_entry));
+    hc->fname = fname;
+    hc->dev = rec.dev;
+    hc->ino = rec.ino;
+    hc->mtime = rec.mtime;
+    hc->size = rec.size;
+    hc->hash = rec.hash;
+    hc->control_macro = (U_CHAR *) macro;
+    hc->text = (U_CHAR *) text;
+    hc->length = text ? rec.text_length : 0;
+    hc->flags = rec.flags;
+    hc->inc = 0;
+    bucket = &header_cache_hashtab[hashf ((U_CHAR *) fname, strlen (fname),
+					  HEADER_CACHE_HASHSIZE)];
+    hc->next = *bucket;
+    *bucket = hc;
+  }
+}
+
+/* Write LENGTH bytes of the string S to the header cache file F,
+   followed by a null and padding.  Write nothing if LENGTH is -1.  */
+
+static void
+write_header_cache_string (f, s, length)
+     FILE *f;
+     U_CHAR *s;
+     long length;
+{
+  static char zeros[sizeof (long)];
+
+  if (length < 0)
+    return;
+  fwrite (s, 1, length, f);
+  fwrite (zeros, 1, HC_ALIGN (length + 1) - length, f);
+}
+
+/* Write the header cache back to its file, if anything changed.
+   The new contents go to a temporary file that then replaces the old one,
+   so that other compilations can read the cache at the same time.  */
+
+static void
+write_header_cache ()
+{
+  static char zeros[sizeof (long)];
+  size_t magic_length = sizeof HEADER_CACHE_MAGIC - 1;
+  long record_size = sizeof (struct header_cache_record);
+  struct header_cache_entry *hc;
+  char *temp_name;
+  FILE *f;
+  int i;
+
+  /* Record the guard macros of the headers that were read.  */
+  for (i = 0; i < HEADER_CACHE_HASHSIZE; i++)
+    for (hc = header_cache_hashtab[i]; hc; hc = hc->next)
+      if (hc->inc) {
+	U_CHAR *macro = hc->inc->control_macro;
+
+	if (macro && ! macro[0])
+	  macro = 0;
+	if (macro
+	    ? (! hc->control_macro
+	       || strcmp ((char *) macro, (char *) hc->control_macro))
+	    : hc->control_macro != 0) {
+	  hc->control_macro = macro;
+	  header_cache_changed = 1;
+	}
+      }
+
+  if (! header_cache_changed)
+    return;
+
+  temp_name = xmalloc (strlen (header_cache_name) + 25);
+  sprintf (temp_name, "%s.%ld", header_cache_name, (long) getpid ());
+  f = fopen (temp_name, "w");
+  if (! f) {
+    warning ("cannot write header cache `%s'", temp_name);
+    return;
+  }
+
+  fwrite (HEADER_CACHE_MAGIC, 1, magic_length, f);
+  fwrite (zeros, 1, HC_ALIGN (magic_length) - magic_length, f);
+  fwrite (&record_size, sizeof record_size, 1, f);
+
+  for (i = 0; i < HEADER_CACHE_HASHSIZE; i++)
+    for (hc = header_cache_hashtab[i]; hc; hc = hc->next) {
+      struct header_cache_record rec;
+
+      rec.fname_length = strlen (hc->fname);
+      rec.macro_length = (hc->control_macro
+			  ? (long) strlen ((char *) hc->control_macro) : -1);
+      rec.text_length = hc->text ? hc->length : -1;
+      rec.dev = hc->dev;
+      rec.ino = hc->ino;
+      rec.mtime = hc->mtime;
+      rec.size = hc->size;
+      rec.hash = hc->hash;
+      rec.flags = hc->flags;
+      fwrite (&rec, sizeof rec, 1, f);
+      write_header_cache_string (f, (U_CHAR *) hc->fname, rec.fname_length);
+      write_header_cache_string (f, hc->control_macro, rec.macro_length);
+      write_header_cache_string (f, hc->text, rec.text_length);
+    }
+
+  if (ferror (f) | (fclose (f) != 0)
+      || rename (temp_name, header_cache_name) != 0) {
+    warning ("cannot write header cache `%s'", header_cache_name);
+    unlink (temp_name);
+  }
+  free (temp_name);
+}
 
 /* Load the specified precompiled header into core, and verify its
    preconditions.  PCF indicates the file descriptor to read, which must
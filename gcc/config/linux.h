@@ -26,6 +26,10 @@ Boston, MA 02111-1307, USA.  */
 #undef HAVE_ATEXIT
 #define HAVE_ATEXIT
 
+/* The arc profiling code in libgcc2.c can lock .da files with fcntl
+   and update them through mmap.  */
+#define TARGET_HAS_F_SETLKW
+
 /* GNU/Linux uses ctype from glibc.a. I am not sure how complete it is.
    For now, we play safe. It may change later. */
 
@@ -161,6 +161,10 @@
 #undef HAVE_ATEXIT
 #define HAVE_ATEXIT
 
+/* The arc profiling code in libgcc2.c can lock .da files with fcntl
+   and update them through mmap.  */
+#define TARGET_HAS_F_SETLKW
+
 /* Elf can do stabs */
 #define SDB_DEBUGGING_INFO
 
@@ -3114,6 +3114,24 @@ while (0)
    Do not define this if the table should contain absolute addresses. */
 #define CASE_VECTOR_PC_RELATIVE (TARGET_MIPS16)
 
+/* The number of instructions it takes to jump through a dispatch table
+   once the index is in range: shift the index, load the entry through
+   the address of the table (which needs a GOT load for abicalls, and
+   then a .cpadd), wait for the load and jump.  */
+#define CASE_TABLEJUMP_COST (TARGET_MIPS16 ? 8 : TARGET_ABICALLS ? 7 : 6)
+
+/* The number of instructions it takes to use the constant X, a case
+   value or the mask of a bit test, in a comparison or an AND with rtx
+   code CODE.  beq and bne only compare registers, so any value but zero
+   must be loaded first; slt, sltu and andi take 16 bit immediates.
+   Other values take a lui, and an ori unless their low half is zero.  */
+#define CASE_CONST_COST(X, CODE)					\
+  (INTVAL (X) == 0 ? 0							\
+   : ((CODE) == AND ? SMALL_INT_UNSIGNED (X)				\
+      : (CODE) != EQ && (CODE) != NE && SMALL_INT (X)) ? 0		\
+   : SMALL_INT (X) || SMALL_INT_UNSIGNED (X) ? 1			\
+   : (INTVAL (X) & 0xffff) == 0 ? 1 : 2)
+
 /* Specify the tree operation to be used to convert reals to integers.  */
 #define IMPLICIT_FIX_EXPR FIX_ROUND_EXPR
 
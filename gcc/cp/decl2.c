@@ -40,6 +40,7 @@ Boston, MA 02111-1307, USA.  */
 #include "expr.h"
 #include "defaults.h"
 #include "toplev.h"
+#include "timevar.h"
 #include "dwarf2out.h"
 #include "dwarfout.h"
 
@@ -2895,7 +2896,6 @@ build_cleanup (decl)
   return temp;
 }
 
-extern int parse_time, varconst_time;
 extern tree pending_templates;
 extern tree maybe_templates;
 
@@ -3138,7 +3138,6 @@ void
 finish_file ()
 {
   extern int lineno;
-  int start_time, this_time;
 
   tree fnname;
   tree vars;
@@ -3152,7 +3151,7 @@ finish_file ()
 
   check_decl_namespace ();
 
-  start_time = get_run_time ();
+  timevar_push (TV_VARCONST);
 
   /* Otherwise, GDB can get confused, because in only knows
      about source for LINENO-1 lines.  */
@@ -3275,12 +3274,6 @@ finish_file ()
       pending_statics = TREE_CHAIN (pending_statics);
     }
 
-  this_time = get_run_time ();
-  parse_time -= this_time - start_time;
-  varconst_time += this_time - start_time;
-
-  start_time = get_run_time ();
-
   if (flag_handle_signatures)
     walk_sigtables ((void (*) PROTO ((tree, tree))) 0,
 		    finish_sigtable_vardecl);
@@ -3403,9 +3396,7 @@ finish_file ()
 
   finish_repo ();
 
-  this_time = get_run_time ();
-  parse_time -= this_time - start_time;
-  varconst_time += this_time - start_time;
+  timevar_pop (TV_VARCONST);
 
   if (flag_detailed_statistics)
     {
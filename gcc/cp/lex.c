@@ -478,6 +478,14 @@ init_parse (filename)
   yy_cur = "\n";
   yy_lim = yy_cur + 1;
 
+  /* If no option was given, lang_decode_option has not set up the
+     reader.  */
+  if (! parse_in.data)
+    {
+      cpp_reader_init (&parse_in);
+      parse_in.data = &parse_options;
+      cpp_options_init (&parse_options);
+    }
   parse_in.show_column = 1;
   if (! cpp_start_read (&parse_in, filename))
     abort ();
@@ -915,7 +923,12 @@ void
 finish_parse ()
 {
 #if USE_CPPLIB
+  extern int errorcount;
+
   cpp_finish (&parse_in);
+  /* Errors reported by the preprocessor make the compilation fail,
+     as they do when it is a separate program.  */
+  errorcount += parse_in.errors;
 #else
   fclose (finput);
 #endif
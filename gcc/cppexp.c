@@ -76,6 +76,14 @@ struct arglist {
 #define MAX_WCHAR_TYPE_SIZE WCHAR_TYPE_SIZE
 #endif
 
+#define MAX_CHAR_TYPE_MASK (MAX_CHAR_TYPE_SIZE < HOST_BITS_PER_LONG \
+			    ? ~ (~ (long) 0 << MAX_CHAR_TYPE_SIZE) \
+			    : ~ (long) 0)
+
+#define MAX_WCHAR_TYPE_MASK (MAX_WCHAR_TYPE_SIZE < HOST_BITS_PER_LONG \
+			     ? ~ (~ (long) 0 << MAX_WCHAR_TYPE_SIZE) \
+			     : ~ (long) 0)
+
 /* Yield nonzero if adding two numbers with A's and B's signs can yield a
    number with SUM's sign, where A, B, and SUM are all C integers.  */
 #define possible_sum_sign(a, b, sum) ((((a) ^ (b)) | ~ ((a) ^ (sum))) < 0)
@@ -336,6 +344,7 @@ cpp_lex (pfile, skip_evaluation)
 	register int num_chars = 0;
 	unsigned width = MAX_CHAR_TYPE_SIZE;
 	int wide_flag = 0;
+	long mask = MAX_CHAR_TYPE_MASK;
 	int max_chars;
 	U_CHAR *ptr = tok_start;
 #ifdef MULTIBYTE_CHARS
@@ -349,6 +358,7 @@ cpp_lex (pfile, skip_evaluation)
 	    ptr++;
 	    wide_flag = 1;
 	    width = MAX_WCHAR_TYPE_SIZE;
+	    mask = MAX_WCHAR_TYPE_MASK;
 #ifdef MULTIBYTE_CHARS
 	    max_chars = MB_CUR_MAX;
 #else
@@ -363,11 +373,7 @@ cpp_lex (pfile, skip_evaluation)
 	  {
 	    if (c == '\\')
 	      {
-		c = cpp_parse_escape (pfile, (char **) &ptr);
-		if (width < HOST_BITS_PER_INT
-		  && (unsigned) c >= (1 << width))
-		    cpp_pedwarn (pfile,
-				 "escape sequence out of range for character");
+		c = cpp_parse_escape (pfile, (char **) &ptr, mask);
 	      }
 
 	    num_chars++;
@@ -482,12 +488,16 @@ cpp_lex (pfile, skip_evaluation)
    value and leave the string pointer pointing at the null character.
 
    If \ is followed by 000, we return 0 and leave the string pointer
-   after the zeros.  A value of 0 does not mean end of string.  */
+   after the zeros.  A value of 0 does not mean end of string.
+
+   RESULT_MASK is the mask of the bits that fit in the character type
+   being parsed; for a wide character it is wider than a byte.  */
 
 int
-cpp_parse_escape (pfile, string_ptr)
+cpp_parse_escape (pfile, string_ptr, result_mask)
      cpp_reader *pfile;
      char **string_ptr;
+     long result_mask;
 {
   register int c = *(*string_ptr)++;
   switch (c)
@@ -526,7 +536,7 @@ cpp_parse_escape (pfile, string_ptr)
     case '6':
     case '7':
       {
-	register int i = c - '0';
+	register long i = c - '0';
 	register int count = 0;
 	while (++count < 3)
 	  {
@@ -539,17 +549,17 @@ cpp_parse_escape (pfile, string_ptr)
 		break;
 	      }
 	  }
-	if ((i & ~((1 << MAX_CHAR_TYPE_SIZE) - 1)) != 0)
+	if (i != (i & result_mask))
 	  {
-	    i &= (1 << MAX_CHAR_TYPE_SIZE) - 1;
-	    cpp_pedwarn (pfile,
-			  "octal character constant does not fit in a byte");
+	    i &= result_mask;
+	    cpp_pedwarn (pfile, "octal escape sequence out of range");
 	  }
 	return i;
       }
     case 'x':
       {
-	register unsigned i = 0, overflow = 0, digits_found = 0, digit;
+	register unsigned long i = 0, overflow = 0;
+	register int digits_found = 0, digit;
 	for (;;)
 	  {
 	    c = *(*string_ptr)++;
@@ -570,11 +580,10 @@ cpp_parse_escape (pfile, string_ptr)
 	  }
 	if (!digits_found)
 	  cpp_error (pfile, "\\x used with no following hex digits");
-	if (overflow | (i & ~((1 << BITS_PER_UNIT) - 1)))
+	if (overflow | (i != (i & result_mask)))
 	  {
-	    i &= (1 << BITS_PER_UNIT) - 1;
-	    cpp_pedwarn (pfile,
-			 "hex character constant does not fit in a byte");
+	    i &= result_mask;
+	    cpp_pedwarn (pfile, "hex escape sequence out of range");
 	  }
 	return i;
       }
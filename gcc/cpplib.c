@@ -40,6 +40,19 @@ Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.  */
 # include <sys/resource.h>
 #endif
 
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+# ifndef MAP_FAILED
+#  define MAP_FAILED ((void *) -1)
+# endif
+#endif
+
+/* Files at least this big are mapped into memory rather than read,
+   if possible; see map_file.  */
+#ifndef MMAP_THRESHOLD
+#define MMAP_THRESHOLD (64 * 1024)
+#endif
+
 #include "gansidecl.h"
 #include "cpplib.h"
 #include "cpphash.h"
@@ -241,6 +254,8 @@ static int change_newlines		PROTO ((U_CHAR *, int));
 static struct arglist *read_token_list	PROTO ((cpp_reader *, int *));
 static void free_token_list		PROTO ((struct arglist *));
 static int safe_read			PROTO ((int, char *, int));
+static U_CHAR *map_file			PROTO ((int, size_t));
+static int mapped_file_cleanup		PROTO ((cpp_buffer *, cpp_reader *));
 static void push_macro_expansion PARAMS ((cpp_reader *,
 					  U_CHAR *, int, HASHNODE *));
 static struct cpp_pending *nreverse_pending PARAMS ((struct cpp_pending *));
@@ -818,6 +833,23 @@ file_cleanup (pbuf, pfile)
   return 0;
 }
 
+/* Like file_cleanup, for a buffer whose contents were mapped by map_file.  */
+
+static int
+mapped_file_cleanup (pbuf, pfile)
+     cpp_buffer *pbuf ATTRIBUTE_UNUSED;
+     cpp_reader *pfile ATTRIBUTE_UNUSED;
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  if (pbuf->buf)
+    {
+      munmap ((char *) pbuf->buf, pbuf->alimit - pbuf->buf);
+      pbuf->buf = 0;
+    }
+#endif
+  return 0;
+}
+
 /* Assuming we have read '/'.
    If this is the start of a comment (followed by '*' or '/'),
    skip to the end of the comment, and return ' '.
@@ -3659,7 +3691,8 @@ convert_string (pfile, result, in, limit, handle_escapes)
 	  if (handle_escapes)
 	    {
 	      char *bpc = (char *) in;
-	      int i = (U_CHAR) cpp_parse_escape (pfile, &bpc);
+	      int i = (U_CHAR) cpp_parse_escape (pfile, &bpc,
+						 (1 << BITS_PER_UNIT) - 1);
 	      in = (U_CHAR *) bpc;
 	      if (i >= 0)
 		*result++ = (U_CHAR)c;
@@ -5597,13 +5630,22 @@ finclude (pfile, f, fname, system_header_p, dirptr)
       close (f);
       return 0;
     }
-    fp->buf = (U_CHAR *) xmalloc (st_size + 2);
+    fp->buf = map_file (f, st_size);
+    if (fp->buf)
+      {
+	fp->cleanup = mapped_file_cleanup;
+	length = st_size;
+      }
+    else
+      {
+	fp->buf = (U_CHAR *) xmalloc (st_size + 2);
+
+	/* Read the file contents, knowing that st_size is an upper bound
+	   on the number of bytes we can read.  */
+	length = safe_read (f, fp->buf, st_size);
+      }
     fp->alimit = fp->buf + st_size + 2;
     fp->cur = fp->buf;
-
-    /* Read the file contents, knowing that st_size is an upper bound
-       on the number of bytes we can read.  */
-    length = safe_read (f, fp->buf, st_size);
     fp->rlimit = fp->buf + length;
     if (length < 0) goto nope;
   }
@@ -7310,6 +7352,61 @@ safe_read (desc, ptr, len)
   return len - left;
 }
 
+/* Map the regular file open on descriptor DESC, which is SIZE bytes
+   long, into memory, if it is big enough for that to be cheaper than
+   reading it.  Return its address, or 0 if it was not mapped; then
+   the caller should read it instead.
+
+   The mapping is private and writable, since finclude may store a
+   newline and a null after the contents, so at least two bytes must
+   be addressable there.  The rest of the last page of the file reads
+   as zeros; if that leaves too little room, map an extra page of zeros
+   after the file.  The mapping is released by mapped_file_cleanup.  */
+
+static U_CHAR *
+map_file (desc, size)
+     int desc ATTRIBUTE_UNUSED;
+     size_t size ATTRIBUTE_UNUSED;
+{
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+  size_t pagesize;
+  char *buf;
+
+  if (size < MMAP_THRESHOLD || size + 2 < size)
+    return 0;
+
+#ifdef _SC_PAGESIZE
+  pagesize = sysconf (_SC_PAGESIZE);
+#else
+  pagesize = getpagesize ();
+#endif
+
+  if (size % pagesize != 0 && size % pagesize <= pagesize - 2)
+    buf = (char *) mmap (0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+			 desc, 0);
+  else
+    {
+#ifdef MAP_ANONYMOUS
+      buf = (char *) mmap (0, size + pagesize, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (buf != (char *) MAP_FAILED
+	  && mmap (buf, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+		   desc, 0) == (char *) MAP_FAILED)
+	{
+	  munmap (buf, size + pagesize);
+	  buf = (char *) MAP_FAILED;
+	}
+#else
+      buf = (char *) MAP_FAILED;
+#endif
+    }
+
+  if (buf != (char *) MAP_FAILED)
+    return (U_CHAR *) buf;
+#endif
+  return 0;
+}
+
 static char *
 xcalloc (number, size)
      unsigned number, size;
@@ -166,6 +166,8 @@ Other expressions:
    entered in the table; otherwise, it contains the value reg_tick[i] had
    when the references were entered.  If we want to enter a reference
    and reg_in_table[i] != reg_tick[i], we must scan and remove old references.
+   The scan only looks at the elements on the chain `reg_elt_refs[i]',
+   which holds the elements whose expressions mention register i.
    Until we want to enter a new entry, the mere fact that the two vectors
    don't match makes the entries be ignored if anyone tries to match them.
 
@@ -414,6 +416,13 @@ static int hash_arg_in_struct;
 
    The `flag' field is used as a temporary during some search routines.
 
+   The `hash' field is the hash code the element was entered with, before
+   it is reduced to a bucket number, so that the element can be moved to
+   the right bucket when the table changes size.
+
+   The `reg_refs' field is the chain of `struct reg_ref's that record the
+   registers mentioned in `exp'.
+
    The `mode' field is usually the same as GET_MODE (`exp'), but
    if `exp' is a CONST_INT and has no machine mode then the `mode'
    field is the mode it was being used as.  Each constant is
@@ -429,6 +438,8 @@ struct table_elt
   struct table_elt *prev_same_value;
   struct table_elt *first_same_value;
   struct table_elt *related_value;
+  struct reg_ref *reg_refs;
+  unsigned hash;
   int cost;
   enum machine_mode mode;
   char in_memory;
@@ -437,18 +448,48 @@ struct table_elt
   char flag;
 };
 
+/* Each register mentioned by the expression of a table element has a
+   `struct reg_ref' on two chains: the chain of the element, through
+   `next_same_elt', and the chain of the register, which starts at
+   `reg_elt_refs[regno]' and goes both ways through `next_same_reg' and
+   `prev_same_reg'.  A hard register that spans several registers is
+   recorded for each of them.  This lets us find the elements that
+   mention a register without searching the whole table.  */
+
+struct reg_ref
+{
+  struct table_elt *elt;
+  struct reg_ref *next_same_elt;
+  struct reg_ref *next_same_reg;
+  struct reg_ref *prev_same_reg;
+  int regno;
+};
+
 /* We don't want a lot of buckets, because we rarely have very many
    things stored in the hash table, and a lot of buckets slows
-   down a lot of loops that happen frequently.  */
-#define NBUCKETS 31
+   down a lot of loops that happen frequently.  So the table starts
+   with the first of these sizes, and grows through them when it holds
+   more than two elements per bucket.  When a new basic block starts,
+   the table shrinks to fit the number of elements the last one used.  */
+
+static int table_sizes[] =
+  { 31, 61, 127, 251, 509, 1021, 2039, 4093, 8191, 16381, 32749, 65521 };
+
+#define N_TABLE_SIZES ((int) (sizeof table_sizes / sizeof table_sizes[0]))
 
 /* Compute hash code of X in mode M.  Special-case case where X is a pseudo
-   register (hard registers may require `do_not_record' to be set).  */
+   register (hard registers may require `do_not_record' to be set).
+   The hash code is reduced to a bucket number only when the table is
+   accessed, so it stays valid when the table changes size.  */
 
 #define HASH(X, M)	\
  (GET_CODE (X) == REG && REGNO (X) >= FIRST_PSEUDO_REGISTER	\
-  ? (((unsigned) REG << 7) + (unsigned) reg_qty[REGNO (X)]) % NBUCKETS	\
-  : canon_hash (X, M) % NBUCKETS)
+  ? (((unsigned) REG << 7) + (unsigned) reg_qty[REGNO (X)])	\
+  : canon_hash (X, M))
+
+/* The bucket of the hash table for hash code HASH.  */
+
+#define BUCKET(HASH) ((HASH) % table_size)
 
 /* Determine whether register number N is considered a fixed register for CSE.
    It is desirable to replace other regs with fixed regs, to reduce need for
@@ -507,13 +548,31 @@ struct table_elt
    ? -1 : ADDRESS_COST(RTX))
 #endif 
 
-static struct table_elt *table[NBUCKETS];
+/* The hash table, its number of buckets, the index of that number in
+   `table_sizes', the number of elements in it, and the largest number of
+   elements it has held since the current basic block started.  */
+
+static struct table_elt **table;
+static int table_size;
+static int table_size_index;
+static int table_elts;
+static int table_peak_elts;
 
 /* Chain of `struct table_elt's made so far for this function
    but currently removed from the table.  */
 
 static struct table_elt *free_element_chain;
 
+/* For each register, the chain of `struct reg_ref's of the table elements
+   that mention it.  */
+
+static struct reg_ref **reg_elt_refs;
+
+/* Chain, through `next_same_elt', of `struct reg_ref's made so far for
+   this function but not in use.  */
+
+static struct reg_ref *free_reg_ref_chain;
+
 /* Number of `struct table_elt' structures made so far for this function.  */
 
 static int n_elements_made;
@@ -614,7 +673,11 @@ static void delete_reg_equiv	PROTO((int));
 static int mention_regs		PROTO((rtx));
 static int insert_regs		PROTO((rtx, struct table_elt *, int));
 static void free_element	PROTO((struct table_elt *));
-static void remove_from_table	PROTO((struct table_elt *, unsigned));
+static void resize_table	PROTO((int));
+static void add_reg_ref		PROTO((struct table_elt *, int));
+static void record_reg_refs	PROTO((struct table_elt *, rtx));
+static void remove_reg_refs	PROTO((struct table_elt *));
+static void remove_from_table	PROTO((struct table_elt *));
 static struct table_elt *get_element PROTO((void));
 static struct table_elt *lookup	PROTO((rtx, unsigned, enum machine_mode)),
        *lookup_for_remove PROTO((rtx, unsigned, enum machine_mode));
@@ -806,7 +869,7 @@ new_basic_block ()
   /* The per-quantity values used to be initialized here, but it is
      much faster to initialize each as it is made in `make_new_qty'.  */
 
-  for (i = 0; i < NBUCKETS; i++)
+  for (i = 0; i < table_size; i++)
     {
       register struct table_elt *this, *next;
       for (this = table[i]; this; this = next)
@@ -816,7 +879,20 @@ new_basic_block ()
 	}
     }
 
-  bzero ((char *) table, sizeof table);
+  bzero ((char *) table, table_size * sizeof (struct table_elt *));
+  bzero ((char *) reg_elt_refs, max_reg * sizeof (struct reg_ref *));
+
+  /* Make the table just big enough for the elements of the last basic
+     block, on the guess that this one will be like it.  */
+  for (i = 0; i < table_size_index; i++)
+    if (2 * table_sizes[i] >= table_peak_elts)
+      break;
+
+  if (i < table_size_index)
+    resize_table (i);
+
+  table_elts = 0;
+  table_peak_elts = 0;
 
   prev_insn = 0;
 
@@ -1087,12 +1163,25 @@ insert_regs (x, classp, modified)
 
 /* Look in or update the hash table.  */
 
-/* Put the element ELT on the list of free elements.  */
+/* Put the element ELT on the list of free elements, and its `struct
+   reg_ref's on theirs.  The caller must have taken them off the chains
+   of their registers, or be about to clear those chains.  */
 
 static void
 free_element (elt)
      struct table_elt *elt;
 {
+  struct reg_ref *ref = elt->reg_refs;
+
+  if (ref)
+    {
+      while (ref->next_same_elt)
+	ref = ref->next_same_elt;
+      ref->next_same_elt = free_reg_ref_chain;
+      free_reg_ref_chain = elt->reg_refs;
+      elt->reg_refs = 0;
+    }
+
   elt->next_same_hash = free_element_chain;
   free_element_chain = elt;
 }
@@ -1112,15 +1201,138 @@ get_element ()
   return (struct table_elt *) oballoc (sizeof (struct table_elt));
 }
 
-/* Remove table element ELT from use in the table.
-   HASH is its hash code, made using the HASH macro.
-   It's an argument because often that is known in advance
-   and we save much time not recomputing it.  */
+/* Give the hash table `table_sizes[INDEX]' buckets, and move the elements
+   to their buckets in the new table.  */
+
+static void
+resize_table (index)
+     int index;
+{
+  struct table_elt **old_table = table;
+  int old_size = table_size;
+  register int i;
+
+  table_size_index = index;
+  table_size = table_sizes[index];
+  table = (struct table_elt **) xcalloc (table_size,
+					 sizeof (struct table_elt *));
+
+  for (i = 0; i < old_size; i++)
+    {
+      register struct table_elt *p, *next;
+
+      for (p = old_table[i]; p; p = next)
+	{
+	  unsigned bucket = BUCKET (p->hash);
+
+	  next = p->next_same_hash;
+	  p->next_same_hash = table[bucket];
+	  p->prev_same_hash = 0;
+	  if (table[bucket])
+	    table[bucket]->prev_same_hash = p;
+	  table[bucket] = p;
+	}
+    }
+
+  free (old_table);
+}
+
+/* Record that the expression of table element ELT mentions register
+   REGNO, unless that is already known.  */
 
 static void
-remove_from_table (elt, hash)
+add_reg_ref (elt, regno)
+     struct table_elt *elt;
+     int regno;
+{
+  struct reg_ref *ref;
+
+  for (ref = elt->reg_refs; ref; ref = ref->next_same_elt)
+    if (ref->regno == regno)
+      return;
+
+  ref = free_reg_ref_chain;
+  if (ref)
+    free_reg_ref_chain = ref->next_same_elt;
+  else
+    ref = (struct reg_ref *) oballoc (sizeof (struct reg_ref));
+
+  ref->elt = elt;
+  ref->regno = regno;
+  ref->next_same_elt = elt->reg_refs;
+  elt->reg_refs = ref;
+
+  ref->prev_same_reg = 0;
+  ref->next_same_reg = reg_elt_refs[regno];
+  if (reg_elt_refs[regno])
+    reg_elt_refs[regno]->prev_same_reg = ref;
+  reg_elt_refs[regno] = ref;
+}
+
+/* Record the registers mentioned by X, part of the expression of table
+   element ELT.  */
+
+static void
+record_reg_refs (elt, x)
+     struct table_elt *elt;
+     rtx x;
+{
+  register enum rtx_code code;
+  register char *fmt;
+  register int i, j;
+
+  if (x == 0)
+    return;
+
+  code = GET_CODE (x);
+  if (code == REG)
+    {
+      int regno = REGNO (x);
+      int endregno = regno + (regno < FIRST_PSEUDO_REGISTER
+			      ? HARD_REGNO_NREGS (regno, GET_MODE (x)) : 1);
+
+      for (i = regno; i < endregno; i++)
+	add_reg_ref (elt, i);
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	record_reg_refs (elt, XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  record_reg_refs (elt, XVECEXP (x, i, j));
+    }
+}
+
+/* Take the `struct reg_ref's of table element ELT off the chains of
+   their registers.  */
+
+static void
+remove_reg_refs (elt)
+     struct table_elt *elt;
+{
+  register struct reg_ref *ref;
+
+  for (ref = elt->reg_refs; ref; ref = ref->next_same_elt)
+    {
+      if (ref->next_same_reg)
+	ref->next_same_reg->prev_same_reg = ref->prev_same_reg;
+
+      if (ref->prev_same_reg)
+	ref->prev_same_reg->next_same_reg = ref->next_same_reg;
+      else
+	reg_elt_refs[ref->regno] = ref->next_same_reg;
+    }
+}
+
+/* Remove table element ELT from use in the table.  */
+
+static void
+remove_from_table (elt)
      register struct table_elt *elt;
-     unsigned hash;
 {
   if (elt == 0)
     return;
@@ -1159,18 +1371,8 @@ remove_from_table (elt, hash)
 
     if (prev)
       prev->next_same_hash = next;
-    else if (table[hash] == elt)
-      table[hash] = next;
     else
-      {
-	/* This entry is not in the proper hash bucket.  This can happen
-	   when two classes were merged by `merge_equiv_classes'.  Search
-	   for the hash bucket that it heads.  This happens only very
-	   rarely, so the cost is acceptable.  */
-	for (hash = 0; hash < NBUCKETS; hash++)
-	  if (table[hash] == elt)
-	    table[hash] = next;
-      }
+      table[BUCKET (elt->hash)] = next;
   }
 
   /* Remove the table element from its related-value circular chain.  */
@@ -1185,7 +1387,9 @@ remove_from_table (elt, hash)
 	p->related_value = 0;
     }
 
+  remove_reg_refs (elt);
   free_element (elt);
+  table_elts--;
 }
 
 /* Look up X in the hash table and return its table element,
@@ -1205,7 +1409,7 @@ lookup (x, hash, mode)
 {
   register struct table_elt *p;
 
-  for (p = table[hash]; p; p = p->next_same_hash)
+  for (p = table[BUCKET (hash)]; p; p = p->next_same_hash)
     if (mode == p->mode && ((x == p->exp && GET_CODE (x) == REG)
 			    || exp_equiv_p (x, p->exp, GET_CODE (x) != REG, 0)))
       return p;
@@ -1229,14 +1433,14 @@ lookup_for_remove (x, hash, mode)
       int regno = REGNO (x);
       /* Don't check the machine mode when comparing registers;
 	 invalidating (REG:SI 0) also invalidates (REG:DF 0).  */
-      for (p = table[hash]; p; p = p->next_same_hash)
+      for (p = table[BUCKET (hash)]; p; p = p->next_same_hash)
 	if (GET_CODE (p->exp) == REG
 	    && REGNO (p->exp) == regno)
 	  return p;
     }
   else
     {
-      for (p = table[hash]; p; p = p->next_same_hash)
+      for (p = table[BUCKET (hash)]; p; p = p->next_same_hash)
 	if (mode == p->mode && (x == p->exp || exp_equiv_p (x, p->exp, 0, 0)))
 	  return p;
     }
@@ -1252,7 +1456,7 @@ lookup_as_function (x, code)
      rtx x;
      enum rtx_code code;
 {
-  register struct table_elt *p = lookup (x, safe_hash (x, VOIDmode) % NBUCKETS,
+  register struct table_elt *p = lookup (x, safe_hash (x, VOIDmode),
 					 GET_MODE (x));
   if (p == 0)
     return 0;
@@ -1302,6 +1506,7 @@ insert (x, classp, hash, mode)
      enum machine_mode mode;
 {
   register struct table_elt *elt;
+  unsigned bucket;
 
   /* If X is a register and we haven't made a quantity for it,
      something is wrong.  */
@@ -1327,14 +1532,17 @@ insert (x, classp, hash, mode)
 
   /* Put an element for X into the right hash bucket.  */
 
+  bucket = BUCKET (hash);
   elt = get_element ();
   elt->exp = x;
+  elt->hash = hash;
   elt->cost = COST (x);
   elt->next_same_value = 0;
   elt->prev_same_value = 0;
-  elt->next_same_hash = table[hash];
+  elt->next_same_hash = table[bucket];
   elt->prev_same_hash = 0;
   elt->related_value = 0;
+  elt->reg_refs = 0;
   elt->in_memory = 0;
   elt->mode = mode;
   elt->is_const = (CONSTANT_P (x)
@@ -1345,9 +1553,16 @@ insert (x, classp, hash, mode)
 		       && REGNO (x) >= FIRST_PSEUDO_REGISTER)
 		   || FIXED_BASE_PLUS_P (x));
 
-  if (table[hash])
-    table[hash]->prev_same_hash = elt;
-  table[hash] = elt;
+  if (table[bucket])
+    table[bucket]->prev_same_hash = elt;
+  table[bucket] = elt;
+
+  record_reg_refs (elt, x);
+
+  if (++table_elts > table_peak_elts)
+    table_peak_elts = table_elts;
+  if (table_elts > 2 * table_size && table_size_index < N_TABLE_SIZES - 1)
+    resize_table (table_size_index + 1);
 
   /* Put it into the proper value-class.  */
   if (classp)
@@ -1439,7 +1654,7 @@ insert (x, classp, hash, mode)
       if (subexp != 0)
 	{
 	  /* Get the integer-free subexpression in the hash table.  */
-	  subhash = safe_hash (subexp, mode) % NBUCKETS;
+	  subhash = safe_hash (subexp, mode);
 	  subelt = lookup (subexp, subhash, mode);
 	  if (subelt == 0)
 	    subelt = insert (subexp, NULL_PTR, subhash, mode);
@@ -1503,7 +1718,7 @@ merge_equiv_classes (class1, class2)
 	  if (GET_CODE (exp) == REG)
 	    delete_reg_equiv (REGNO (exp));
 	      
-	  remove_from_table (elt, hash);
+	  remove_from_table (elt);
 
 	  if (insert_regs (exp, class1, 0))
 	    {
@@ -1570,15 +1785,15 @@ invalidate (x, full_mode)
 	  struct table_elt *elt;
 
 	  while ((elt = lookup_for_remove (x, hash, GET_MODE (x))))
-	    remove_from_table (elt, hash);
+	    remove_from_table (elt);
 	}
       else
 	{
 	  HOST_WIDE_INT in_table
 	    = TEST_HARD_REG_BIT (hard_regs_in_table, regno);
 	  int endregno = regno + HARD_REGNO_NREGS (regno, GET_MODE (x));
-	  int tregno, tendregno;
-	  register struct table_elt *p, *next;
+	  int tregno;
+	  register struct reg_ref *ref, *next;
 
 	  CLEAR_HARD_REG_BIT (hard_regs_in_table, regno);
 
@@ -1590,21 +1805,15 @@ invalidate (x, full_mode)
 	      reg_tick[i]++;
 	    }
 
+	  /* A hard register in the table is on the chain of each
+	     register it spans, so this finds every overlapping one.  */
 	  if (in_table)
-	    for (hash = 0; hash < NBUCKETS; hash++)
-	      for (p = table[hash]; p; p = next)
+	    for (tregno = regno; tregno < endregno; tregno++)
+	      for (ref = reg_elt_refs[tregno]; ref; ref = next)
 		{
-		  next = p->next_same_hash;
-
-		  if (GET_CODE (p->exp) != REG
-		      || REGNO (p->exp) >= FIRST_PSEUDO_REGISTER)
-		    continue;
-
-		  tregno = REGNO (p->exp);
-		  tendregno
-		    = tregno + HARD_REGNO_NREGS (tregno, GET_MODE (p->exp));
-		  if (tendregno > regno && tregno < endregno)
-		  remove_from_table (p, hash);
+		  next = ref->next_same_reg;
+		  if (GET_CODE (ref->elt->exp) == REG)
+		    remove_from_table (ref->elt);
 		}
 	}
 
@@ -1647,7 +1856,7 @@ invalidate (x, full_mode)
   if (full_mode == VOIDmode)
     full_mode = GET_MODE (x);
 
-  for (i = 0; i < NBUCKETS; i++)
+  for (i = 0; i < table_size; i++)
     {
       register struct table_elt *next;
       for (p = table[i]; p; p = next)
@@ -1658,7 +1867,7 @@ invalidate (x, full_mode)
 	  if (p->in_memory
 	      && (GET_CODE (p->exp) != MEM
 		  || true_dependence (x, full_mode, p->exp, cse_rtx_varies_p)))
-	    remove_from_table (p, i);
+	    remove_from_table (p);
 	}
     }
 }
@@ -1672,17 +1881,15 @@ static void
 remove_invalid_refs (regno)
      int regno;
 {
-  register int i;
-  register struct table_elt *p, *next;
+  register struct reg_ref *ref, *next;
 
-  for (i = 0; i < NBUCKETS; i++)
-    for (p = table[i]; p; p = next)
-      {
-	next = p->next_same_hash;
-	if (GET_CODE (p->exp) != REG
-	    && refers_to_regno_p (regno, regno + 1, p->exp, NULL_PTR))
-	  remove_from_table (p, i);
-      }
+  for (ref = reg_elt_refs[regno]; ref; ref = next)
+    {
+      next = ref->next_same_reg;
+      if (GET_CODE (ref->elt->exp) != REG
+	  && refers_to_regno_p (regno, regno + 1, ref->elt->exp, NULL_PTR))
+	remove_from_table (ref->elt);
+    }
 }
 
 /* Recompute the hash codes of any valid entries in the hash table that
@@ -1694,9 +1901,9 @@ static void
 rehash_using_reg (x)
      rtx x;
 {
-  int i;
-  struct table_elt *p, *next;
-  unsigned hash;
+  struct reg_ref *ref;
+  struct table_elt *p;
+  unsigned hash, bucket;
 
   if (GET_CODE (x) == SUBREG)
     x = SUBREG_REG (x);
@@ -1709,33 +1916,37 @@ rehash_using_reg (x)
       || reg_in_table[REGNO (x)] != reg_tick[REGNO (x)])
     return;
 
-  /* Scan all hash chains looking for valid entries that mention X.
-     If we find one and it is in the wrong hash chain, move it.  We can skip
-     objects that are registers, since they are handled specially.  */
+  /* Look at the valid entries that mention X.  If we find one and it is
+     in the wrong hash chain, move it.  We can skip objects that are
+     registers, since they are handled specially.  */
 
-  for (i = 0; i < NBUCKETS; i++)
-    for (p = table[i]; p; p = next)
-      {
-	next = p->next_same_hash;
-	if (GET_CODE (p->exp) != REG && reg_mentioned_p (x, p->exp)
-	    && exp_equiv_p (p->exp, p->exp, 1, 0)
-	    && i != (hash = safe_hash (p->exp, p->mode) % NBUCKETS))
-	  {
-	    if (p->next_same_hash)
-	      p->next_same_hash->prev_same_hash = p->prev_same_hash;
-
-	    if (p->prev_same_hash)
-	      p->prev_same_hash->next_same_hash = p->next_same_hash;
-	    else
-	      table[i] = p->next_same_hash;
-
-	    p->next_same_hash = table[hash];
-	    p->prev_same_hash = 0;
-	    if (table[hash])
-	      table[hash]->prev_same_hash = p;
-	    table[hash] = p;
-	  }
-      }
+  for (ref = reg_elt_refs[REGNO (x)]; ref; ref = ref->next_same_reg)
+    {
+      p = ref->elt;
+      if (GET_CODE (p->exp) != REG && reg_mentioned_p (x, p->exp)
+	  && exp_equiv_p (p->exp, p->exp, 1, 0)
+	  && p->hash != (hash = safe_hash (p->exp, p->mode)))
+	{
+	  bucket = BUCKET (hash);
+	  if (bucket != BUCKET (p->hash))
+	    {
+	      if (p->next_same_hash)
+		p->next_same_hash->prev_same_hash = p->prev_same_hash;
+
+	      if (p->prev_same_hash)
+		p->prev_same_hash->next_same_hash = p->next_same_hash;
+	      else
+		table[BUCKET (p->hash)] = p->next_same_hash;
+
+	      p->next_same_hash = table[bucket];
+	      p->prev_same_hash = 0;
+	      if (table[bucket])
+		table[bucket]->prev_same_hash = p;
+	      table[bucket] = p;
+	    }
+	  p->hash = hash;
+	}
+    }
 }
 
 /* Remove from the hash table any expression that is a call-clobbered
@@ -1770,14 +1981,14 @@ invalidate_for_call ()
      entry that overlaps a call-clobbered register.  */
 
   if (in_table)
-    for (hash = 0; hash < NBUCKETS; hash++)
+    for (hash = 0; hash < table_size; hash++)
       for (p = table[hash]; p; p = next)
 	{
 	  next = p->next_same_hash;
 
 	  if (p->in_memory)
 	    {
-	      remove_from_table (p, hash);
+	      remove_from_table (p);
 	      continue;
 	    }
 
@@ -1791,7 +2002,7 @@ invalidate_for_call ()
 	  for (i = regno; i < endregno; i++)
 	    if (TEST_HARD_REG_BIT (regs_invalidated_by_call, i))
 	      {
-		remove_from_table (p, hash);
+		remove_from_table (p);
 		break;
 	      }
 	}
@@ -1823,7 +2034,7 @@ use_related_value (x, elt)
       rtx subexp = get_related_value (x);
       if (subexp != 0)
 	relt = lookup (subexp,
-		       safe_hash (subexp, GET_MODE (subexp)) % NBUCKETS,
+		       safe_hash (subexp, GET_MODE (subexp)),
 		       GET_MODE (subexp));
     }
 
@@ -2882,7 +3093,7 @@ find_comparison_args (code, parg1, parg2, pmode1, pmode2)
       if (x == 0)
 	/* Look up ARG1 in the hash table and see if it has an equivalence
 	   that lets us see what is being compared.  */
-	p = lookup (arg1, safe_hash (arg1, GET_MODE (arg1)) % NBUCKETS,
+	p = lookup (arg1, safe_hash (arg1, GET_MODE (arg1)),
 		    GET_MODE (arg1));
       if (p) p = p->first_same_value;
 
@@ -5447,11 +5658,11 @@ fold_rtx (x, insn)
 			  && (reg_qty[REGNO (folded_arg0)]
 			      == reg_qty[REGNO (folded_arg1)]))
 		      || ((p0 = lookup (folded_arg0,
-					(safe_hash (folded_arg0, mode_arg0)
-					 % NBUCKETS), mode_arg0))
+					safe_hash (folded_arg0, mode_arg0),
+					mode_arg0))
 			  && (p1 = lookup (folded_arg1,
-					   (safe_hash (folded_arg1, mode_arg0)
-					    % NBUCKETS), mode_arg0))
+					   safe_hash (folded_arg1, mode_arg0),
+					   mode_arg0))
 			  && p0->first_same_value == p1->first_same_value)))
 		return ((code == EQ || code == LE || code == GE
 			 || code == LEU || code == GEU)
@@ -5607,8 +5818,7 @@ fold_rtx (x, insn)
 	    {
 	      rtx new_const = GEN_INT (- INTVAL (const_arg1));
 	      struct table_elt *p
-		= lookup (new_const, safe_hash (new_const, mode) % NBUCKETS,
-			  mode);
+		= lookup (new_const, safe_hash (new_const, mode), mode);
 
 	      if (p)
 		for (p = p->first_same_value; p; p = p->next_same_value)
@@ -5788,7 +5998,7 @@ equiv_constant (x)
       if (CONSTANT_P (x))
 	return x;
 
-      elt = lookup (x, safe_hash (x, GET_MODE (x)) % NBUCKETS, GET_MODE (x));
+      elt = lookup (x, safe_hash (x, GET_MODE (x)), GET_MODE (x));
       if (elt == 0)
 	return 0;
 
@@ -7701,12 +7911,12 @@ invalidate_memory ()
   register int i;
   register struct table_elt *p, *next;
 
-  for (i = 0; i < NBUCKETS; i++)
+  for (i = 0; i < table_size; i++)
     for (p = table[i]; p; p = next)
       {
 	next = p->next_same_hash;
 	if (p->in_memory)
-	  remove_from_table (p, i);
+	  remove_from_table (p);
       }
 }
 
@@ -8404,6 +8614,8 @@ cse_main (f, nregs, after_loop, file)
   reg_qty = (int *) alloca (nregs * sizeof (int));
   reg_in_table = (int *) alloca (nregs * sizeof (int));
   reg_tick = (int *) alloca (nregs * sizeof (int));
+  reg_elt_refs
+    = (struct reg_ref **) alloca (nregs * sizeof (struct reg_ref *));
 
 #ifdef LOAD_EXTEND_OP
 
@@ -8414,8 +8626,14 @@ cse_main (f, nregs, after_loop, file)
 
   /* Discard all the free elements of the previous function
      since they are allocated in the temporarily obstack.  */
-  bzero ((char *) table, sizeof table);
+  table_size_index = 0;
+  table_size = table_sizes[0];
+  table = (struct table_elt **) xcalloc (table_size,
+					 sizeof (struct table_elt *));
+  table_elts = 0;
+  table_peak_elts = 0;
   free_element_chain = 0;
+  free_reg_ref_chain = 0;
   n_elements_made = 0;
 
   /* Find the largest uid.  */
@@ -8535,6 +8753,9 @@ cse_main (f, nregs, after_loop, file)
   /* Tell refers_to_mem_p that qty_const info is not available.  */
   qty_const = 0;
 
+  free (table);
+  table = 0;
+
   if (max_elements_made < n_elements_made)
     max_elements_made = n_elements_made;
 
@@ -8605,7 +8826,7 @@ cse_basic_block (from, to, next_branch, around_loop)
 	 Perhaps for 2.9.  */
       if (code != NOTE && num_insns++ > 1000)
 	{
-	  for (i = 0; i < NBUCKETS; i++)
+	  for (i = 0; i < table_size; i++)
 	    for (p = table[i]; p; p = next)
 	      {
 		next = p->next_same_hash;
@@ -8613,7 +8834,7 @@ cse_basic_block (from, to, next_branch, around_loop)
 		if (GET_CODE (p->exp) == REG)
 		  invalidate (p->exp, p->mode);
 		else
-		  remove_from_table (p, i);
+		  remove_from_table (p);
 	      }
 
 	  num_insns = 0;
@@ -11348,7 +11348,8 @@ do_store_flag (exp, target, mode, only_cheap)
    TABLE_LABEL is a CODE_LABEL rtx for the table itself.
 
    DEFAULT_LABEL is a CODE_LABEL rtx to jump to if the
-   index value is out of range.  */
+   index value is out of range.  If it is zero, the index
+   value is known to be in range and is not checked.  */
 
 void
 do_tablejump (index, mode, range, table_label, default_label)
@@ -11365,8 +11366,11 @@ do_tablejump (index, mode, range, table_label, default_label)
      or equal to the minimum value of the range and less than or equal to
      the maximum value of the range.  */
 
-  emit_cmp_insn (index, range, GTU, NULL_RTX, mode, 1, 0);
-  emit_jump_insn (gen_bgtu (default_label));
+  if (default_label)
+    {
+      emit_cmp_insn (index, range, GTU, NULL_RTX, mode, 1, 0);
+      emit_jump_insn (gen_bgtu (default_label));
+    }
 
   /* If index is in range, it must fit in Pmode.
      Convert to Pmode so we can index with it.  */
@@ -67,6 +67,11 @@ extern int obey_regdecls;
 
 extern int quiet_flag;
 
+/* Report the time and memory spent in each pass, even with -quiet.
+   -ftime-report.  */
+
+extern int flag_time_report;
+
 /* Don't print warning messages.  -w.  */
 
 extern int inhibit_warnings;
@@ -449,6 +454,15 @@ extern int flag_stack_check;
 
 /* Do the full regmove optimization pass.  */
 extern int flag_regmove;
+
+/* Lay out basic blocks using the execution counts of -fbranch-probabilities.  */
+extern int flag_reorder_blocks;
+
+/* Software pipeline innermost loops.  */
+extern int flag_modulo_sched;
+
+/* Do loops over arrays of small integers a word of elements at a time.  */
+extern int flag_vectorize;
 
 /* Other basic status info about current function.  */
 
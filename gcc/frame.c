@@ -97,6 +97,39 @@ typedef struct dwarf_fde fde;
 
 static struct object *objects;
 
+/* An index of the objects by the range of PCs they cover, sorted by the
+   start of the range, so that find_fde need not walk the whole list on
+   every throw.  MAX_END is the largest end of the range of this entry
+   and all the ones before it, which lets a search step back over
+   overlapping ranges; ORDER is the position of the object in `objects',
+   which decides between objects that cover the same PC.  The index is
+   rebuilt on the first search after an object is registered or
+   deregistered, and like the list it is only used with object_mutex
+   held.  */
+
+struct object_range {
+  void *pc_begin;
+  void *pc_end;
+  void *max_end;
+  size_t order;
+  struct object *ob;
+};
+
+static struct object_range *object_index;
+static size_t object_index_count;
+static int object_index_valid;
+
+/* The COUNT of an object whose range of PCs build_object_index has found
+   and stored in it, but whose FDEs have not been sorted yet.  struct
+   object is allocated by crtbegin.o and collect2, so it has no room for
+   a flag of its own.  */
+
+#define FDES_UNSORTED ((size_t) -1)
+
+/* Nonzero if frame_init has sorted the FDEs of OB into its FDE_ARRAY.  */
+
+#define FDES_SORTED_P(OB) ((OB)->pc_begin != 0 && (OB)->count != FDES_UNSORTED)
+
 /* The information we care about from a CIE.  */
 
 struct cie_info {
@@ -420,6 +453,32 @@ add_fdes (fde *this_fde, fde_accumulator *accu, void **beg_ptr, void **end_ptr)
   *end_ptr = pc_end;
 }
 
+/* Widen *BEG_PTR and *END_PTR to cover the PCs of the FDEs starting at
+   THIS_FDE.  This is add_fdes without the sorting, for objects we have
+   not needed to look into yet.  */
+
+static void
+fde_range (fde *this_fde, void **beg_ptr, void **end_ptr)
+{
+  void *pc_begin = *beg_ptr;
+  void *pc_end = *end_ptr;
+
+  for (; this_fde->length != 0; this_fde = next_fde (this_fde))
+    {
+      /* Skip CIEs and linked once FDE entries.  */
+      if (this_fde->CIE_delta == 0 || this_fde->pc_begin == 0)
+	continue;
+
+      if (this_fde->pc_begin < pc_begin)
+	pc_begin = this_fde->pc_begin;
+      if (this_fde->pc_begin + this_fde->pc_range > pc_end)
+	pc_end = this_fde->pc_begin + this_fde->pc_range;
+    }
+
+  *beg_ptr = pc_begin;
+  *end_ptr = pc_end;
+}
+
 /* Set up a sorted array of pointers to FDEs for a loaded object.  We
    count up the entries before allocating the array because it's likely to
    be faster.  */
@@ -460,6 +519,134 @@ frame_init (struct object* ob)
   ob->pc_end = pc_end;
 }
 
+/* Rebuild object_index from the list of objects.  Objects that have not
+   been searched yet are only scanned for their range, once, and the
+   range is kept in the object for later rebuilds; their FDEs are sorted
+   when a PC first falls inside them.  If we run out of memory, leave the
+   index invalid and let find_fde walk the list.  */
+
+static void
+build_object_index (void)
+{
+  struct object *ob;
+  struct object_range *r;
+  size_t count, i, j;
+
+  if (object_index)
+    free (object_index);
+  object_index = 0;
+  object_index_count = 0;
+
+  for (count = 0, ob = objects; ob; ob = ob->next)
+    ++count;
+
+  if (count == 0)
+    {
+      object_index_valid = 1;
+      return;
+    }
+
+  object_index = (struct object_range *) malloc (sizeof (*r) * count);
+  if (object_index == 0)
+    return;
+
+  for (count = 0, ob = objects; ob; ob = ob->next)
+    {
+      void *pc_begin, *pc_end;
+
+      if (ob->pc_begin == 0)
+	{
+	  pc_begin = (void*)(uaddr)-1;
+	  pc_end = 0;
+	  if (ob->fde_array)
+	    {
+	      fde **p = ob->fde_array;
+	      for (; *p; ++p)
+		fde_range (*p, &pc_begin, &pc_end);
+	    }
+	  else
+	    fde_range (ob->fde_begin, &pc_begin, &pc_end);
+
+	  ob->pc_begin = pc_begin;
+	  ob->pc_end = pc_end;
+	  ob->count = FDES_UNSORTED;
+	}
+
+      pc_begin = ob->pc_begin;
+      pc_end = ob->pc_end;
+
+      /* An object with no FDEs can never match.  */
+      if (pc_begin >= pc_end)
+	{
+	  ++count;
+	  continue;
+	}
+
+      /* Insertion sort by the start of the range.  There are seldom many
+	 objects, and they are usually registered in address order one way
+	 or the other.  */
+      for (j = object_index_count;
+	   j > 0 && object_index[j - 1].pc_begin > pc_begin;
+	   --j)
+	object_index[j] = object_index[j - 1];
+
+      r = &object_index[j];
+      r->pc_begin = pc_begin;
+      r->pc_end = pc_end;
+      r->order = count++;
+      r->ob = ob;
+      ++object_index_count;
+    }
+
+  for (i = 0; i < object_index_count; ++i)
+    {
+      r = &object_index[i];
+      r->max_end = r->pc_end;
+      if (i > 0 && r[-1].max_end > r->max_end)
+	r->max_end = r[-1].max_end;
+    }
+
+  object_index_valid = 1;
+}
+
+/* Return the object that covers PC, preferring the one nearest the head
+   of `objects' if several do, as a walk of the list would.  */
+
+static struct object *
+search_object_index (void *pc)
+{
+  struct object *ob = 0;
+  size_t order = 0;
+  size_t lo, hi;
+
+  /* Find the first entry that starts above PC.  */
+  for (lo = 0, hi = object_index_count; lo < hi; )
+    {
+      size_t i = (lo + hi) / 2;
+
+      if (pc < object_index[i].pc_begin)
+	hi = i;
+      else
+	lo = i + 1;
+    }
+
+  /* All the entries before it start at or below PC.  Look back through
+     them for ones that also end above it; MAX_END tells us when there
+     can be no more.  */
+  while (lo > 0 && pc < object_index[lo - 1].max_end)
+    {
+      struct object_range *r = &object_index[--lo];
+
+      if (pc < r->pc_end && (ob == 0 || r->order < order))
+	{
+	  ob = r->ob;
+	  order = r->order;
+	}
+    }
+
+  return ob;
+}
+
 /* Return a pointer to the FDE for the function containing PC.  */
 
 static fde *
@@ -470,13 +657,23 @@ find_fde (void *pc)
 
   __gthread_mutex_lock (&object_mutex);
 
-  for (ob = objects; ob; ob = ob->next)
+  if (! object_index_valid)
+    build_object_index ();
+
+  if (object_index_valid)
     {
-      if (ob->pc_begin == 0)
+      ob = search_object_index (pc);
+      if (ob && ! FDES_SORTED_P (ob))
 	frame_init (ob);
-      if (pc >= ob->pc_begin && pc < ob->pc_end)
-	break;
     }
+  else
+    for (ob = objects; ob; ob = ob->next)
+      {
+	if (! FDES_SORTED_P (ob))
+	  frame_init (ob);
+	if (pc >= ob->pc_begin && pc < ob->pc_end)
+	  break;
+      }
 
   __gthread_mutex_unlock (&object_mutex);
 
@@ -689,6 +886,7 @@ __register_frame_info (void *begin, struct object *ob)
 
   ob->next = objects;
   objects = ob;
+  object_index_valid = 0;
 
   __gthread_mutex_unlock (&object_mutex);
 }
@@ -717,6 +915,7 @@ __register_frame_info_table (void *begin, struct object *ob)
 
   ob->next = objects;
   objects = ob;
+  object_index_valid = 0;
 
   __gthread_mutex_unlock (&object_mutex);
 }
@@ -744,9 +943,10 @@ __deregister_frame_info (void *begin)
 	{
 	  struct object *ob = *p;
 	  *p = (*p)->next;
+	  object_index_valid = 0;
 
 	  /* If we've run init_frame for this object, free the FDE array.  */
-	  if (ob->pc_begin)
+	  if (FDES_SORTED_P (ob))
 	    free (ob->fde_array);
 
 	  __gthread_mutex_unlock (&object_mutex);
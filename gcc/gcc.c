@@ -41,6 +41,9 @@ compilation is specified by a string called a "spec".  */
 #include "system.h"
 #include <signal.h>
 #include <sys/stat.h>
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
 
 #include "gansidecl.h"
 #include "obstack.h"
@@ -79,6 +82,11 @@ extern void set_std_prefix PROTO((char *, int));
 #define vfork fork
 #endif /* USG */
 
+/* -j compiles the input files in forked copies of the driver.  */
+#if defined (__MSDOS__) || (defined (_WIN32) && ! defined (__CYGWIN32__)) || defined (OS2) || defined (VMS)
+#define NO_PARALLEL_COMPILES
+#endif
+
 /* Test if something is a normal file.  */
 #ifndef S_ISREG
 #define S_ISREG(m) (((m) & S_IFMT) == S_IFREG)
@@ -247,6 +255,16 @@ static void pfatal_pexecute	PROTO((char *, char *));
 static void fatal		PVPROTO((char *, ...));
 static void error		PVPROTO((char *, ...));
 static void display_help 	PROTO((void));
+static int compile_input_file	PROTO((int));
+#ifndef NO_PARALLEL_COMPILES
+struct job;
+static void start_job		PROTO((struct job *, int));
+static void write_job_report	PROTO((FILE *, int));
+static char *read_job_file	PROTO((FILE *, int *));
+static void finish_job		PROTO((struct job *, int, int));
+static void report_job		PROTO((struct job *));
+static void compile_in_parallel	PROTO((void));
+#endif
 
 void fancy_abort ();
 char *xmalloc ();
@@ -563,7 +581,8 @@ static struct user_specs *user_specs_head, *user_specs_tail;
   || !strcmp (STR, "imacros") || !strcmp (STR, "aux-info") \
   || !strcmp (STR, "idirafter") || !strcmp (STR, "iprefix") \
   || !strcmp (STR, "iwithprefix") || !strcmp (STR, "iwithprefixbefore") \
-  || !strcmp (STR, "isystem") || !strcmp (STR, "specs"))
+  || !strcmp (STR, "isystem") || !strcmp (STR, "iheadercache") \
+  || !strcmp (STR, "specs"))
 
 #ifndef WORD_SWITCH_TAKES_ARG
 #define WORD_SWITCH_TAKES_ARG(STR) DEFAULT_WORD_SWITCH_TAKES_ARG (STR)
@@ -2377,6 +2396,14 @@ static int added_libraries;
 
 static char **outfiles;
 
+/* Nonzero for each input file that goes straight to the linker.  */
+
+static char *explicit_link_files;
+
+/* Maximum number of input files to compile at once, set by -j.  */
+
+static int parallel_jobs = 1;
+
 /* Used to track if none of the -B paths are used.  */
 static int warn_B;
 
@@ -2461,6 +2488,7 @@ display_help ()
   printf ("  -Xlinker <arg>           Pass <arg> on to the linker\n");
   printf ("  -save-temps              Do not delete intermediate files\n");
   printf ("  -pipe                    Use pipes rather than intermediate files\n");
+  printf ("  -j <number>              Compile up to <number> input files at once\n");
   printf ("  -specs=<file>            Override builtin specs with the contents of <file>\n");
   printf ("  -B <directory>           Add <directory> to the compiler's search paths\n");
   printf ("  -b <machine>             Run gcc for target <machine>, if installed\n");
@@ -2843,6 +2871,25 @@ process_command (argc, argv)
 	    user_specs_head = user;
 	  user_specs_tail = user;
 	}
+      else if (argv[i][0] == '-' && argv[i][1] == 'j'
+	       && (argv[i][2] == 0 || ISDIGIT (argv[i][2])))
+	{
+	  char *value = argv[i] + 2;
+
+	  if (*value == 0)
+	    {
+	      if (++i >= argc)
+		fatal ("argument to `-j' is missing");
+	      value = argv[i];
+	    }
+	  parallel_jobs = atoi (value);
+	  if (parallel_jobs < 1)
+	    fatal ("argument to `-j' must be a positive number");
+#ifdef NO_PARALLEL_COMPILES
+	  error ("Warning: -j not supported on this system");
+	  parallel_jobs = 1;
+#endif
+	}
       else if (argv[i][0] == '-' && argv[i][1] != 0)
 	{
 	  register char *p = &argv[i][1];
@@ -3185,6 +3232,12 @@ process_command (argc, argv)
 	i++;
       else if (strncmp (argv[i], "-specs=", 7) == 0)
 	;
+      else if (argv[i][0] == '-' && argv[i][1] == 'j'
+	       && (argv[i][2] == 0 || ISDIGIT (argv[i][2])))
+	{
+	  if (argv[i][2] == 0)
+	    i++;
+	}
       /* -save-temps overrides -pipe, so that temp files are produced */
       else if (save_temps_flag && strcmp (argv[i], "-pipe") == 0)
 	error ("Warning: -pipe ignored since -save-temps specified");
@@ -4611,10 +4664,8 @@ main (argc, argv)
      char **argv;
 {
   register size_t i;
-  size_t j;
   int value;
   int linker_was_run = 0;
-  char *explicit_link_files;
   char *specs_file;
   char *p;
   struct user_specs *uptr;
@@ -4983,93 +5034,24 @@ main (argc, argv)
   explicit_link_files = xmalloc (n_infiles);
   bzero (explicit_link_files, n_infiles);
 
-  for (i = 0; i < n_infiles; i++)
-    {
-      register struct compiler *cp = 0;
-      int this_file_error = 0;
-
-      /* Tell do_spec what to substitute for %i.  */
-
-      input_filename = infiles[i].name;
-      input_filename_length = strlen (input_filename);
-      input_file_number = i;
-
-      /* Use the same thing in %o, unless cp->spec says otherwise.  */
-
-      outfiles[i] = input_filename;
-
-      /* Figure out which compiler from the file's suffix.  */
-
-      cp = lookup_compiler (infiles[i].name, input_filename_length,
-			    infiles[i].language);
-
-      if (cp)
-	{
-	  /* Ok, we found an applicable compiler.  Run its spec.  */
-	  /* First say how much of input_filename to substitute for %b  */
-	  register char *p;
-	  int len;
-
-	  if (cp->spec[0][0] == '#')
-	    error ("%s: %s compiler not installed on this system",
-		   input_filename, &cp->spec[0][1]);
-
-	  input_basename = input_filename;
-	  for (p = input_filename; *p; p++)
-	    if (*p == '/' || *p == DIR_SEPARATOR)
-	      input_basename = p + 1;
-
-	  /* Find a suffix starting with the last period,
-	     and set basename_length to exclude that suffix.  */
-	  basename_length = strlen (input_basename);
-	  p = input_basename + basename_length;
-	  while (p != input_basename && *p != '.') --p;
-	  if (*p == '.' && p != input_basename)
-	    {
-	      basename_length = p - input_basename;
-	      input_suffix = p + 1;
-	    }
-	  else
-	    input_suffix = "";
-
-	  len = 0;
-	  for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
-	    if (cp->spec[j])
-	      len += strlen (cp->spec[j]);
-
-	  p = (char *) xmalloc (len + 1);
-
-	  len = 0;
-	  for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
-	    if (cp->spec[j])
-	      {
-		strcpy (p + len, cp->spec[j]);
-		len += strlen (cp->spec[j]);
-	      }
-
-	  value = do_spec (p);
-	  free (p);
-	  if (value < 0)
-	    this_file_error = 1;
-	}
-
-      /* If this file's name does not contain a recognized suffix,
-	 record it as explicit linker input.  */
-
-      else
-	explicit_link_files[i] = 1;
-
-      /* Clear the delete-on-failure queue, deleting the files in it
-	 if this compilation failed.  */
+#ifndef NO_PARALLEL_COMPILES
+  if (parallel_jobs > 1 && n_infiles > 1)
+    compile_in_parallel ();
+  else
+#endif
+    for (i = 0; i < n_infiles; i++)
+      {
+	/* Clear the delete-on-failure queue, deleting the files in it
+	   if this compilation failed.  */
 
-      if (this_file_error)
-	{
-	  delete_failure_queue ();
-	  error_count++;
-	}
-      /* If this compilation succeeded, don't delete those files later.  */
-      clear_failure_queue ();
-    }
+	if (compile_input_file (i))
+	  {
+	    delete_failure_queue ();
+	    error_count++;
+	  }
+	/* If this compilation succeeded, don't delete those files later.  */
+	clear_failure_queue ();
+      }
 
 #ifdef LANG_SPECIFIC_DRIVER
   if (error_count == 0
@@ -5131,6 +5113,333 @@ main (argc, argv)
   return 0;
 }
 
+/* Run the compiler for input file I, as the spec for its language says.
+   If no compiler applies to the file, mark it as linker input instead.
+   Return nonzero if the compilation failed.  */
+
+static int
+compile_input_file (i)
+     int i;
+{
+  register struct compiler *cp = 0;
+  int this_file_error = 0;
+  size_t j;
+  int value;
+
+  /* Tell do_spec what to substitute for %i.  */
+
+  input_filename = infiles[i].name;
+  input_filename_length = strlen (input_filename);
+  input_file_number = i;
+
+  /* Use the same thing in %o, unless cp->spec says otherwise.  */
+
+  outfiles[i] = input_filename;
+
+  /* Figure out which compiler from the file's suffix.  */
+
+  cp = lookup_compiler (infiles[i].name, input_filename_length,
+			infiles[i].language);
+
+  if (cp)
+    {
+      /* Ok, we found an applicable compiler.  Run its spec.  */
+      /* First say how much of input_filename to substitute for %b  */
+      register char *p;
+      int len;
+
+      if (cp->spec[0][0] == '#')
+	error ("%s: %s compiler not installed on this system",
+	       input_filename, &cp->spec[0][1]);
+
+      input_basename = input_filename;
+      for (p = input_filename; *p; p++)
+	if (*p == '/' || *p == DIR_SEPARATOR)
+	  input_basename = p + 1;
+
+      /* Find a suffix starting with the last period,
+	 and set basename_length to exclude that suffix.  */
+      basename_length = strlen (input_basename);
+      p = input_basename + basename_length;
+      while (p != input_basename && *p != '.') --p;
+      if (*p == '.' && p != input_basename)
+	{
+	  basename_length = p - input_basename;
+	  input_suffix = p + 1;
+	}
+      else
+	input_suffix = "";
+
+      len = 0;
+      for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
+	if (cp->spec[j])
+	  len += strlen (cp->spec[j]);
+
+      p = (char *) xmalloc (len + 1);
+
+      len = 0;
+      for (j = 0; j < sizeof cp->spec / sizeof cp->spec[0]; j++)
+	if (cp->spec[j])
+	  {
+	    strcpy (p + len, cp->spec[j]);
+	    len += strlen (cp->spec[j]);
+	  }
+
+      value = do_spec (p);
+      free (p);
+      if (value < 0)
+	this_file_error = 1;
+    }
+
+  /* If this file's name does not contain a recognized suffix,
+     record it as explicit linker input.  */
+
+  else
+    explicit_link_files[i] = 1;
+
+  return this_file_error;
+}
+
+#ifndef NO_PARALLEL_COMPILES
+
+/* Under -j, each input file that needs compiling is handled by a forked
+   copy of the driver, so that the temporary file names chosen by do_spec
+   stay private to that file.  Its standard output and standard error go
+   to temporary files, which are copied out in the order of the input
+   files.  It also writes a report naming its output file and the
+   temporary files it made, which the parent needs for linking and for
+   cleaning up.  */
+
+struct job
+{
+  int pid;			/* Process compiling the file, or 0.  */
+  int status;			/* Its exit status, once it is done.  */
+  FILE *output;			/* Receives its standard output.  */
+  FILE *errors;			/* Receives its standard error.  */
+  FILE *report;			/* Receives its report.  */
+  char *output_text;		/* Contents of OUTPUT, once it is done.  */
+  int output_length;
+  char *errors_text;		/* Contents of ERRORS, once it is done.  */
+  int errors_length;
+};
+
+/* Start a copy of the driver that compiles input file I for JOB.  */
+
+static void
+start_job (job, i)
+     struct job *job;
+     int i;
+{
+  job->output = tmpfile ();
+  job->errors = tmpfile ();
+  job->report = tmpfile ();
+  if (job->output == 0 || job->errors == 0 || job->report == 0)
+    pfatal_with_name ("tmpfile");
+
+  /* Don't let the child inherit anything still buffered.  */
+  fflush (stdout);
+  fflush (stderr);
+
+  job->pid = fork ();
+  if (job->pid < 0)
+    pfatal_with_name ("fork");
+  if (job->pid > 0)
+    return;
+
+  /* The child starts without any temporary files, so that a fatal error
+     in it does not delete the output of other input files.  */
+  always_delete_queue = 0;
+  failure_delete_queue = 0;
+
+  dup2 (fileno (job->output), 1);
+  dup2 (fileno (job->errors), 2);
+
+  if (compile_input_file (i))
+    {
+      delete_failure_queue ();
+      error_count++;
+    }
+  clear_failure_queue ();
+
+  write_job_report (job->report, i);
+  exit (error_count > 0 ? (signal_count ? 2 : 1) : 0);
+}
+
+/* Write to REPORT the output file of input file I, the temporary files
+   to delete at the end of the run, and whether any file was found with
+   the -B prefixes or the standard prefixes.  */
+
+static void
+write_job_report (report, i)
+     FILE *report;
+     int i;
+{
+  struct temp_file *temp;
+
+  fprintf (report, "o %s\n", outfiles[i]);
+  for (temp = always_delete_queue; temp; temp = temp->next)
+    fprintf (report, "t %s\n", temp->name);
+  fprintf (report, "w %d %d\n", warn_B, warn_std);
+}
+
+/* Read all that a job wrote to FILE, and close it.
+   Store the length in *LENGTHP.  */
+
+static char *
+read_job_file (file, lengthp)
+     FILE *file;
+     int *lengthp;
+{
+  struct stat statbuf;
+  char *buffer;
+  int length;
+
+  if (fstat (fileno (file), &statbuf) < 0)
+    pfatal_with_name ("tmpfile");
+
+  buffer = xmalloc ((unsigned) statbuf.st_size + 1);
+  rewind (file);
+  length = fread (buffer, 1, statbuf.st_size, file);
+  buffer[length] = 0;
+  fclose (file);
+
+  *lengthp = length;
+  return buffer;
+}
+
+/* JOB, which compiled input file I, has exited with STATUS.
+   Take in its report and save its output until it is its turn.  */
+
+static void
+finish_job (job, i, status)
+     struct job *job;
+     int i;
+     int status;
+{
+  int length;
+  char *p, *end;
+
+  job->pid = 0;
+  job->status = status;
+  job->output_text = read_job_file (job->output, &job->output_length);
+  job->errors_text = read_job_file (job->errors, &job->errors_length);
+
+  p = read_job_file (job->report, &length);
+  end = p + length;
+  while (p < end)
+    {
+      char *line = p;
+      int used_B, used_std;
+
+      while (p < end && *p != '\n')
+	p++;
+      *p++ = 0;
+
+      if (line[0] == 'o')
+	outfiles[i] = line + 2;
+      else if (line[0] == 't')
+	record_temp_file (line + 2, 1, 0);
+      else if (line[0] == 'w'
+	       && sscanf (line + 2, "%d %d", &used_B, &used_std) == 2)
+	{
+	  warn_B |= used_B;
+	  warn_std |= used_std;
+	}
+    }
+}
+
+/* Copy out what JOB printed, and count its failure if it failed.  */
+
+static void
+report_job (job)
+     struct job *job;
+{
+  if (job->output_text)
+    {
+      fwrite (job->output_text, 1, job->output_length, stdout);
+      fflush (stdout);
+      free (job->output_text);
+    }
+  if (job->errors_text)
+    {
+      fwrite (job->errors_text, 1, job->errors_length, stderr);
+      fflush (stderr);
+      free (job->errors_text);
+    }
+
+  if (job->status != 0)
+    {
+      error_count++;
+      /* The child exits with 2 if a subprocess got a signal, as we do.  */
+      if (! WIFEXITED (job->status) || WEXITSTATUS (job->status) == 2)
+	signal_count++;
+    }
+}
+
+/* Compile all the input files, running up to PARALLEL_JOBS compilations
+   at once.  Diagnostics come out in the order of the input files, as
+   they do without -j.  */
+
+static void
+compile_in_parallel ()
+{
+  struct job *jobs;
+  int next = 0;			/* The next input file to start.  */
+  int done = 0;			/* The number of input files reported.  */
+  int running = 0;		/* The number of jobs in progress.  */
+
+  jobs = (struct job *) xmalloc (n_infiles * sizeof (struct job));
+  bzero ((char *) jobs, n_infiles * sizeof (struct job));
+
+  while (1)
+    {
+      int i, pid, status;
+
+      /* Start more jobs while there is room.  Files that go straight
+	 to the linker need none.  */
+      while (next < n_infiles && running < parallel_jobs)
+	{
+	  outfiles[next] = infiles[next].name;
+	  if (lookup_compiler (infiles[next].name,
+			       strlen (infiles[next].name),
+			       infiles[next].language) == 0)
+	    explicit_link_files[next] = 1;
+	  else
+	    {
+	      start_job (&jobs[next], next);
+	      running++;
+	    }
+	  next++;
+	}
+
+      /* Report the finished files that are next in order.  */
+      while (done < next && jobs[done].pid == 0)
+	report_job (&jobs[done++]);
+
+      if (done == n_infiles)
+	break;
+
+      /* Wait for a job to finish.  Ignore subprocesses that we don't
+	 know about, since they can be spawned by the process that
+	 exec'ed us.  */
+      pid = wait (&status);
+      if (pid < 0)
+	pfatal_with_name ("wait");
+
+      for (i = done; i < next; i++)
+	if (jobs[i].pid == pid)
+	  {
+	    finish_job (&jobs[i], i, status);
+	    running--;
+	    break;
+	  }
+    }
+
+  free (jobs);
+}
+
+#endif /* ! NO_PARALLEL_COMPILES */
+
 /* Find the proper compilation spec for the file name NAME,
    whose length is LENGTH.  LANGUAGE is the specified language,
    or 0 if this file is to be passed to the linker.  */
@@ -121,15 +121,35 @@ static INT_TYPE *conflicts;
 
 static int allocno_row_words;
 
-/* Two macros to test or store 1 in an element of `conflicts'.  */
+/* The largest size in bytes we allow for `conflicts'.  A function with
+   more allocnos than that allows uses `conflict_bitmaps' instead.  */
 
-#define CONFLICTP(I, J) \
+#ifndef MAX_CONFLICT_MATRIX_SIZE
+#define MAX_CONFLICT_MATRIX_SIZE (1024 * 1024)
+#endif
+
+/* If nonzero, a vector of max_allocno sparse bitmaps used in place of
+   `conflicts'.  Element I has bit J set if allocno's I and J conflict;
+   unlike in `conflicts', each conflict is recorded both ways.  */
+
+static bitmap_head *conflict_bitmaps;
+
+/* Test a bit of the matrix `conflicts'.  */
+
+#define MATRIX_CONFLICTP(I, J) \
  (conflicts[(I) * allocno_row_words + (J) / INT_BITS]	\
   & ((INT_TYPE) 1 << ((J) % INT_BITS)))
 
-#define SET_CONFLICT(I, J) \
- (conflicts[(I) * allocno_row_words + (J) / INT_BITS]	\
-  |= ((INT_TYPE) 1 << ((J) % INT_BITS)))
+/* Nonzero if allocno's I and J conflict.  */
+
+#define CONFLICTP(I, J)						\
+ (conflict_bitmaps != 0						\
+  ? bitmap_bit_p (&conflict_bitmaps[I], J)			\
+  : (MATRIX_CONFLICTP (I, J) || MATRIX_CONFLICTP (J, I)))
+
+/* Vector of max_allocno elements filled in by `allocno_conflicts'.  */
+
+static int *conflicting_allocnos;
 
 /* Set of hard regs currently live (during scan of all insns).  */
 
@@ -261,6 +281,8 @@ static void prune_preferences	PROTO((void));
 static void find_reg		PROTO((int, HARD_REG_SET, int, int, int));
 static void record_one_conflict PROTO((int));
 static void record_conflicts	PROTO((short *, int));
+static void record_allocno_conflicts PROTO((int));
+static int allocno_conflicts	PROTO((int));
 static void mark_reg_store	PROTO((rtx, rtx));
 static void mark_reg_clobber	PROTO((rtx, rtx));
 static void mark_reg_conflicts	PROTO((rtx));
@@ -490,13 +512,32 @@ global_alloc (file)
 
   allocno_row_words = (max_allocno + INT_BITS - 1) / INT_BITS;
 
-  /* We used to use alloca here, but the size of what it would try to
-     allocate would occasionally cause it to exceed the stack limit and
-     cause unpredictable core dumps.  Some examples were > 2Mb in size.  */
-  conflicts = (INT_TYPE *) xmalloc (max_allocno * allocno_row_words
-				    * sizeof (INT_TYPE));
-  bzero ((char *) conflicts,
-	 max_allocno * allocno_row_words * sizeof (INT_TYPE));
+  /* The matrix grows as the square of the number of allocnos, while few
+     pairs of them usually conflict.  So past a certain size, keep a
+     sparse bitmap for each allocno instead.  */
+  conflicts = 0;
+  conflict_bitmaps = 0;
+  if (max_allocno > 0
+      && max_allocno > (MAX_CONFLICT_MATRIX_SIZE
+			/ (allocno_row_words * sizeof (INT_TYPE))))
+    {
+      conflict_bitmaps
+	= (bitmap_head *) xmalloc (max_allocno * sizeof (bitmap_head));
+      for (i = 0; i < max_allocno; i++)
+	bitmap_initialize (&conflict_bitmaps[i]);
+    }
+  else
+    {
+      /* We used to use alloca here, but the size of what it would try to
+	 allocate would occasionally cause it to exceed the stack limit and
+	 cause unpredictable core dumps.  Some examples were > 2Mb in
+	 size.  */
+      conflicts = (INT_TYPE *) xmalloc (max_allocno * allocno_row_words
+					* sizeof (INT_TYPE));
+      bzero ((char *) conflicts,
+	     max_allocno * allocno_row_words * sizeof (INT_TYPE));
+    }
+  conflicting_allocnos = (int *) xmalloc (max_allocno * sizeof (int));
 
   allocnos_live = (INT_TYPE *) alloca (allocno_row_words * sizeof (INT_TYPE));
 
@@ -586,7 +627,16 @@ global_alloc (file)
 #endif
     retval = reload (get_insns (), 1, file);
 
-  free (conflicts);
+  if (conflict_bitmaps)
+    {
+      for (i = 0; i < max_allocno; i++)
+	bitmap_clear (&conflict_bitmaps[i]);
+      free (conflict_bitmaps);
+      conflict_bitmaps = 0;
+    }
+  else
+    free (conflicts);
+  free (conflicting_allocnos);
   return retval;
 }
 
@@ -804,9 +854,7 @@ expand_preferences ()
 	    && GET_CODE (XEXP (link, 0)) == REG
 	    && reg_allocno[REGNO (XEXP (link, 0))] >= 0
 	    && ! CONFLICTP (reg_allocno[REGNO (SET_DEST (set))],
-			    reg_allocno[REGNO (XEXP (link, 0))])
-	    && ! CONFLICTP (reg_allocno[REGNO (XEXP (link, 0))],
-			    reg_allocno[REGNO (SET_DEST (set))]))
+			    reg_allocno[REGNO (XEXP (link, 0))]))
 	  {
 	    int a1 = reg_allocno[REGNO (SET_DEST (set))];
 	    int a2 = reg_allocno[REGNO (XEXP (link, 0))];
@@ -840,8 +888,13 @@ expand_preferences ()
 static void
 prune_preferences ()
 {
-  int i, j;
+  int i, j, k;
   int allocno;
+  int n_conflicts;
+  int *allocno_position = (int *) alloca (max_allocno * sizeof (int));
+
+  for (i = 0; i < max_allocno; i++)
+    allocno_position[allocno_order[i]] = i;
   
   /* Scan least most important to most important.
      For each allocno, remove from preferences registers that cannot be used,
@@ -875,18 +928,20 @@ prune_preferences ()
 	 don't exclude them unless we are of a smaller size (in which case
 	 we want to give the lower-priority allocno the first chance for
 	 these registers).  */
-      for (j = i + 1; j < max_allocno; j++)
-	if (CONFLICTP (allocno, allocno_order[j])
-	    || CONFLICTP (allocno_order[j], allocno))
-	  {
-	    COPY_HARD_REG_SET (temp,
-			       hard_reg_full_preferences[allocno_order[j]]);
-	    if (allocno_size[allocno_order[j]] <= allocno_size[allocno])
-	      AND_COMPL_HARD_REG_SET (temp,
-				      hard_reg_full_preferences[allocno]);
-			       
-	    IOR_HARD_REG_SET (regs_someone_prefers[allocno], temp);
-	  }
+      n_conflicts = allocno_conflicts (allocno);
+      for (k = 0; k < n_conflicts; k++)
+	{
+	  j = conflicting_allocnos[k];
+	  if (allocno_position[j] > i)
+	    {
+	      COPY_HARD_REG_SET (temp, hard_reg_full_preferences[j]);
+	      if (allocno_size[j] <= allocno_size[allocno])
+		AND_COMPL_HARD_REG_SET (temp,
+					hard_reg_full_preferences[allocno]);
+
+	      IOR_HARD_REG_SET (regs_someone_prefers[allocno], temp);
+	    }
+	}
     }
 }
 
@@ -1198,12 +1253,10 @@ find_reg (allocno, losers, alt_regs_p, accept_call_clobbered, retrying)
 	}
       /* For each other pseudo-reg conflicting with this one,
 	 mark it as conflicting with the hard regs this one occupies.  */
-      lim = allocno;
-      for (j = 0; j < max_allocno; j++)
-	if (CONFLICTP (lim, j) || CONFLICTP (j, lim))
-	  {
-	    IOR_HARD_REG_SET (hard_reg_conflicts[j], this_reg);
-	  }
+      lim = allocno_conflicts (allocno);
+      for (j = 0; j < lim; j++)
+	IOR_HARD_REG_SET (hard_reg_conflicts[conflicting_allocnos[j]],
+			  this_reg);
     }
 }
 
@@ -1267,21 +1320,8 @@ record_one_conflict (regno)
        then with other pseudo regs.  */
     {
       register int ialloc = reg_allocno[regno];
-      register int ialloc_prod = ialloc * allocno_row_words;
       IOR_HARD_REG_SET (hard_reg_conflicts[ialloc], hard_regs_live);
-      for (j = allocno_row_words - 1; j >= 0; j--)
-	{
-#if 0
-	  int k;
-	  for (k = 0; k < n_no_conflict_pairs; k++)
-	    if (! ((j == no_conflict_pairs[k].allocno1
-		    && ialloc == no_conflict_pairs[k].allocno2)
-		   ||
-		   (j == no_conflict_pairs[k].allocno2
-		    && ialloc == no_conflict_pairs[k].allocno1)))
-#endif /* 0 */
-	      conflicts[ialloc_prod + j] |= allocnos_live[j];
-	}
+      record_allocno_conflicts (ialloc);
     }
 }
 
@@ -1296,16 +1336,64 @@ record_conflicts (allocno_vec, len)
      register int len;
 {
   register int allocno;
-  register int j;
-  register int ialloc_prod;
 
   while (--len >= 0)
     {
       allocno = allocno_vec[len];
-      ialloc_prod = allocno * allocno_row_words;
       IOR_HARD_REG_SET (hard_reg_conflicts[allocno], hard_regs_live);
-      for (j = allocno_row_words - 1; j >= 0; j--)
-	conflicts[ialloc_prod + j] |= allocnos_live[j];
+      record_allocno_conflicts (allocno);
+    }
+}
+
+/* Store in `conflicting_allocnos' the allocnos that conflict with
+   allocno ALLOCNO, in increasing order.  Return how many there are.  */
+
+static int
+allocno_conflicts (allocno)
+     int allocno;
+{
+  register int j;
+  register int n = 0;
+
+  if (conflict_bitmaps)
+    EXECUTE_IF_SET_IN_BITMAP (&conflict_bitmaps[allocno], 0, j,
+			      conflicting_allocnos[n++] = j);
+  else
+    for (j = 0; j < max_allocno; j++)
+      if (MATRIX_CONFLICTP (allocno, j) || MATRIX_CONFLICTP (j, allocno))
+	conflicting_allocnos[n++] = j;
+
+  return n;
+}
+
+/* Record that allocno IALLOC conflicts with all allocnos currently live.  */
+
+static void
+record_allocno_conflicts (ialloc)
+     int ialloc;
+{
+  register int i, j;
+
+  if (conflict_bitmaps)
+    {
+      for (i = 0; i < allocno_row_words; i++)
+	{
+	  unsigned INT_TYPE word = allocnos_live[i];
+
+	  for (j = i * INT_BITS; word != 0; word >>= 1, j++)
+	    if (word & 1)
+	      {
+		bitmap_set_bit (&conflict_bitmaps[ialloc], j);
+		bitmap_set_bit (&conflict_bitmaps[j], ialloc);
+	      }
+	}
+    }
+  else
+    {
+      register INT_TYPE *row = conflicts + ialloc * allocno_row_words;
+
+      for (i = allocno_row_words - 1; i >= 0; i--)
+	row[i] |= allocnos_live[i];
     }
 }
 
@@ -1678,10 +1766,10 @@ dump_conflicts (file)
   for (i = 0; i < max_allocno; i++)
     {
       register int j;
+      int n_conflicts = allocno_conflicts (i);
       fprintf (file, ";; %d conflicts:", allocno_reg[i]);
-      for (j = 0; j < max_allocno; j++)
-	if (CONFLICTP (i, j) || CONFLICTP (j, i))
-	  fprintf (file, " %d", allocno_reg[j]);
+      for (j = 0; j < n_conflicts; j++)
+	fprintf (file, " %d", allocno_reg[conflicting_allocnos[j]]);
       for (j = 0; j < FIRST_PSEUDO_REGISTER; j++)
 	if (TEST_HARD_REG_BIT (hard_reg_conflicts[i], j))
 	  fprintf (file, " %d", j);
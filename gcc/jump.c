@@ -3971,9 +3971,11 @@ invert_jump (jump, nlabel)
 	  /* An inverted jump means that a probability taken becomes a
 	     probability not taken.  Subtract the branch probability from the
 	     probability base to convert it back to a taken probability.
-	     (We don't flip the probability on a branch that's never taken.  */
-	  if (note && XINT (XEXP (note, 0), 0) >= 0)
-	    XINT (XEXP (note, 0), 0) = REG_BR_PROB_BASE - XINT (XEXP (note, 0), 0);
+	     (We don't flip the probability on a branch that's never taken.)
+	     Small CONST_INTs are shared, so make a new one.  */
+	  if (note && INTVAL (XEXP (note, 0)) >= 0)
+	    XEXP (note, 0) = GEN_INT (REG_BR_PROB_BASE
+				      - INTVAL (XEXP (note, 0)));
 	}
 
       return 1;
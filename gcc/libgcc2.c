@@ -294,8 +294,11 @@ __muldi3 (DItype u, DItype v)
   vv.ll = v;
 
   w.ll = __umulsidi3 (uu.s.low, vv.s.low);
-  w.s.high += ((USItype) uu.s.low * (USItype) vv.s.high
-	       + (USItype) uu.s.high * (USItype) vv.s.low);
+  /* The high words are often zero, and a test is cheaper than two
+     multiplications.  */
+  if (uu.s.high | vv.s.high)
+    w.s.high += ((USItype) uu.s.low * (USItype) vv.s.high
+		 + (USItype) uu.s.high * (USItype) vv.s.low);
 
   return w.ll;
 }
@@ -452,6 +455,61 @@ __udivmoddi4 (UDItype n, UDItype d, UDItype *rp)
   n0 = nn.s.low;
   n1 = nn.s.high;
 
+#ifdef udiv_qrnd
+  /* Quick cases for machines that divide a word by a word in one
+     instruction: D is a power of two, or N and D both fit in a word.  */
+  if (d1 == 0 && d0 != 0)
+    {
+      if ((d0 & (d0 - 1)) == 0)
+	{
+	  count_leading_zeros (bm, d0);
+	  b = SI_TYPE_SIZE - 1 - bm;
+
+	  if (rp != 0)
+	    {
+	      rr.s.low = n0 & (d0 - 1);
+	      rr.s.high = 0;
+	      *rp = rr.ll;
+	    }
+	  /* Shift by BM and 1 rather than by SI_TYPE_SIZE - B, which
+	     would be undefined for B == 0.  */
+	  ww.s.low = (n0 >> b) | (n1 << bm << 1);
+	  ww.s.high = n1 >> b;
+	  return ww.ll;
+	}
+
+      if (n1 == 0)
+	{
+	  udiv_qrnd (q0, n0, n0, d0);
+
+	  if (rp != 0)
+	    {
+	      rr.s.low = n0;
+	      rr.s.high = 0;
+	      *rp = rr.ll;
+	    }
+	  ww.s.low = q0;
+	  ww.s.high = 0;
+	  return ww.ll;
+	}
+    }
+  else if (d0 == 0 && d1 != 0 && (d1 & (d1 - 1)) == 0)
+    {
+      count_leading_zeros (bm, d1);
+      b = SI_TYPE_SIZE - 1 - bm;
+
+      if (rp != 0)
+	{
+	  rr.s.low = n0;
+	  rr.s.high = n1 & (d1 - 1);
+	  *rp = rr.ll;
+	}
+      ww.s.low = n1 >> b;
+      ww.s.high = 0;
+      return ww.ll;
+    }
+#endif
+
 #if !UDIV_NEEDS_NORMALIZATION
   if (d1 == 0)
     {
@@ -519,6 +577,19 @@ __udivmoddi4 (UDItype n, UDItype d, UDItype *rp)
 
 	  count_leading_zeros (bm, d0);
 
+#ifdef udiv_qrnd
+	  /* The high word of the quotient is a division of words, which
+	     leaves N1 < D0 as in the case above.  */
+
+	  udiv_qrnd (q1, n1, n1, d0);
+
+	  if (bm != 0)
+	    {
+	      d0 = d0 << bm;
+	      n1 = (n1 << bm) | (n0 >> (SI_TYPE_SIZE - bm));
+	      n0 = n0 << bm;
+	    }
+#else
 	  if (bm == 0)
 	    {
 	      /* From (n1 >= d0) /\ (the most significant bit of d0 is set),
@@ -544,6 +615,7 @@ __udivmoddi4 (UDItype n, UDItype d, UDItype *rp)
 
 	      udiv_qrnnd (q1, n1, n2, n1, d0);
 	    }
+#endif
 
 	  /* n1 != d0...  */
 
@@ -1451,6 +1523,15 @@ char *ctime ();
 #include "gbl-ctors.h"
 #include "gcov-io.h"
 #include <string.h>
+#ifdef TARGET_HAS_F_SETLKW
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+#endif
 
 static struct bb *bb_head;
 
@@ -1471,107 +1552,222 @@ static struct bb *bb_head;
   return ret;
 }
 
-void
-__bb_exit_func (void)
+#ifdef TARGET_HAS_F_SETLKW
+
+/* Add the counts of PTR to its .da file, or replace the file if it does
+   not hold the same number of counts.  The file is locked meanwhile, so
+   that processes which exit together do not lose each other's counts,
+   and updated in place through mmap.  */
+
+static void
+bb_merge_da_file (struct bb *ptr)
 {
-  FILE *da_file, *file;
-  long time_value;
-  int i;
+  size_t size = (ptr->ncounts + 1) * 8;
+  struct flock lock;
+  struct stat st;
+  char *da;
+  long n_counts;
+  int fd, i, merge, ret;
 
-  if (bb_head == 0)
-    return;
+  if ((fd = open (ptr->filename, O_RDWR | O_CREAT, 0666)) < 0)
+    {
+      fprintf (stderr, "arc profiling: Can't open output file %s.\n",
+	       ptr->filename);
+      return;
+    }
 
-  i = strlen (bb_head->filename) - 3;
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  lock.l_start = 0;
+  lock.l_len = 0;
+  while (fcntl (fd, F_SETLKW, &lock) < 0)
+    if (errno != EINTR)
+      {
+	fprintf (stderr, "arc profiling: Can't lock output file %s.\n",
+		 ptr->filename);
+	close (fd);
+	return;
+      }
+
+  merge = (fstat (fd, &st) == 0 && (size_t) st.st_size == size);
+  if (! merge && ftruncate (fd, size) != 0)
+    da = (char *) MAP_FAILED;
+  else
+    da = (char *) mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (da == (char *) MAP_FAILED)
+    {
+      fprintf (stderr, "arc profiling: Can't map output file %s.\n",
+	       ptr->filename);
+      close (fd);
+      return;
+    }
+
+  if (merge && (__fetch_long (&n_counts, da, 8) != 0
+		|| n_counts != ptr->ncounts))
+    merge = 0;
 
-  if (!strcmp (bb_head->filename+i, ".da"))
+  ret = __store_long (ptr->ncounts, da, 8);
+  for (i = 0; i < ptr->ncounts && ! ret; i++)
     {
-      /* Must be -fprofile-arcs not -a.
-	 Dump data in a form that gcov expects.  */
+      long v = 0;
 
-      struct bb *ptr;
+      if (merge && __fetch_long (&v, da + (i + 1) * 8, 8) != 0)
+	v = 0;
+      ret = __store_long (v + ptr->counts[i], da + (i + 1) * 8, 8);
+    }
+  if (ret)
+    fprintf (stderr, "arc profiling: Error writing output file %s.\n",
+	     ptr->filename);
 
-      for (ptr = bb_head; ptr != (struct bb *) 0; ptr = ptr->next)
+  if (munmap (da, size) != 0 || close (fd) != 0)
+    fprintf (stderr, "arc profiling: Error closing output file %s.\n",
+	     ptr->filename);
+}
+
+#else /* ! TARGET_HAS_F_SETLKW */
+
+/* Add the counts of PTR to its .da file, or replace the file if it does
+   not hold the same number of counts.  */
+
+static void
+bb_merge_da_file (struct bb *ptr)
+{
+  FILE *da_file;
+
+  /* If the file exists, and the number of counts in it is the same,
+     then merge them in.  */
+
+  if ((da_file = fopen (ptr->filename, "r")) != 0)
+    {
+      long n_counts = 0;
+
+      if (__read_long (&n_counts, da_file, 8) != 0)
 	{
-	  /* If the file exists, and the number of counts in it is the same,
-	     then merge them in.  */
-	     
-	  if ((da_file = fopen (ptr->filename, "r")) != 0)
+	  fprintf (stderr, "arc profiling: Can't read output file %s.\n",
+		   ptr->filename);
+	  return;
+	}
+
+      if (n_counts == ptr->ncounts)
+	{
+	  int i;
+
+	  for (i = 0; i < n_counts; i++)
 	    {
-	      long n_counts = 0;
-	      
-	      if (__read_long (&n_counts, da_file, 8) != 0)
+	      long v = 0;
+
+	      if (__read_long (&v, da_file, 8) != 0)
 		{
 		  fprintf (stderr, "arc profiling: Can't read output file %s.\n",
 			   ptr->filename);
-		  continue;
+		  break;
 		}
+	      ptr->counts[i] += v;
+	    }
+	}
 
-	      if (n_counts == ptr->ncounts)
-		{
-		  int i;
-
-		  for (i = 0; i < n_counts; i++)
-		    {
-		      long v = 0;
-
-		      if (__read_long (&v, da_file, 8) != 0)
-			{
-			  fprintf (stderr, "arc profiling: Can't read output file %s.\n",
-				   ptr->filename);
-			  break;
-			}
-		      ptr->counts[i] += v;
-		    }
-		}
+      if (fclose (da_file) == EOF)
+	fprintf (stderr, "arc profiling: Error closing output file %s.\n",
+		 ptr->filename);
+    }
+  if ((da_file = fopen (ptr->filename, "w")) == 0)
+    {
+      fprintf (stderr, "arc profiling: Can't open output file %s.\n",
+	       ptr->filename);
+      return;
+    }
 
-	      if (fclose (da_file) == EOF)
-		fprintf (stderr, "arc profiling: Error closing output file %s.\n",
-			 ptr->filename);
-	    }
-	  if ((da_file = fopen (ptr->filename, "w")) == 0)
-	    {
-	      fprintf (stderr, "arc profiling: Can't open output file %s.\n",
-		       ptr->filename);
-	      continue;
-	    }
+  /* ??? Should first write a header to the file.  Preferably, a 4 byte
+     magic number, 4 bytes containing the time the program was
+     compiled, 4 bytes containing the last modification time of the
+     source file, and 4 bytes indicating the compiler options used.
 
-	  /* ??? Should first write a header to the file.  Preferably, a 4 byte
-	     magic number, 4 bytes containing the time the program was
-	     compiled, 4 bytes containing the last modification time of the
-	     source file, and 4 bytes indicating the compiler options used.
+     That way we can easily verify that the proper source/executable/
+     data file combination is being used from gcov.  */
 
-	     That way we can easily verify that the proper source/executable/
-	     data file combination is being used from gcov.  */
+  if (__write_long (ptr->ncounts, da_file, 8) != 0)
+    {
 
-	  if (__write_long (ptr->ncounts, da_file, 8) != 0)
-	    {
-	      
-	      fprintf (stderr, "arc profiling: Error writing output file %s.\n",
-		       ptr->filename);
-	    }
-	  else
+      fprintf (stderr, "arc profiling: Error writing output file %s.\n",
+	       ptr->filename);
+    }
+  else
+    {
+      int j;
+      long *count_ptr = ptr->counts;
+      int ret = 0;
+      for (j = ptr->ncounts; j > 0; j--)
+	{
+	  if (__write_long (*count_ptr, da_file, 8) != 0)
 	    {
-	      int j;
-	      long *count_ptr = ptr->counts;
-	      int ret = 0;
-	      for (j = ptr->ncounts; j > 0; j--)
-		{
-		  if (__write_long (*count_ptr, da_file, 8) != 0)
-		    {
-		      ret=1;
-		      break;
-		    }
-		  count_ptr++;
-		}
-	      if (ret)
-		fprintf (stderr, "arc profiling: Error writing output file %s.\n",
-			 ptr->filename);
+	      ret=1;
+	      break;
 	    }
-	  
-	  if (fclose (da_file) == EOF)
-	    fprintf (stderr, "arc profiling: Error closing output file %s.\n",
-		     ptr->filename);
+	  count_ptr++;
 	}
+      if (ret)
+	fprintf (stderr, "arc profiling: Error writing output file %s.\n",
+		 ptr->filename);
+    }
+
+  if (fclose (da_file) == EOF)
+    fprintf (stderr, "arc profiling: Error closing output file %s.\n",
+	     ptr->filename);
+}
+
+#endif /* ! TARGET_HAS_F_SETLKW */
+
+/* Return nonzero if the blocks of the list are arc profiles, for gcov,
+   rather than basic block profiles made with -a.  */
+
+static int
+bb_arc_profiling_p (void)
+{
+  int i = strlen (bb_head->filename) - 3;
+
+  return i >= 0 && !strcmp (bb_head->filename+i, ".da");
+}
+
+/* Write the arc profiles gathered so far to the .da files, as is done
+   at exit, and start counting again from zero.  A program that does not
+   exit, such as a server, can call this from time to time, declaring it
+   as `extern void __bb_dump_func (void);'.  Counts that other threads
+   make meanwhile may be lost.  Basic block profiles made with -a are
+   only written at exit.  */
+
+void
+__bb_dump_func (void)
+{
+  struct bb *ptr;
+
+  if (bb_head == 0 || ! bb_arc_profiling_p ())
+    return;
+
+  for (ptr = bb_head; ptr != (struct bb *) 0; ptr = ptr->next)
+    {
+      bb_merge_da_file (ptr);
+      memset (ptr->counts, 0, ptr->ncounts * sizeof (long));
+    }
+}
+
+void
+__bb_exit_func (void)
+{
+  FILE *file;
+  long time_value;
+
+  if (bb_head == 0)
+    return;
+
+  if (bb_arc_profiling_p ())
+    {
+      /* Must be -fprofile-arcs not -a.
+	 Dump data in a form that gcov expects.  */
+
+      struct bb *ptr;
+
+      for (ptr = bb_head; ptr != (struct bb *) 0; ptr = ptr->next)
+	bb_merge_da_file (ptr);
 
       return;
     }
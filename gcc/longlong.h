@@ -66,6 +66,13 @@
    LOW_DIFFERENCE.  Overflow (i.e. carry out) is not stored anywhere,
    and is lost.
 
+   8) udiv_qrnd(quotient, remainder, numerator, denominator) divides
+   the single-word NUMERATOR by DENOMINATOR, which must not be zero, and
+   places the quotient in QUOTIENT and the remainder in REMAINDER.  It
+   is only defined for processors on which one instruction gives both;
+   __udivmoddi4 then uses it when the numbers fit in a word, and
+   __udiv_qrnnd_c uses it for its two divisions.
+
    If any of these macros are left undefined for a particular CPU,
    C macros are used.  */
 
@@ -632,6 +639,14 @@ UDItype __umulsidi3 (USItype, USItype);
 	     "=h" ((USItype) (w1))					\
 	   : "d" ((USItype) (u)),					\
 	     "d" ((USItype) (v)))
+/* With $0 as the destination, the assembler does not add its check
+   for division by zero.  */
+#define udiv_qrnd(q, r, n, d) \
+  __asm__ ("divu $0,%2,%3"						\
+	   : "=l" ((USItype) (q)),					\
+	     "=h" ((USItype) (r))					\
+	   : "d" ((USItype) (n)),					\
+	     "d" ((USItype) (d)))
 #define UMUL_TIME 10
 #define UDIV_TIME 100
 #endif /* __mips__ */
@@ -1172,6 +1187,16 @@ UDItype __umulsidi3 (USItype, USItype);
     __w.ll; })
 #endif
 
+#if defined (udiv_qrnd)
+#define __udiv_qrnd_c udiv_qrnd
+#else
+#define __udiv_qrnd_c(q, r, n, d) \
+  do {									\
+    (r) = (n) % (d);							\
+    (q) = (n) / (d);							\
+  } while (0)
+#endif
+
 /* Define this unconditionally, so it can be used for debugging.  */
 #define __udiv_qrnnd_c(q, r, n1, n0, d) \
   do {									\
@@ -1180,8 +1205,7 @@ UDItype __umulsidi3 (USItype, USItype);
     __d1 = __ll_highpart (d);						\
     __d0 = __ll_lowpart (d);						\
 									\
-    __r1 = (n1) % __d1;							\
-    __q1 = (n1) / __d1;							\
+    __udiv_qrnd_c (__q1, __r1, n1, __d1);				\
     __m = (USItype) __q1 * __d0;					\
     __r1 = __r1 * __ll_B | __ll_highpart (n0);				\
     if (__r1 < __m)							\
@@ -1193,8 +1217,7 @@ UDItype __umulsidi3 (USItype, USItype);
       }									\
     __r1 -= __m;							\
 									\
-    __r0 = __r1 % __d1;							\
-    __q0 = __r1 / __d1;							\
+    __udiv_qrnd_c (__q0, __r0, __r1, __d1);				\
     __m = (USItype) __q0 * __d0;					\
     __r0 = __r0 * __ll_B | __ll_lowpart (n0);				\
     if (__r0 < __m)							\
@@ -0,0 +1,1305 @@
+/* Software pipelining of innermost loops by modulo scheduling.
+   Copyright (C) 1999 Free Software Foundation, Inc.
+
+This file is part of GNU CC.
+
+GNU CC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+GNU CC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GNU CC; see the file COPYING.  If not, write to
+the Free Software Foundation, 59 Temple Place - Suite 330,
+Boston, MA 02111-1307, USA.  */
+
+
+/* This pass overlaps the iterations of small innermost loops, so that
+   the latency of a multiply or load in one iteration is hidden behind
+   the work of the next ones.  The instruction schedulers cannot do
+   this, since they never move an insn from one iteration to another.
+
+   The loops handled are those that loop.c leaves as a single basic
+   block: a NOTE_INSN_LOOP_BEG note, a label used only by the branch
+   back to it, insns without calls, labels, volatile references or asm
+   statements, the conditional branch back to the label, and then the
+   NOTE_INSN_LOOP_END note.  The pass runs after loop optimization and
+   the second CSE pass and before flow, on pseudo registers.
+
+   Each loop body is modulo scheduled (B. R. Rau, "Iterative Modulo
+   Scheduling", MICRO-27, 1994): a new iteration is started every II
+   cycles, and each insn of the body gets a time, which is a stage
+   number times II plus a row number less than II.  The dependences
+   between the insns, within an iteration and from one iteration to the
+   next, carry the latencies of the define_function_unit descriptions,
+   and a modulo reservation table with one entry per row keeps the
+   issue slots and the function units from being used more than they
+   can be.  II starts at the larger of the bounds set by the resources
+   and by the recurrences through the loop and is raised until a
+   schedule is found; the loop is left alone if the schedule would be no
+   faster than the iterations run one after the other.
+
+   The branch back to the top is kept in the last row of stage 0, so
+   the insns of an iteration are only ever executed once its branch
+   has been reached: nothing is executed speculatively and the trip
+   count need not be known.  The code is laid out as
+
+	prologue	stages 0 .. J of iterations J .. 0, for J < S - 1,
+			each ending with an exit to its own epilogue
+	kernel		stages 0 .. S - 1 of S iterations, repeated
+	epilogues	the remaining stages of the iterations in flight
+
+   where S is the number of stages.  A register set in the body whose
+   value is still needed when the next iteration sets it again is
+   renamed: the kernel is unrolled U times and each copy uses its own
+   set of pseudo registers (modulo variable expansion, M. Lam, PLDI
+   1988).  Only registers that are set once in the body, used only
+   after that set and not mentioned outside the loop are renamed; the
+   dependences of the others are left in the way.  Each copy of the
+   kernel has an exit to an epilogue of its own.  */
+
+#include "config.h"
+#include "system.h"
+#include "rtl.h"
+#include "regs.h"
+#include "hard-reg-set.h"
+#include "flags.h"
+#include "insn-config.h"
+#include "insn-attr.h"
+#include "insn-flags.h"
+#include "recog.h"
+#include "expr.h"
+#include "toplev.h"
+
+#if defined (INSN_SCHEDULING) && ! defined (HAVE_cc0)
+
+#ifndef ISSUE_RATE
+#define ISSUE_RATE 1
+#endif
+
+/* The largest loop body handled, in insns.  */
+#define MAX_LOOP_INSNS 64
+
+/* The registers and memory references an insn may make.  */
+#define MAX_REFS 16
+#define MAX_MEMS 4
+
+/* The largest number of stages in a schedule and the largest number of
+   copies of the kernel, which bound the growth of the code.  */
+#define MAX_STAGES 4
+#define MAX_COPIES 4
+
+/* The largest II tried.  */
+#define MAX_II 256
+
+/* The value of a dependence or path matrix entry when there is none.  */
+#define NO_DEP (-1)
+#define NO_PATH (-1000000)
+
+/* An insn of the loop body.  */
+
+struct ms_op
+{
+  rtx insn;
+
+  /* The registers the insn sets and uses.  A register that is only
+     partly set is also counted as used.  Hard registers are listed
+     once for each word.  */
+  int n_defs, n_uses;
+  int defs[MAX_REFS], uses[MAX_REFS];
+
+  /* The memory references and whether each is a store.  */
+  int n_mems;
+  rtx mems[MAX_MEMS];
+  char stores[MAX_MEMS];
+
+  /* Nonzero if the insn takes an issue slot; USE and CLOBBER insns do
+     not.  */
+  char issue;
+
+  /* The cycles until the result is ready.  */
+  int latency;
+
+  /* For each function unit, the cycles the insn keeps it busy, or 0 if
+     it does not use it.  */
+  int busy[FUNCTION_UNITS_SIZE];
+
+  /* The time at which the insn is scheduled, or -1.  */
+  int time;
+};
+
+static struct ms_op ops[MAX_LOOP_INSNS];
+static int n_ops;
+
+/* The op being scanned.  */
+static int cur_op;
+
+/* For each pair of ops, the largest latency of a dependence of the
+   second on the first in the same iteration (DEP0) or in the next
+   iteration (DEP1), or NO_DEP.  */
+static int dep0[MAX_LOOP_INSNS][MAX_LOOP_INSNS];
+static int dep1[MAX_LOOP_INSNS][MAX_LOOP_INSNS];
+
+/* For the II being tried, the longest path between each pair of ops,
+   the minimum time between them, or NO_PATH.  */
+static int path[MAX_LOOP_INSNS][MAX_LOOP_INSNS];
+
+/* The modulo reservation table: for each row, the number of issue
+   slots taken and the number of insns on each function unit.  */
+static int mrt_issue[MAX_II];
+static int mrt_unit[FUNCTION_UNITS_SIZE][MAX_II];
+
+/* The number of pseudo registers before the pass, the size of the
+   following arrays.  */
+static int ms_max_reg;
+
+/* For each pseudo register, the op that sets it in the loop being
+   scheduled, -1 if none sets it, or -2 if it is set more than once or
+   only in part; the first op that uses it, or -1; and its index in
+   RENAMED, or -1.  */
+static int *reg_def_op;
+static int *reg_use_op;
+static int *reg_renamed;
+
+/* The registers that may be renamed in the loop being scheduled and
+   the registers that replace each in the copies of the kernel.  */
+
+struct ms_reg
+{
+  int regno;
+
+  /* Nonzero if the register needs more than one name.  */
+  int split;
+
+  rtx names[MAX_COPIES];
+};
+
+static struct ms_reg *renamed;
+static int n_renamed;
+
+/* The II and the number of stages of the schedule, and the number of
+   copies of the kernel.  */
+static int ii;
+static int n_stages;
+static int n_copies;
+
+static FILE *ms_dump;
+
+static int loop_body_ok			PROTO ((rtx, rtx *, rtx *, rtx *));
+static int note_reg			PROTO ((rtx, int));
+static int scan_uses			PROTO ((rtx));
+static int scan_set			PROTO ((rtx, int));
+static int scan_pattern			PROTO ((rtx));
+static int scan_op			PROTO ((rtx));
+static void mark_outside_refs		PROTO ((rtx));
+static void find_renamable_regs		PROTO ((rtx, rtx, rtx));
+static void add_dep			PROTO ((int, int, int, int));
+static void build_deps			PROTO ((void));
+static int res_mii			PROTO ((void));
+static int compute_paths		PROTO ((int));
+static int reserve			PROTO ((int, int, int));
+static int place_op			PROTO ((int, int));
+static int sequential_length		PROTO ((void));
+static int schedule_loop		PROTO ((int));
+static void substitute			PROTO ((rtx *, int, rtx));
+static rtx copy_op			PROTO ((int, int, rtx));
+static void emit_step			PROTO ((int, int, int));
+static void emit_exit			PROTO ((int, rtx));
+static void pipeline_loop		PROTO ((rtx, rtx, rtx, rtx));
+static void try_loop			PROTO ((rtx, rtx));
+
+/* Return nonzero if the insns after the NOTE_INSN_LOOP_BEG note
+   LOOP_BEG form a loop this pass can handle.  Store the label at its
+   top, the branch back to it and the NOTE_INSN_LOOP_END note in *PTOP,
+   *PJUMP and *PEND.  */
+
+static int
+loop_body_ok (loop_beg, ptop, pjump, pend)
+     rtx loop_beg;
+     rtx *ptop, *pjump, *pend;
+{
+  rtx insn, top;
+  int n = 0;
+
+  for (top = NEXT_INSN (loop_beg); top && GET_CODE (top) == NOTE;
+       top = NEXT_INSN (top))
+    if (NOTE_LINE_NUMBER (top) == NOTE_INSN_LOOP_BEG
+	|| NOTE_LINE_NUMBER (top) == NOTE_INSN_LOOP_END)
+      return 0;
+
+  if (top == 0 || GET_CODE (top) != CODE_LABEL || LABEL_NUSES (top) != 1
+      || LABEL_PRESERVE_P (top))
+    return 0;
+
+  for (insn = NEXT_INSN (top); insn; insn = NEXT_INSN (insn))
+    {
+      switch (GET_CODE (insn))
+	{
+	case NOTE:
+	  if (NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_END
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_EH_REGION_BEG
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_EH_REGION_END
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_BLOCK_BEG
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_BLOCK_END
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_SETJMP)
+	    return 0;
+	  continue;
+
+	case INSN:
+	  if (++n >= MAX_LOOP_INSNS)
+	    return 0;
+	  continue;
+
+	case JUMP_INSN:
+	  if (! condjump_p (insn) || JUMP_LABEL (insn) != top)
+	    return 0;
+	  break;
+
+	default:
+	  return 0;
+	}
+      break;
+    }
+
+  if (insn == 0 || n == 0)
+    return 0;
+  *pjump = insn;
+
+  for (insn = NEXT_INSN (insn); insn && GET_CODE (insn) == NOTE;
+       insn = NEXT_INSN (insn))
+    if (NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_END)
+      {
+	*ptop = top;
+	*pend = insn;
+	return 1;
+      }
+
+  return 0;
+}
+
+/* Record that the op being scanned sets (if DEF) or uses register X.
+   Return zero if it makes too many references.  */
+
+static int
+note_reg (x, def)
+     rtx x;
+     int def;
+{
+  struct ms_op *op = &ops[cur_op];
+  int regno = REGNO (x);
+  int last = regno + (regno < FIRST_PSEUDO_REGISTER
+		      ? HARD_REGNO_NREGS (regno, GET_MODE (x)) : 1);
+  int *refs = def ? op->defs : op->uses;
+  int *n = def ? &op->n_defs : &op->n_uses;
+  int i;
+
+  for (; regno < last; regno++)
+    {
+      for (i = 0; i < *n; i++)
+	if (refs[i] == regno)
+	  break;
+
+      if (i == *n)
+	{
+	  if (*n == MAX_REFS)
+	    return 0;
+	  refs[(*n)++] = regno;
+	}
+    }
+
+  return 1;
+}
+
+/* Record the registers and memory used in X by the op being scanned.
+   Return zero if X has something that cannot be moved to another
+   iteration or copied.  */
+
+static int
+scan_uses (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+  struct ms_op *op = &ops[cur_op];
+
+  switch (code)
+    {
+    case REG:
+      return note_reg (x, 0);
+
+    case MEM:
+      if (op->n_mems == MAX_MEMS)
+	return 0;
+      op->stores[op->n_mems] = 0;
+      op->mems[op->n_mems++] = x;
+      return scan_uses (XEXP (x, 0));
+
+    case CONST_INT:
+    case CONST_DOUBLE:
+    case CONST:
+    case SYMBOL_REF:
+    case PC:
+    case CC0:
+      return 1;
+
+    /* A label used outside a jump would need its use count kept, and
+       the side effects below cannot be copied.  */
+    case LABEL_REF:
+    case ASM_OPERANDS:
+    case ASM_INPUT:
+    case UNSPEC_VOLATILE:
+    case PRE_INC:
+    case PRE_DEC:
+    case POST_INC:
+    case POST_DEC:
+      return 0;
+
+    default:
+      break;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (! scan_uses (XEXP (x, i)))
+	    return 0;
+	}
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (! scan_uses (XVECEXP (x, i, j)))
+	    return 0;
+    }
+
+  return 1;
+}
+
+/* Record DEST as set by the op being scanned, in a SET or, if CLOBBER,
+   a CLOBBER.  Return zero as scan_uses does.  */
+
+static int
+scan_set (dest, clobber)
+     rtx dest;
+     int clobber;
+{
+  struct ms_op *op = &ops[cur_op];
+  int partial = 0;
+
+  while (GET_CODE (dest) == SUBREG || GET_CODE (dest) == STRICT_LOW_PART
+	 || GET_CODE (dest) == ZERO_EXTRACT || GET_CODE (dest) == SIGN_EXTRACT)
+    {
+      if (GET_CODE (dest) == ZERO_EXTRACT || GET_CODE (dest) == SIGN_EXTRACT)
+	if (! scan_uses (XEXP (dest, 1)) || ! scan_uses (XEXP (dest, 2)))
+	  return 0;
+      partial = 1;
+      dest = XEXP (dest, 0);
+    }
+
+  switch (GET_CODE (dest))
+    {
+    case REG:
+      if (! note_reg (dest, 1) || (partial && ! note_reg (dest, 0)))
+	return 0;
+      if (partial && REGNO (dest) < ms_max_reg)
+	reg_def_op[REGNO (dest)] = -2;
+      return 1;
+
+    case MEM:
+      if (op->n_mems == MAX_MEMS)
+	return 0;
+      op->stores[op->n_mems] = 1;
+      op->mems[op->n_mems++] = dest;
+      return scan_uses (XEXP (dest, 0));
+
+    case SCRATCH:
+    case PC:
+      return 1;
+
+    default:
+      return clobber;
+    }
+}
+
+/* Scan the pattern X of the op being scanned.  */
+
+static int
+scan_pattern (x)
+     rtx x;
+{
+  int i;
+
+  switch (GET_CODE (x))
+    {
+    case SET:
+      /* Only the condition of the branch back to the top matters.  */
+      if (SET_DEST (x) == pc_rtx)
+	return (GET_CODE (SET_SRC (x)) == IF_THEN_ELSE
+		&& scan_uses (XEXP (SET_SRC (x), 0)));
+      return scan_set (SET_DEST (x), 0) && scan_uses (SET_SRC (x));
+
+    case CLOBBER:
+      return scan_set (XEXP (x, 0), 1);
+
+    case USE:
+      return scan_uses (XEXP (x, 0));
+
+    case PARALLEL:
+      for (i = 0; i < XVECLEN (x, 0); i++)
+	if (! scan_pattern (XVECEXP (x, 0, i)))
+	  return 0;
+      return 1;
+
+    default:
+      return scan_uses (x);
+    }
+}
+
+/* Make INSN the next op of the loop body.  Return zero if the loop
+   cannot be pipelined because of it.  */
+
+static int
+scan_op (insn)
+     rtx insn;
+{
+  struct ms_op *op = &ops[n_ops];
+  rtx pat = PATTERN (insn);
+  int unit, i;
+
+  bzero ((char *) op, sizeof (struct ms_op));
+  op->insn = insn;
+  op->time = -1;
+  cur_op = n_ops++;
+
+  if (volatile_insn_p (pat) || volatile_refs_p (pat)
+      || asm_noperands (pat) >= 0 || ! scan_pattern (pat))
+    return 0;
+
+  if (GET_CODE (pat) == USE || GET_CODE (pat) == CLOBBER)
+    {
+      op->latency = 1;
+      return 1;
+    }
+
+  if (recog_memoized (insn) < 0)
+    return 0;
+
+  op->issue = 1;
+  op->latency = MAX (result_ready_cost (insn), 1);
+
+  unit = function_units_used (insn);
+  for (i = 0; i < FUNCTION_UNITS_SIZE; i++)
+    if (unit >= 0 ? unit == i : (~unit & (1 << i)) != 0)
+      {
+	int busy = 1;
+
+	if (function_units[i].blockage_range_function
+	    && function_units[i].blockage_function)
+	  busy = function_units[i].blockage_function (insn, insn);
+	op->busy[i] = MAX (busy, 1);
+      }
+
+  return 1;
+}
+
+/* Note each pseudo register in X that may be renamed as mentioned
+   outside the loop, by clearing its entry in REG_DEF_OP.  */
+
+static void
+mark_outside_refs (x)
+     rtx x;
+{
+  register RTX_CODE code;
+  register char *fmt;
+  register int i, j;
+
+  if (x == 0)
+    return;
+
+  code = GET_CODE (x);
+  if (code == REG)
+    {
+      if (REGNO (x) < ms_max_reg && reg_def_op[REGNO (x)] >= 0)
+	reg_def_op[REGNO (x)] = -2;
+      return;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	mark_outside_refs (XEXP (x, i));
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  mark_outside_refs (XVECEXP (x, i, j));
+    }
+}
+
+/* Find the pseudo registers of the loop from TOP to JUMP in function F
+   that may be renamed: those set by one op, which sets all of the
+   register, used only by later ops, and not mentioned anywhere else.
+   Fill in RENAMED.  */
+
+static void
+find_renamable_regs (f, top, jump)
+     rtx f, top, jump;
+{
+  rtx insn;
+  int i, j, regno;
+
+  for (i = 0; i < n_ops; i++)
+    {
+      for (j = 0; j < ops[i].n_uses; j++)
+	{
+	  regno = ops[i].uses[j];
+	  if (regno >= FIRST_PSEUDO_REGISTER && regno < ms_max_reg
+	      && reg_use_op[regno] < 0)
+	    reg_use_op[regno] = i;
+	}
+      for (j = 0; j < ops[i].n_defs; j++)
+	{
+	  regno = ops[i].defs[j];
+	  if (regno >= FIRST_PSEUDO_REGISTER && regno < ms_max_reg
+	      && reg_def_op[regno] != -2)
+	    reg_def_op[regno] = reg_def_op[regno] == -1 ? i : -2;
+	}
+    }
+
+  for (i = 0; i < n_ops; i++)
+    for (j = 0; j < ops[i].n_defs; j++)
+      {
+	regno = ops[i].defs[j];
+	if (regno >= FIRST_PSEUDO_REGISTER && regno < ms_max_reg
+	    && reg_def_op[regno] >= 0 && reg_use_op[regno] >= 0
+	    && reg_use_op[regno] <= reg_def_op[regno])
+	  reg_def_op[regno] = -2;
+      }
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    {
+      if (insn == top)
+	insn = jump;
+      else if (GET_RTX_CLASS (GET_CODE (insn)) == 'i')
+	{
+	  mark_outside_refs (PATTERN (insn));
+	  mark_outside_refs (REG_NOTES (insn));
+	  if (GET_CODE (insn) == CALL_INSN)
+	    mark_outside_refs (CALL_INSN_FUNCTION_USAGE (insn));
+	}
+    }
+
+  n_renamed = 0;
+  for (i = 0; i < n_ops; i++)
+    for (j = 0; j < ops[i].n_defs; j++)
+      {
+	regno = ops[i].defs[j];
+	if (regno >= FIRST_PSEUDO_REGISTER && regno < ms_max_reg
+	    && reg_def_op[regno] == i && reg_renamed[regno] < 0)
+	  {
+	    reg_renamed[regno] = n_renamed;
+	    renamed[n_renamed].regno = regno;
+	    renamed[n_renamed].split = 0;
+	    n_renamed++;
+	  }
+      }
+}
+
+/* Record a dependence of op TO on op FROM, DISTANCE iterations later,
+   with LATENCY cycles between them.  */
+
+static void
+add_dep (from, to, distance, latency)
+     int from, to, distance, latency;
+{
+  int *p = distance ? &dep1[from][to] : &dep0[from][to];
+
+  if (*p < latency)
+    *p = latency;
+}
+
+/* Compute the dependences between the ops of the loop.  An op that
+   sets a register that a later op uses must come before it in the same
+   iteration, and the use must come before the set in the next
+   iteration, unless the register is renamed.  Memory references are
+   compared by the alias analysis, which gives up on two references from
+   different iterations unless their bases differ.  */
+
+static void
+build_deps ()
+{
+  int a, b, i, j, k, r;
+
+  for (a = 0; a < n_ops; a++)
+    for (b = 0; b < n_ops; b++)
+      dep0[a][b] = dep1[a][b] = NO_DEP;
+
+  for (a = 0; a < n_ops; a++)
+    for (b = a; b < n_ops; b++)
+      {
+	struct ms_op *x = &ops[a], *y = &ops[b];
+
+	for (i = 0; i < x->n_defs; i++)
+	  {
+	    r = x->defs[i];
+
+	    for (j = 0; j < y->n_uses; j++)
+	      if (y->uses[j] == r)
+		{
+		  if (a == b)
+		    add_dep (a, a, 1, x->latency);
+		  else
+		    {
+		      add_dep (a, b, 0, x->latency);
+		      if (r >= ms_max_reg || reg_renamed[r] < 0)
+			add_dep (b, a, 1, 1);
+		    }
+		}
+
+	    for (j = 0; j < y->n_defs; j++)
+	      if (y->defs[j] == r)
+		{
+		  if (a != b)
+		    add_dep (a, b, 0, 1);
+		  if (r >= ms_max_reg || reg_renamed[r] < 0)
+		    add_dep (b, a, 1, 1);
+		}
+	  }
+
+	if (a == b)
+	  continue;
+
+	for (i = 0; i < x->n_uses; i++)
+	  for (j = 0; j < y->n_defs; j++)
+	    if (x->uses[i] == y->defs[j])
+	      {
+		add_dep (a, b, 0, 1);
+		add_dep (b, a, 1, y->latency);
+	      }
+
+	for (i = 0; i < x->n_mems; i++)
+	  for (j = 0; j < y->n_mems; j++)
+	    {
+	      rtx m = x->mems[i], n = y->mems[j];
+
+	      if (! x->stores[i] && ! y->stores[j])
+		continue;
+
+	      if (x->stores[i] && y->stores[j])
+		k = output_dependence (m, n);
+	      else if (x->stores[i])
+		k = true_dependence (m, VOIDmode, n, rtx_varies_p);
+	      else
+		k = anti_dependence (m, n);
+
+	      if (k)
+		add_dep (a, b, 0, 1);
+	      if (loop_dependence (m, n))
+		add_dep (b, a, 1, 1);
+	    }
+      }
+}
+
+/* Return the lower bound on II set by the issue slots and function
+   units the ops need.  */
+
+static int
+res_mii ()
+{
+  int i, u, n = 0, mii;
+
+  for (i = 0; i < n_ops; i++)
+    n += ops[i].issue;
+  mii = (n + ISSUE_RATE - 1) / ISSUE_RATE;
+
+  for (u = 0; u < FUNCTION_UNITS_SIZE; u++)
+    {
+      int m = function_units[u].multiplicity;
+
+      for (n = 0, i = 0; i < n_ops; i++)
+	n += ops[i].busy[u];
+      mii = MAX (mii, (n + m - 1) / m);
+    }
+
+  return MAX (mii, 1);
+}
+
+/* Fill in PATH for an interval of INTERVAL cycles between iterations.
+   Return zero if the recurrences of the loop make it too small.  */
+
+static int
+compute_paths (interval)
+     int interval;
+{
+  int i, j, k, d;
+
+  for (i = 0; i < n_ops; i++)
+    for (j = 0; j < n_ops; j++)
+      {
+	d = NO_PATH;
+	if (dep0[i][j] != NO_DEP)
+	  d = dep0[i][j];
+	if (dep1[i][j] != NO_DEP)
+	  d = MAX (d, dep1[i][j] - interval);
+	path[i][j] = d;
+      }
+
+  for (k = 0; k < n_ops; k++)
+    for (i = 0; i < n_ops; i++)
+      if (path[i][k] != NO_PATH)
+	for (j = 0; j < n_ops; j++)
+	  if (path[k][j] != NO_PATH && path[i][k] + path[k][j] > path[i][j])
+	    path[i][j] = path[i][k] + path[k][j];
+
+  for (i = 0; i < n_ops; i++)
+    if (path[i][i] > 0)
+      return 0;
+
+  return 1;
+}
+
+/* Add op I issued at time T to the modulo reservation table, or remove
+   it if SIGN is -1.  Return zero if this oversubscribes a row.  */
+
+static int
+reserve (i, t, sign)
+     int i, t, sign;
+{
+  struct ms_op *op = &ops[i];
+  int u, c, ok = 1;
+
+  if (op->issue)
+    {
+      mrt_issue[t % ii] += sign;
+      if (mrt_issue[t % ii] > ISSUE_RATE)
+	ok = 0;
+    }
+
+  for (u = 0; u < FUNCTION_UNITS_SIZE; u++)
+    for (c = 0; c < op->busy[u]; c++)
+      {
+	mrt_unit[u][(t + c) % ii] += sign;
+	if (mrt_unit[u][(t + c) % ii] > function_units[u].multiplicity)
+	  ok = 0;
+      }
+
+  return ok;
+}
+
+/* Schedule op I at the first time within II cycles of the earliest one
+   allowed by the ops scheduled so far where the resources it needs are
+   free.  Return zero if there is none.  */
+
+static int
+place_op (i, limit)
+     int i, limit;
+{
+  int early = 0, late = limit, j, t;
+
+  for (j = 0; j < n_ops; j++)
+    if (ops[j].time >= 0)
+      {
+	if (path[j][i] != NO_PATH)
+	  early = MAX (early, ops[j].time + path[j][i]);
+	if (path[i][j] != NO_PATH)
+	  late = MIN (late, ops[j].time - path[i][j]);
+      }
+
+  for (t = early; t <= late && t < early + ii; t++)
+    {
+      if (reserve (i, t, 1))
+	{
+	  ops[i].time = t;
+	  return 1;
+	}
+      reserve (i, t, -1);
+    }
+
+  return 0;
+}
+
+/* Return the number of cycles one iteration of the loop takes when the
+   iterations are not overlapped, as the list scheduler would arrange
+   them.  */
+
+static int
+sequential_length ()
+{
+  static int issue[MAX_II];
+  static int unit[FUNCTION_UNITS_SIZE][MAX_II];
+  int time[MAX_LOOP_INSNS];
+  int i, j, u, c, t, len;
+  int branch = n_ops - 1;
+
+  bzero ((char *) issue, sizeof issue);
+  bzero ((char *) unit, sizeof unit);
+  bzero ((char *) time, sizeof time);
+
+  for (i = 0; i < n_ops; i++)
+    {
+      t = 0;
+      for (j = 0; j < i; j++)
+	if (dep0[j][i] != NO_DEP)
+	  t = MAX (t, time[j] + dep0[j][i]);
+      if (i == branch)
+	for (j = 0; j < i; j++)
+	  t = MAX (t, time[j]);
+
+      for (; t < MAX_II; t++)
+	{
+	  int ok = ! ops[i].issue || issue[t] < ISSUE_RATE;
+
+	  for (u = 0; u < FUNCTION_UNITS_SIZE && ok; u++)
+	    for (c = 0; c < ops[i].busy[u] && t + c < MAX_II; c++)
+	      if (unit[u][t + c] >= function_units[u].multiplicity)
+		ok = 0;
+	  if (ok)
+	    break;
+	}
+      if (t == MAX_II)
+	return MAX_II;
+
+      time[i] = t;
+      issue[t] += ops[i].issue;
+      for (u = 0; u < FUNCTION_UNITS_SIZE; u++)
+	for (c = 0; c < ops[i].busy[u] && t + c < MAX_II; c++)
+	  unit[u][t + c]++;
+    }
+
+  len = time[branch] + 1;
+  for (i = 0; i < n_ops; i++)
+    for (j = 0; j < n_ops; j++)
+      if (dep1[i][j] != NO_DEP)
+	len = MAX (len, time[i] + dep1[i][j] - time[j]);
+
+  return MIN (len, MAX_II);
+}
+
+/* Try to modulo schedule the loop with an interval of II cycles between
+   iterations, given that at most LIMIT cycles are worth it.  Return
+   nonzero and set N_STAGES and N_COPIES if a schedule is found.  */
+
+static int
+schedule_loop (limit)
+     int limit;
+{
+  int branch = n_ops - 1;
+  int i, j, k, last;
+
+  bzero ((char *) mrt_issue, sizeof mrt_issue);
+  bzero ((char *) mrt_unit, sizeof mrt_unit);
+  for (i = 0; i < n_ops; i++)
+    ops[i].time = -1;
+
+  /* The branch goes in the last row of stage 0 and the other ops in
+     their original order, which follows the dependences within an
+     iteration.  */
+  if (! reserve (branch, ii - 1, 1))
+    return 0;
+  ops[branch].time = ii - 1;
+
+  last = 0;
+  for (i = 0; i < branch; i++)
+    {
+      if (! place_op (i, MAX_STAGES * ii - 1))
+	return 0;
+      last = MAX (last, ops[i].time);
+    }
+  n_stages = last / ii + 1;
+
+  /* A renamed register needs a new name for each iteration that starts
+     while its value is still live.  */
+  n_copies = 1;
+  for (k = 0; k < n_renamed; k++)
+    {
+      int def = reg_def_op[renamed[k].regno];
+      int life = 0, copies;
+
+      for (i = def + 1; i < n_ops; i++)
+	for (j = 0; j < ops[i].n_uses; j++)
+	  if (ops[i].uses[j] == renamed[k].regno)
+	    life = MAX (life, ops[i].time - ops[def].time);
+
+      copies = life / ii + 1;
+      renamed[k].split = copies > 1;
+      n_copies = MAX (n_copies, copies);
+    }
+
+  return n_copies <= MAX_COPIES && ii < limit;
+}
+
+/* Replace in *LOC each label by LABEL and, unless NAME is -1, each
+   renamed register by its name NAME and each SCRATCH by a new one.  */
+
+static void
+substitute (loc, name, label)
+     rtx *loc;
+     int name;
+     rtx label;
+{
+  rtx x = *loc;
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+
+  switch (code)
+    {
+    case REG:
+      if (name >= 0 && REGNO (x) < ms_max_reg && reg_renamed[REGNO (x)] >= 0
+	  && renamed[reg_renamed[REGNO (x)]].split)
+	*loc = renamed[reg_renamed[REGNO (x)]].names[name];
+      return;
+
+    case SCRATCH:
+      if (name >= 0)
+	*loc = gen_rtx_SCRATCH (GET_MODE (x));
+      return;
+
+    case LABEL_REF:
+      *loc = gen_rtx_LABEL_REF (VOIDmode, label);
+      return;
+
+    case CONST_INT:
+    case CONST_DOUBLE:
+    case CONST:
+    case SYMBOL_REF:
+    case PC:
+    case CC0:
+      return;
+
+    default:
+      break;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	substitute (&XEXP (x, i), name, label);
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  substitute (&XVECEXP (x, i, j), name, label);
+    }
+}
+
+/* Emit a copy of op I for the iteration whose registers have the names
+   NAME.  If it is the branch, make it go to LABEL.  */
+
+static rtx
+copy_op (i, name, label)
+     int i, name;
+     rtx label;
+{
+  rtx pat = copy_rtx (PATTERN (ops[i].insn));
+  rtx insn;
+
+  substitute (&pat, name, label);
+  if (GET_CODE (ops[i].insn) != JUMP_INSN)
+    return emit_insn (pat);
+
+  insn = emit_jump_insn (pat);
+  JUMP_LABEL (insn) = label;
+  LABEL_NUSES (label)++;
+  return insn;
+}
+
+/* Emit the ops other than the branch of stages FIRST through LAST that
+   are executed in STEP, the cycles from STEP * II.  Stage S belongs to
+   the iteration that started S steps before.  */
+
+static void
+emit_step (step, first, last)
+     int step, first, last;
+{
+  int row, i, s;
+
+  for (row = 0; row < ii; row++)
+    for (i = 0; i < n_ops - 1; i++)
+      if (ops[i].time % ii == row)
+	{
+	  s = ops[i].time / ii;
+	  if (s >= first && s <= last)
+	    copy_op (i, (step - s) % n_copies, NULL_RTX);
+	}
+}
+
+/* Emit the branch of the iteration started in STEP so that it goes to
+   LABEL when the loop is over, and falls through when it is not.  */
+
+static void
+emit_exit (step, label)
+     int step;
+     rtx label;
+{
+  rtx jump = copy_op (n_ops - 1, step % n_copies, label);
+  rtx next;
+
+  if (invert_exp (PATTERN (jump), jump))
+    return;
+
+  /* Branch around a jump to LABEL instead.  */
+  next = gen_label_rtx ();
+  substitute (&PATTERN (jump), -1, next);
+  LABEL_NUSES (label)--;
+  JUMP_LABEL (jump) = next;
+  LABEL_NUSES (next)++;
+  jump = emit_jump_insn (gen_jump (label));
+  JUMP_LABEL (jump) = label;
+  LABEL_NUSES (label)++;
+  emit_barrier ();
+  emit_label (next);
+}
+
+/* Replace the body of the loop from TOP to JUMP, between the notes
+   LOOP_BEG and LOOP_END, by its pipelined form.  */
+
+static void
+pipeline_loop (loop_beg, top, jump, loop_end)
+     rtx loop_beg, top, jump, loop_end;
+{
+  rtx kernel = gen_label_rtx ();
+  rtx done = gen_label_rtx ();
+  rtx *exits = (rtx *) alloca (n_copies * sizeof (rtx));
+  rtx *prologue_exits = (rtx *) alloca (n_stages * sizeof (rtx));
+  rtx seq, insn, next;
+  int c, d, j, k;
+
+  for (k = 0; k < n_renamed; k++)
+    if (renamed[k].split)
+      {
+	rtx reg = regno_reg_rtx[renamed[k].regno];
+
+	renamed[k].names[0] = reg;
+	for (c = 1; c < n_copies; c++)
+	  {
+	    rtx new = gen_reg_rtx (GET_MODE (reg));
+
+	    REG_USERVAR_P (new) = REG_USERVAR_P (reg);
+	    if (REGNO_POINTER_FLAG (REGNO (reg)))
+	      mark_reg_pointer (new, REGNO_POINTER_ALIGN (REGNO (reg)));
+	    renamed[k].names[c] = new;
+	  }
+      }
+
+  for (c = 0; c < n_copies; c++)
+    exits[c] = gen_label_rtx ();
+  for (j = 0; j < n_stages - 1; j++)
+    prologue_exits[j] = gen_label_rtx ();
+
+  /* The prologue starts the first N_STAGES - 1 iterations.  */
+  start_sequence ();
+  for (j = 0; j < n_stages - 1; j++)
+    {
+      emit_step (j, 0, j);
+      emit_exit (j, prologue_exits[j]);
+    }
+  seq = gen_sequence ();
+  end_sequence ();
+  emit_insn_before (seq, loop_beg);
+
+  /* The kernel.  Step N_STAGES - 1 + C is done by copy C.  */
+  start_sequence ();
+  emit_label (kernel);
+  for (c = 0; c < n_copies; c++)
+    {
+      j = n_stages - 1 + c;
+      emit_step (j, 0, n_stages - 1);
+      if (c < n_copies - 1)
+	emit_exit (j, exits[c]);
+      else
+	copy_op (n_ops - 1, j % n_copies, kernel);
+    }
+  seq = gen_sequence ();
+  end_sequence ();
+  emit_insn_after (seq, loop_beg);
+
+  /* The epilogues finish the iterations in flight: first the one the
+     last copy of the kernel falls into, then those of the other copies
+     and of the prologue.  */
+  start_sequence ();
+  for (k = 0; k < n_copies + n_stages - 1; k++)
+    {
+      if (k < n_copies)
+	{
+	  c = (k + n_copies - 1) % n_copies;
+	  j = n_stages - 1 + c;
+	  if (k > 0)
+	    emit_label (exits[c]);
+	  for (d = 1; d < n_stages; d++)
+	    emit_step (j + d, d, n_stages - 1);
+	}
+      else
+	{
+	  j = k - n_copies;
+	  emit_label (prologue_exits[j]);
+	  for (d = 1; d < n_stages; d++)
+	    emit_step (j + d, d, MIN (j + d, n_stages - 1));
+	}
+
+      if (k < n_copies + n_stages - 2)
+	{
+	  insn = emit_jump_insn (gen_jump (done));
+	  JUMP_LABEL (insn) = done;
+	  LABEL_NUSES (done)++;
+	  emit_barrier ();
+	}
+    }
+  emit_label (done);
+  seq = gen_sequence ();
+  end_sequence ();
+  emit_insn_after (seq, loop_end);
+
+  /* Delete the original body.  The branch goes last, taking the label
+     at the top with it.  */
+  for (insn = NEXT_INSN (top); insn != jump; insn = next)
+    {
+      next = NEXT_INSN (insn);
+      if (GET_CODE (insn) != NOTE)
+	delete_insn (insn);
+      else if (NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_CONT
+	       || NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_VTOP)
+	{
+	  NOTE_LINE_NUMBER (insn) = NOTE_INSN_DELETED;
+	  NOTE_SOURCE_FILE (insn) = 0;
+	}
+    }
+  delete_insn (jump);
+}
+
+/* Pipeline the loop starting with the NOTE_INSN_LOOP_BEG note LOOP_BEG
+   in function F, if it can be done and is worth doing.  */
+
+static void
+try_loop (f, loop_beg)
+     rtx f, loop_beg;
+{
+  rtx top, jump, loop_end, insn;
+  int i, j, limit, mii;
+
+  if (! loop_body_ok (loop_beg, &top, &jump, &loop_end))
+    return;
+
+  n_ops = 0;
+  n_renamed = 0;
+  for (insn = NEXT_INSN (top); ; insn = NEXT_INSN (insn))
+    {
+      if (GET_CODE (insn) != NOTE && ! scan_op (insn))
+	{
+	  if (ms_dump)
+	    fprintf (ms_dump, "Loop at insn %d: insn %d cannot be moved.\n",
+		     INSN_UID (loop_beg), INSN_UID (insn));
+	  goto done;
+	}
+      if (insn == jump)
+	break;
+    }
+
+  find_renamable_regs (f, top, jump);
+  build_deps ();
+
+  limit = sequential_length ();
+  mii = res_mii ();
+  for (ii = mii; ii < limit && ii < MAX_II; ii++)
+    if (compute_paths (ii) && schedule_loop (limit))
+      break;
+
+  if (ms_dump)
+    fprintf (ms_dump,
+	     "Loop at insn %d: %d insns, %d cycles per iteration, ResMII %d",
+	     INSN_UID (loop_beg), n_ops, limit, mii);
+
+  if (ii >= limit || ii >= MAX_II || n_stages < 2)
+    {
+      if (ms_dump)
+	fprintf (ms_dump, ", not pipelined.\n");
+      goto done;
+    }
+
+  if (ms_dump)
+    {
+      fprintf (ms_dump, ", II %d, %d stages, %d kernel copies.\n",
+	       ii, n_stages, n_copies);
+      for (i = 0; i < n_ops; i++)
+	fprintf (ms_dump, "  insn %d: stage %d, row %d\n",
+		 INSN_UID (ops[i].insn), ops[i].time / ii, ops[i].time % ii);
+      for (i = 0; i < n_renamed; i++)
+	if (renamed[i].split)
+	  fprintf (ms_dump, "  register %d renamed\n", renamed[i].regno);
+    }
+
+  pipeline_loop (loop_beg, top, jump, loop_end);
+
+ done:
+  /* Reset the register information for the next loop.  */
+  for (i = 0; i < n_ops; i++)
+    {
+      for (j = 0; j < ops[i].n_defs; j++)
+	if (ops[i].defs[j] < ms_max_reg)
+	  reg_def_op[ops[i].defs[j]] = reg_use_op[ops[i].defs[j]]
+	    = reg_renamed[ops[i].defs[j]] = -1;
+      for (j = 0; j < ops[i].n_uses; j++)
+	if (ops[i].uses[j] < ms_max_reg)
+	  reg_def_op[ops[i].uses[j]] = reg_use_op[ops[i].uses[j]]
+	    = reg_renamed[ops[i].uses[j]] = -1;
+    }
+}
+
+/* Modulo schedule the innermost loops of the function whose insns start
+   with F.  Write a report to FILE if it is nonzero.  */
+
+void
+modulo_schedule_loops (f, file)
+     rtx f;
+     FILE *file;
+{
+  rtx insn, next;
+  int i;
+
+  ms_dump = file;
+  ms_max_reg = max_reg_num ();
+  reg_def_op = (int *) xmalloc (ms_max_reg * sizeof (int));
+  reg_use_op = (int *) xmalloc (ms_max_reg * sizeof (int));
+  reg_renamed = (int *) xmalloc (ms_max_reg * sizeof (int));
+  renamed = (struct ms_reg *) xmalloc (MAX_LOOP_INSNS * MAX_REFS
+				       * sizeof (struct ms_reg));
+  for (i = 0; i < ms_max_reg; i++)
+    reg_def_op[i] = reg_use_op[i] = reg_renamed[i] = -1;
+
+  init_alias_analysis ();
+
+  for (insn = f; insn; insn = next)
+    {
+      next = NEXT_INSN (insn);
+      if (GET_CODE (insn) == NOTE
+	  && NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG)
+	try_loop (f, insn);
+    }
+
+  end_alias_analysis ();
+
+  free (reg_def_op);
+  free (reg_use_op);
+  free (reg_renamed);
+  free (renamed);
+}
+
+#else /* ! INSN_SCHEDULING || HAVE_cc0 */
+
+/* Without function unit descriptions there is nothing to schedule
+   with, and an insn that uses cc0 cannot be moved away from the insn
+   that sets it.  */
+
+void
+modulo_schedule_loops (f, file)
+     rtx f ATTRIBUTE_UNUSED;
+     FILE *file ATTRIBUTE_UNUSED;
+{
+}
+
+#endif /* INSN_SCHEDULING && ! HAVE_cc0 */
@@ -44,10 +44,29 @@ Boston, MA 02111-1307, USA.  */
 /* The uninstalled dispatch table */
 struct sarray* __objc_uninstalled_dtable = 0;   /* !T:MUTEX */
 
+/* Messages are looked up without a lock, so a dispatch table is built
+   completely before it is stored in its class, and this barrier makes
+   the stores that built it visible to other processors before that one.
+   See THREADS.  sync is a MIPS II instruction.  The MIPS test is the
+   one libstdc++'s atomicity.h uses for ll and sc: -mips2 does not define
+   __mips as 2, and GNU/Linux is taken to provide the MIPS II
+   instructions.  */
+#if defined (__mips__) && (__mips >= 2 || defined (__linux__))
+#define __objc_write_barrier() \
+  __asm__ __volatile__ (".set\tmips2\n\tsync\n\t.set\tmips0" : : : "memory")
+#elif defined (__alpha__)
+#define __objc_write_barrier() __asm__ __volatile__ ("wmb" : : : "memory")
+#elif defined (__PPC__) || defined (__powerpc__)
+#define __objc_write_barrier() __asm__ __volatile__ ("sync" : : : "memory")
+#else
+#define __objc_write_barrier() __asm__ __volatile__ ("" : : : "memory")
+#endif
+
 /* Send +initialize to class */
 static void __objc_send_initialize(Class);
 
 static void __objc_install_dispatch_table_for_class (Class);
+static void __objc_install_dispatch_table_if_needed (Class);
 
 /* Forward declare some functions */
 static void __objc_init_install_dtable(id, SEL);
@@ -95,16 +114,17 @@ __inline__
 IMP
 get_imp (Class class, SEL sel)
 {
-  void* res = sarray_get_safe (class->dtable, (size_t) sel->sel_id);
+  /* Look at the dispatch table only once; another thread may put a
+     new one in its place meanwhile.  */
+  struct sarray* dtable = class->dtable;
+  void* res = sarray_get_safe (dtable, (size_t) sel->sel_id);
   if (res == 0)
     {
       /* Not a valid method */
-      if(class->dtable == __objc_uninstalled_dtable)
+      if(dtable == __objc_uninstalled_dtable)
 	{
 	  /* The dispatch table needs to be installed. */
-	  objc_mutex_lock(__objc_runtime_mutex);
-	  __objc_install_dispatch_table_for_class (class);
-	  objc_mutex_unlock(__objc_runtime_mutex);
+	  __objc_install_dispatch_table_if_needed (class);
 	  /* Call ourselves with the installed dispatch table
 	     and get the real method */
 	  res = get_imp(class, sel);
@@ -131,11 +151,7 @@ __objc_responds_to (id object, SEL sel)
 
   /* Install dispatch table if need be */
   if (object->class_pointer->dtable == __objc_uninstalled_dtable)
-    {
-      objc_mutex_lock(__objc_runtime_mutex);
-      __objc_install_dispatch_table_for_class (object->class_pointer);
-      objc_mutex_unlock(__objc_runtime_mutex);
-    }
+    __objc_install_dispatch_table_if_needed (object->class_pointer);
 
   /* Get the method from the dispatch table */
   res = sarray_get_safe (object->class_pointer->dtable, (size_t) sel->sel_id);
@@ -152,12 +168,13 @@ objc_msg_lookup(id receiver, SEL op)
   IMP result;
   if(receiver)
     {
-      result = sarray_get_safe (receiver->class_pointer->dtable, 
-				(sidx)op->sel_id);
+      /* Look at the dispatch table only once, as in get_imp.  */
+      struct sarray* dtable = receiver->class_pointer->dtable;
+      result = sarray_get_safe (dtable, (sidx)op->sel_id);
       if (result == 0)
 	{
 	  /* Not a valid method */
-	  if(receiver->class_pointer->dtable == __objc_uninstalled_dtable)
+	  if(dtable == __objc_uninstalled_dtable)
 	    {
 	      /* The dispatch table needs to be installed.
 		 This happens on the very first method call to the class. */
@@ -223,6 +240,13 @@ __objc_init_install_dtable(id receiver, SEL op)
 
   objc_mutex_lock(__objc_runtime_mutex);
 
+  /* Another thread may have installed it while we waited.  */
+  if(receiver->class_pointer->dtable != __objc_uninstalled_dtable)
+    {
+      objc_mutex_unlock(__objc_runtime_mutex);
+      return;
+    }
+
   if(CLS_ISCLASS(receiver->class_pointer))
     {
       /* receiver is an ordinary object */
@@ -316,9 +340,11 @@ __objc_send_initialize(Class class)
    of class in the methods list, this allows categories to substitute methods
    declared in class. However if more than one category replaces the same
    method nothing is guaranteed about what method will be used.
+   The methods go into DTABLE, which is not yet the class's.
    Assumes that __objc_runtime_mutex is locked down. */
 static void
-__objc_install_methods_in_dtable (Class class, MethodList_t method_list)
+__objc_install_methods_in_dtable (struct sarray *dtable,
+				  MethodList_t method_list)
 {
   int i;
 
@@ -326,22 +352,27 @@ __objc_install_methods_in_dtable (Class class, MethodList_t method_list)
     return;
 
   if (method_list->method_next)
-    __objc_install_methods_in_dtable (class, method_list->method_next);
+    __objc_install_methods_in_dtable (dtable, method_list->method_next);
 
   for (i = 0; i < method_list->method_count; i++)
     {
       Method_t method = &(method_list->method_list[i]);
-      sarray_at_put_safe (class->dtable,
+      sarray_at_put_safe (dtable,
 			  (sidx) method->method_name->sel_id,
 			  method->method_imp);
     }
 }
 
-/* Assumes that __objc_runtime_mutex is locked down. */
+/* Build the dispatch table of CLASS and put it in place of the one it
+   has, which the caller must free unless it is the uninstalled one.
+   Messages sent to the class meanwhile still find the old table
+   complete.
+   Assumes that __objc_runtime_mutex is locked down. */
 static void
 __objc_install_dispatch_table_for_class (Class class)
 {
   Class super;
+  struct sarray *dtable;
 
   /* If the class has not yet had its class links resolved, we must 
      re-compute all class links */
@@ -357,13 +388,27 @@ __objc_install_dispatch_table_for_class (Class class)
   if (super == 0)
     {
       objc_mutex_lock(__objc_runtime_mutex);
-      class->dtable = sarray_new (__objc_selector_max_index, 0);
+      dtable = sarray_new (__objc_selector_max_index, 0);
       objc_mutex_unlock(__objc_runtime_mutex);
     }
   else
-    class->dtable = sarray_lazy_copy (super->dtable);
+    dtable = sarray_lazy_copy (super->dtable);
+
+  __objc_install_methods_in_dtable (dtable, class->methods);
 
-  __objc_install_methods_in_dtable (class, class->methods);
+  __objc_write_barrier ();
+  class->dtable = dtable;
+}
+
+/* Install the dispatch table of CLASS unless another thread has done
+   it first.  */
+static void
+__objc_install_dispatch_table_if_needed (Class class)
+{
+  objc_mutex_lock(__objc_runtime_mutex);
+  if (class->dtable == __objc_uninstalled_dtable)
+    __objc_install_dispatch_table_for_class (class);
+  objc_mutex_unlock(__objc_runtime_mutex);
 }
 
 void
@@ -378,12 +423,13 @@ __objc_update_dispatch_table_for_class (Class class)
 
   objc_mutex_lock(__objc_runtime_mutex);
 
+  /* The old table stays in place until the new one is complete, so
+     that messages need not wait for the update.  Threads that still
+     use it are safe too: sarray_free leaves it on the garbage list
+     while more than one thread is alive.  */
   arr = class->dtable;
-  __objc_install_premature_dtable (class); /* someone might require it... */
-  sarray_free (arr);			   /* release memory */
-
-  /* could have been lazy... */
   __objc_install_dispatch_table_for_class (class); 
+  sarray_free (arr);			   /* release memory */
 
   if (class->subclass_list)	/* Traverse subclasses */
     for (next = class->subclass_list; next; next = next->sibling_class)
@@ -1462,6 +1462,21 @@ extern void regmove_optimize		PROTO ((rtx, int, FILE *));
 extern void dbr_schedule		PROTO ((rtx, FILE *));
 #endif
 
+/* In modulo-sched.c */
+#ifdef BUFSIZ
+extern void modulo_schedule_loops	PROTO ((rtx, FILE *));
+#endif
+
+/* In vectorize.c */
+#ifdef BUFSIZ
+extern void vectorize_loops		PROTO ((rtx, FILE *));
+#endif
+
+/* In bb-reorder.c */
+#ifdef BUFSIZ
+extern void reorder_basic_blocks	PROTO ((rtx, FILE *));
+#endif
+
 /* In optabs.c */
 extern void init_optabs			PROTO ((void));
 
@@ -1544,6 +1559,7 @@ extern int true_dependence		PROTO ((rtx, enum machine_mode, rtx,
 extern int read_dependence		PROTO ((rtx, rtx));
 extern int anti_dependence		PROTO ((rtx, rtx));
 extern int output_dependence		PROTO ((rtx, rtx));
+extern int loop_dependence		PROTO ((rtx, rtx));
 extern void init_alias_once		PROTO ((void));
 extern void init_alias_analysis		PROTO ((void));
 extern void end_alias_analysis		PROTO ((void));
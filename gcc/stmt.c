@@ -62,6 +62,35 @@ struct obstack stmt_obstack;
 #define CASE_VECTOR_PC_RELATIVE 0
 #endif
 
+#ifndef CASE_VALUES_THRESHOLD
+#ifdef HAVE_casesi
+#define CASE_VALUES_THRESHOLD (HAVE_casesi ? 4 : 5)
+#else
+/* If machine does not have a case insn that compares the
+   bounds, this means extra overhead for dispatch tables
+   which raises the threshold for using them.  */
+#define CASE_VALUES_THRESHOLD 5
+#endif /* HAVE_casesi */
+#endif /* CASE_VALUES_THRESHOLD */
+
+/* The number of instructions it takes to jump through a dispatch table
+   once the index is known to be in range and the lowest value has been
+   subtracted from it.  */
+#ifndef CASE_TABLEJUMP_COST
+#define CASE_TABLEJUMP_COST 4
+#endif
+
+/* The number of instructions it takes to use the CONST_INT X, a case
+   value or the mask of a bit test, in a comparison or an AND with rtx
+   code CODE.  rtx_cost counts N instructions as COSTS_N_INSNS (N).  */
+#ifndef CASE_CONST_COST
+#define CASE_CONST_COST(X, CODE) ((rtx_cost ((X), (CODE)) + 2) / 4)
+#endif
+
+/* The largest number of different labels that one set of bit tests
+   dispatches to in a switch statement.  */
+#define MAX_CASE_BIT_TESTS 3
+
 /* Filename and line number of last line-number note,
    whether we actually emitted it or not.  */
 char *emit_filename;
@@ -161,6 +190,8 @@ struct case_node
   tree			high;	/* Highest index value for this label */
   tree			code_label; /* Label to jump to when node matches */
   int			balance;
+  struct case_node	*cluster; /* Nodes this one stands for, if any */
+  int			bit_test; /* Nonzero if CLUSTER uses bit tests */
 };
 
 typedef struct case_node case_node;
@@ -444,6 +475,20 @@ static int node_has_high_bound		PROTO((case_node_ptr, tree));
 static int node_is_bounded		PROTO((case_node_ptr, tree));
 static void emit_jump_if_reachable	PROTO((rtx));
 static void emit_case_nodes		PROTO((rtx, case_node_ptr, rtx, tree));
+static int case_const_cost		PROTO((rtx, enum rtx_code));
+static int case_node_cost		PROTO((case_node_ptr));
+static int case_bit_test_masks		PROTO((case_node_ptr, case_node_ptr,
+					       tree *,
+					       unsigned HOST_WIDE_INT *));
+static rtx case_bit_test_mask		PROTO((unsigned HOST_WIDE_INT));
+static int case_bit_test_cost		PROTO((case_node_ptr, case_node_ptr,
+					       unsigned HOST_WIDE_INT));
+static int case_table_cost		PROTO((unsigned HOST_WIDE_INT));
+static int cluster_case_nodes		PROTO((case_node_ptr *, tree, int, int,
+					       case_node_ptr *));
+static void emit_case_table		PROTO((case_node_ptr, tree,
+					       HOST_WIDE_INT, rtx, rtx));
+static void emit_case_cluster		PROTO((rtx, case_node_ptr, rtx, int));
 static int add_case_node		PROTO((tree, tree, tree, tree *));
 static struct case_node *case_tree2list	PROTO((case_node *, case_node *));
 
@@ -4163,6 +4208,8 @@ add_case_node (low, high, label, duplicate)
     }
 
   r->code_label = label;
+  r->cluster = 0;
+  r->bit_test = 0;
   expand_label (label);
 
   *q = r;
@@ -4705,19 +4752,21 @@ void
 expand_end_case (orig_index)
      tree orig_index;
 {
-  tree minval, maxval, range, orig_minval;
+  tree minval = 0, maxval = 0, range = 0, orig_minval;
   rtx default_label = 0;
   register struct case_node *n;
   unsigned int count;
   rtx index;
   rtx table_label;
   int ncases;
-  rtx *labelvec;
   register int i;
   rtx before_case;
   register struct nesting *thiscase = case_stack;
   tree index_expr, index_type;
   int unsignedp;
+  int const_index;
+  int nclusters = -1;
+  case_node_ptr *clusters;
 
   table_label = gen_label_rtx ();
   index_expr = thiscase->data.case_stmt.index_expr;
@@ -4809,6 +4858,61 @@ expand_end_case (orig_index)
 
       end_cleanup_deferral ();
 
+      /* If the switch-index is a constant, make a sequence of
+	 conditional branches because we can optimize it.  */
+      const_index
+	= (TREE_CODE (index_expr) == INTEGER_CST
+	   /* These will reduce to a constant.  */
+	   || (TREE_CODE (index_expr) == CALL_EXPR
+	       && TREE_CODE (TREE_OPERAND (index_expr, 0)) == ADDR_EXPR
+	       && TREE_CODE (TREE_OPERAND (TREE_OPERAND (index_expr, 0), 0)) == FUNCTION_DECL
+	       && DECL_FUNCTION_CODE (TREE_OPERAND (TREE_OPERAND (index_expr, 0), 0)) == BUILT_IN_CLASSIFY_TYPE)
+	   || (TREE_CODE (index_expr) == COMPOUND_EXPR
+	       && TREE_CODE (TREE_OPERAND (index_expr, 1)) == INTEGER_CST));
+
+      /* Otherwise split the case values into clusters that are each
+	 dispatched on by a jump table or by a few bit tests, and single
+	 values and ranges that are tested for on their own.  If one
+	 jump table does for the whole switch, NCLUSTERS is left -1.  */
+      clusters = (case_node_ptr *) alloca ((count + 1)
+					  * sizeof (case_node_ptr));
+      if (count != 0 && ! const_index)
+	{
+	  int tables = 0, bit_tests = 0;
+
+	  if (TREE_INT_CST_HIGH (range) == 0
+#ifndef ASM_OUTPUT_ADDR_DIFF_ELT
+	      && ! flag_pic
+#endif
+	      )
+	    {
+	      tables = 1;
+	      /* The tables of clusters are dispatched on with tablejump.
+		 A target that has casesi may need it, as i386 does with
+		 -fpic, so it gets a table only for the whole switch.  */
+#ifdef HAVE_tablejump
+	      if (HAVE_tablejump
+#ifdef HAVE_casesi
+		  && ! HAVE_casesi
+#endif
+		  && (GET_MODE_BITSIZE (TYPE_MODE (index_type))
+		      <= BITS_PER_WORD))
+		tables = 2;
+#endif
+	    }
+	  if (TREE_INT_CST_HIGH (range) == 0
+	      && GET_MODE_BITSIZE (TYPE_MODE (index_type)) <= BITS_PER_WORD
+	      && BITS_PER_WORD <= HOST_BITS_PER_WIDE_INT)
+	    bit_tests = 1;
+
+	  if (tables || bit_tests)
+	    nclusters
+	      = cluster_case_nodes (&thiscase->data.case_stmt.case_list,
+				    orig_minval, tables, bit_tests, clusters);
+	  else
+	    nclusters = 0;
+	}
+
       if (count == 0)
 	{
 	  expand_expr (index_expr, const0_rtx, VOIDmode, 0);
@@ -4817,36 +4921,10 @@ expand_end_case (orig_index)
 	}
 
       /* If range of values is much bigger than number of values,
-	 make a sequence of conditional branches instead of a dispatch.
-	 If the switch-index is a constant, do it this way
-	 because we can optimize it.  */
+	 or the values fall into several clusters,
+	 make a sequence of conditional branches instead of a dispatch.  */
 
-#ifndef CASE_VALUES_THRESHOLD
-#ifdef HAVE_casesi
-#define CASE_VALUES_THRESHOLD (HAVE_casesi ? 4 : 5)
-#else
-      /* If machine does not have a case insn that compares the
-	 bounds, this means extra overhead for dispatch tables
-	 which raises the threshold for using them.  */
-#define CASE_VALUES_THRESHOLD 5
-#endif /* HAVE_casesi */
-#endif /* CASE_VALUES_THRESHOLD */
-
-      else if (TREE_INT_CST_HIGH (range) != 0
-	       || count < CASE_VALUES_THRESHOLD
-	       || ((unsigned HOST_WIDE_INT) (TREE_INT_CST_LOW (range))
-		   > 10 * count)
-#ifndef ASM_OUTPUT_ADDR_DIFF_ELT
-	       || flag_pic
-#endif
-	       || TREE_CODE (index_expr) == INTEGER_CST
-	       /* These will reduce to a constant.  */
-	       || (TREE_CODE (index_expr) == CALL_EXPR
-		   && TREE_CODE (TREE_OPERAND (index_expr, 0)) == ADDR_EXPR
-		   && TREE_CODE (TREE_OPERAND (TREE_OPERAND (index_expr, 0), 0)) == FUNCTION_DECL
-		   && DECL_FUNCTION_CODE (TREE_OPERAND (TREE_OPERAND (index_expr, 0), 0)) == BUILT_IN_CLASSIFY_TYPE)
-	       || (TREE_CODE (index_expr) == COMPOUND_EXPR
-		   && TREE_CODE (TREE_OPERAND (index_expr, 1)) == INTEGER_CST))
+      else if (const_index || nclusters >= 0)
 	{
 	  index = expand_expr (index_expr, NULL_RTX, VOIDmode, 0);
 
@@ -4899,6 +4977,15 @@ expand_end_case (orig_index)
 		    && ! tree_int_cst_lt (n->high, index_expr))
 		  break;
 
+	      /* The index may have turned out to be constant only once
+		 it was expanded, after the nodes were clustered; look
+		 for the value among the nodes of its cluster.  */
+	      if (n && n->cluster)
+		for (n = n->cluster; n; n = n->right)
+		  if (! tree_int_cst_lt (index_expr, n->low)
+		      && ! tree_int_cst_lt (n->high, index_expr))
+		    break;
+
 	      if (n)
 		emit_jump (label_rtx (n->code_label));
 	      else
@@ -4918,16 +5005,35 @@ expand_end_case (orig_index)
 
 		 If program flow could reach the end of the
 		 decision tree an unconditional jump to the
-		 default code is emitted.  */
-
-	      use_cost_table
-		= (TREE_CODE (TREE_TYPE (orig_index)) != ENUMERAL_TYPE
-		   && estimate_case_costs (thiscase->data.case_stmt.case_list));
-	      balance_case_nodes (&thiscase->data.case_stmt.case_list, 
-				  NULL_PTR);
-	      emit_case_nodes (index, thiscase->data.case_stmt.case_list,
-			       default_label, index_type);
-	      emit_jump_if_reachable (default_label);
+		 default code is emitted.
+
+		 The tree branches to the label of a cluster only for
+		 values within its range, so the jump table or bit tests
+		 of the cluster are emitted after the tree without a
+		 range check of their own.  A cluster that makes up the
+		 whole switch needs no tree at all.  */
+
+	      if (nclusters == 1
+		  && thiscase->data.case_stmt.case_list == clusters[0]
+		  && clusters[0]->right == 0)
+		emit_case_cluster (index, clusters[0], default_label, 0);
+	      else
+		{
+		  use_cost_table
+		    = (TREE_CODE (TREE_TYPE (orig_index)) != ENUMERAL_TYPE
+		       && estimate_case_costs (thiscase->data.case_stmt.case_list));
+		  balance_case_nodes (&thiscase->data.case_stmt.case_list, 
+				      NULL_PTR);
+		  emit_case_nodes (index, thiscase->data.case_stmt.case_list,
+				   default_label, index_type);
+		  emit_jump_if_reachable (default_label);
+
+		  for (i = 0; i < nclusters; i++)
+		    {
+		      expand_label (clusters[i]->code_label);
+		      emit_case_cluster (index, clusters[i], default_label, 1);
+		    }
+		}
 	    }
 	}
       else
@@ -5018,53 +5124,9 @@ expand_end_case (orig_index)
 	  if (! win)
 	    abort ();
 
-	  /* Get table of labels to jump to, in order of case index.  */
-
 	  ncases = TREE_INT_CST_LOW (range) + 1;
-	  labelvec = (rtx *) alloca (ncases * sizeof (rtx));
-	  bzero ((char *) labelvec, ncases * sizeof (rtx));
-
-	  for (n = thiscase->data.case_stmt.case_list; n; n = n->right)
-	    {
-	      register HOST_WIDE_INT i
-		= TREE_INT_CST_LOW (n->low) - TREE_INT_CST_LOW (orig_minval);
-
-	      while (1)
-		{
-		  labelvec[i]
-		    = gen_rtx_LABEL_REF (Pmode, label_rtx (n->code_label));
-		  if (i + TREE_INT_CST_LOW (orig_minval)
-		      == TREE_INT_CST_LOW (n->high))
-		    break;
-		  i++;
-		}
-	    }
-
-	  /* Fill in the gaps with the default.  */
-	  for (i = 0; i < ncases; i++)
-	    if (labelvec[i] == 0)
-	      labelvec[i] = gen_rtx_LABEL_REF (Pmode, default_label);
-
-	  /* Output the table */
-	  emit_label (table_label);
-
-	  if (CASE_VECTOR_PC_RELATIVE || flag_pic)
-	    emit_jump_insn (gen_rtx_ADDR_DIFF_VEC (CASE_VECTOR_MODE,
-						   gen_rtx_LABEL_REF (Pmode, table_label),
-						   gen_rtvec_v (ncases, labelvec),
-						    const0_rtx, const0_rtx, 0));
-	  else
-	    emit_jump_insn (gen_rtx_ADDR_VEC (CASE_VECTOR_MODE,
-					      gen_rtvec_v (ncases, labelvec)));
-
-	  /* If the case insn drops through the table,
-	     after the table we must jump to the default-label.
-	     Otherwise record no drop-through after the table.  */
-#ifdef CASE_DROPS_THROUGH
-	  emit_jump (default_label);
-#else
-	  emit_barrier ();
-#endif
+	  emit_case_table (thiscase->data.case_stmt.case_list, orig_minval,
+			   ncases, table_label, default_label);
 	}
 
       before_case = squeeze_notes (NEXT_INSN (before_case), get_last_insn ());
@@ -5105,6 +5167,68 @@ case_tree2list (node, right)
   return node;
 }
 
+/* Output a dispatch table, labeled TABLE_LABEL, of NCASES entries for
+   the consecutive values starting at MINVAL.  The entries come from the
+   list of case nodes NODES, and are DEFAULT_LABEL for values that no
+   node covers.  */
+
+static void
+emit_case_table (nodes, minval, ncases, table_label, default_label)
+     case_node_ptr nodes;
+     tree minval;
+     HOST_WIDE_INT ncases;
+     rtx table_label, default_label;
+{
+  register case_node_ptr n;
+  register HOST_WIDE_INT i;
+  rtx *labelvec;
+
+  /* Get table of labels to jump to, in order of case index.  */
+
+  labelvec = (rtx *) alloca (ncases * sizeof (rtx));
+  bzero ((char *) labelvec, ncases * sizeof (rtx));
+
+  for (n = nodes; n; n = n->right)
+    {
+      i = TREE_INT_CST_LOW (n->low) - TREE_INT_CST_LOW (minval);
+
+      while (1)
+	{
+	  labelvec[i]
+	    = gen_rtx_LABEL_REF (Pmode, label_rtx (n->code_label));
+	  if (i + TREE_INT_CST_LOW (minval) == TREE_INT_CST_LOW (n->high))
+	    break;
+	  i++;
+	}
+    }
+
+  /* Fill in the gaps with the default.  */
+  for (i = 0; i < ncases; i++)
+    if (labelvec[i] == 0)
+      labelvec[i] = gen_rtx_LABEL_REF (Pmode, default_label);
+
+  /* Output the table */
+  emit_label (table_label);
+
+  if (CASE_VECTOR_PC_RELATIVE || flag_pic)
+    emit_jump_insn (gen_rtx_ADDR_DIFF_VEC (CASE_VECTOR_MODE,
+					   gen_rtx_LABEL_REF (Pmode, table_label),
+					   gen_rtvec_v (ncases, labelvec),
+					   const0_rtx, const0_rtx, 0));
+  else
+    emit_jump_insn (gen_rtx_ADDR_VEC (CASE_VECTOR_MODE,
+				      gen_rtvec_v (ncases, labelvec)));
+
+  /* If the case insn drops through the table,
+     after the table we must jump to the default-label.
+     Otherwise record no drop-through after the table.  */
+#ifdef CASE_DROPS_THROUGH
+  emit_jump (default_label);
+#else
+  emit_barrier ();
+#endif
+}
+
 /* Generate code to jump to LABEL if OP1 and OP2 are equal.  */
 
 static void
@@ -5256,6 +5380,335 @@ group_case_nodes (head)
     }
 }
 
+/* Return the number of instructions it takes to use the constant X in
+   a comparison or an AND with rtx code CODE.  */
+
+static int
+case_const_cost (x, code)
+     rtx x;
+     enum rtx_code code;
+{
+  if (GET_CODE (x) != CONST_INT)
+    return (rtx_cost (x, code) + 2) / 4;
+
+  return CASE_CONST_COST (x, code);
+}
+
+/* Return the number of instructions it takes emit_case_nodes to test
+   the index of a switch against NODE.  */
+
+static int
+case_node_cost (node)
+     case_node_ptr node;
+{
+  rtx low = expand_expr (node->low, NULL_RTX, VOIDmode, 0);
+  rtx high;
+
+  if (tree_int_cst_equal (node->low, node->high))
+    return case_const_cost (low, EQ) + BRANCH_COST;
+
+  high = expand_expr (node->high, NULL_RTX, VOIDmode, 0);
+  return (case_const_cost (low, LT) + case_const_cost (high, GT)
+	  + 2 * (1 + BRANCH_COST));
+}
+
+/* Work out the bit tests for the case nodes from FIRST up to but not
+   including LAST, whose values must all lie within BITS_PER_WORD of
+   the lowest one.  Store the different labels of the nodes in LABELS,
+   and for each, the mask of the values that go to it, counted from
+   the lowest one, in MASKS.  Labels that are followed by the same code,
+   as those of several case labels in a row are, count as one.  Return
+   the number of labels, or zero if there are more than
+   MAX_CASE_BIT_TESTS of them.  */
+
+static int
+case_bit_test_masks (first, last, labels, masks)
+     case_node_ptr first, last;
+     tree *labels;
+     unsigned HOST_WIDE_INT *masks;
+{
+  unsigned HOST_WIDE_INT base = TREE_INT_CST_LOW (first->low);
+  unsigned HOST_WIDE_INT low, high;
+  rtx targets[MAX_CASE_BIT_TESTS];
+  rtx target;
+  case_node_ptr n;
+  int nlabels = 0;
+  int i;
+
+  for (n = first; n != last; n = n->right)
+    {
+      target = next_real_insn (label_rtx (n->code_label));
+      for (i = 0; i < nlabels; i++)
+	if (labels[i] == n->code_label || targets[i] == target)
+	  break;
+
+      if (i == nlabels)
+	{
+	  if (nlabels == MAX_CASE_BIT_TESTS)
+	    return 0;
+	  labels[nlabels] = n->code_label;
+	  targets[nlabels] = target;
+	  masks[nlabels++] = 0;
+	}
+
+      low = TREE_INT_CST_LOW (n->low) - base;
+      high = TREE_INT_CST_LOW (n->high) - base;
+      for (; low <= high; low++)
+	masks[i] |= (unsigned HOST_WIDE_INT) 1 << low;
+    }
+
+  return nlabels;
+}
+
+/* Return the constant for the bit test MASK in word_mode.  */
+
+static rtx
+case_bit_test_mask (mask)
+     unsigned HOST_WIDE_INT mask;
+{
+  /* Sign-extend the mask from the width of a word, so that it is a
+     valid CONST_INT for word_mode.  */
+  if (BITS_PER_WORD < HOST_BITS_PER_WIDE_INT
+      && (mask & ((unsigned HOST_WIDE_INT) 1 << (BITS_PER_WORD - 1))))
+    mask |= (unsigned HOST_WIDE_INT) -1 << BITS_PER_WORD;
+
+  return GEN_INT (mask);
+}
+
+/* Return the number of instructions it takes to dispatch with bit tests
+   on the case nodes from FIRST up to but not including LAST, whose
+   values span RANGE + 1 values, or -1 if there are too many labels.  */
+
+static int
+case_bit_test_cost (first, last, range)
+     case_node_ptr first, last;
+     unsigned HOST_WIDE_INT range;
+{
+  tree labels[MAX_CASE_BIT_TESTS];
+  unsigned HOST_WIDE_INT masks[MAX_CASE_BIT_TESTS];
+  int nlabels = case_bit_test_masks (first, last, labels, masks);
+  int cost, i;
+
+  if (nlabels == 0)
+    return -1;
+
+  /* Subtract the lowest value, check the range and shift a bit into
+     place; then mask the bit and branch once for each label.  */
+  cost = (1 + case_const_cost (GEN_INT (range), GTU) + 1 + BRANCH_COST + 2);
+  for (i = 0; i < nlabels; i++)
+    cost += (case_const_cost (case_bit_test_mask (masks[i]), AND)
+	     + 1 + BRANCH_COST);
+
+  return cost;
+}
+
+/* Return the number of instructions it takes to dispatch through a jump
+   table for RANGE + 1 values.  */
+
+static int
+case_table_cost (range)
+     unsigned HOST_WIDE_INT range;
+{
+  return (1 + case_const_cost (GEN_INT (range), GTU) + 1 + BRANCH_COST
+	  + CASE_TABLEJUMP_COST);
+}
+
+/* Split the ordered list of case nodes *HEAD into clusters: runs of
+   nodes that are dispatched on by one jump table or by one set of bit
+   tests, and single nodes that are tested for on their own.  The
+   values of the nodes must differ from MINVAL by less than the range of
+   a HOST_WIDE_INT.
+
+   The clusters are chosen so that there are as few of them as possible,
+   which keeps the decision tree that selects between them small, and
+   among those, so that they take the fewest instructions according to
+   the target's costs.  Like a jump table for the whole switch, a table
+   must be for at least CASE_VALUES_THRESHOLD values and be at least a
+   tenth full; it also must not have a hole wider than the number of
+   values it holds, since splitting it there saves more space than the
+   extra test costs.  Bit tests can only be used for values that lie
+   within a word of each other, and only when they are cheaper than
+   testing for each value in turn.
+
+   If TABLES is 0, no jump tables can be used; if it is 1, only one for
+   the whole switch.  If BIT_TESTS is zero, no bit tests can be used.
+
+   If one jump table does for the whole switch, return -1 and leave the
+   list alone.  Otherwise, replace every cluster of the list by a node
+   for the range of its values, with a new label and with the nodes of
+   the cluster in its CLUSTER field; store those nodes in CLUSTERS and
+   return their number.  */
+
+static int
+cluster_case_nodes (head, minval, tables, bit_tests, clusters)
+     case_node_ptr *head;
+     tree minval;
+     int tables, bit_tests;
+     case_node_ptr *clusters;
+{
+  unsigned HOST_WIDE_INT base = TREE_INT_CST_LOW (minval);
+  unsigned HOST_WIDE_INT low, high, top, next_low, span, gap, nvalues;
+  case_node_ptr n, list, *nodes;
+  int *node_cost, *best_count, *best_cost, *best_start, *best_kind;
+  int count, values, tested, cost, i, j, nclusters;
+
+  for (count = 0, n = *head; n; n = n->right)
+    count++;
+
+  /* A single node is best tested for on its own.  */
+  if (count < 2)
+    return 0;
+
+  nodes = (case_node_ptr *) alloca (count * sizeof (case_node_ptr));
+  for (i = 0, n = *head; n; n = n->right)
+    nodes[i++] = n;
+
+  /* If the whole switch is dense enough for a jump table and too wide
+     for bit tests, that is the best there is.  This catches large dense
+     switches before the quadratic search below.  */
+  values = 0;
+  nvalues = 0;
+  gap = 0;
+  for (i = 0; i < count; i++)
+    {
+      low = TREE_INT_CST_LOW (nodes[i]->low) - base;
+      high = TREE_INT_CST_LOW (nodes[i]->high) - base;
+      values += low == high ? 1 : 2;
+      nvalues += high - low + 1;
+      if (i > 0)
+	{
+	  next_low = TREE_INT_CST_LOW (nodes[i - 1]->high) - base;
+	  if (low - next_low - 1 > gap)
+	    gap = low - next_low - 1;
+	}
+    }
+  span = (TREE_INT_CST_LOW (nodes[count - 1]->high)
+	  - TREE_INT_CST_LOW (nodes[0]->low));
+  if (tables
+      && values >= CASE_VALUES_THRESHOLD
+      && span <= (unsigned HOST_WIDE_INT) 10 * values
+      && gap <= nvalues
+      && (! bit_tests || span >= BITS_PER_WORD))
+    return -1;
+
+  /* BEST_COUNT[I] and BEST_COST[I] are the number of clusters and
+     their cost in the best way found to split the first I nodes;
+     the last cluster of that starts at node BEST_START[I] and is a
+     single node, a jump table or bit tests as BEST_KIND[I] is 0, 1
+     or 2.  */
+  node_cost = (int *) alloca (count * sizeof (int));
+  best_count = (int *) alloca ((count + 1) * sizeof (int));
+  best_cost = (int *) alloca ((count + 1) * sizeof (int));
+  best_start = (int *) alloca ((count + 1) * sizeof (int));
+  best_kind = (int *) alloca ((count + 1) * sizeof (int));
+
+  for (i = 0; i < count; i++)
+    node_cost[i] = case_node_cost (nodes[i]);
+
+  best_count[0] = 0;
+  best_cost[0] = 0;
+
+#define CONSIDER_CLUSTER(START, KIND, COST)				\
+  do {									\
+    int c_ = best_count[START] + 1, k_ = best_cost[START] + (COST);	\
+    if (c_ < best_count[i] || (c_ == best_count[i] && k_ < best_cost[i])) \
+      {									\
+	best_count[i] = c_;						\
+	best_cost[i] = k_;						\
+	best_start[i] = (START);					\
+	best_kind[i] = (KIND);						\
+      }									\
+  } while (0)
+
+  for (i = 1; i <= count; i++)
+    {
+      top = TREE_INT_CST_LOW (nodes[i - 1]->high) - base;
+      values = 0;
+      nvalues = 0;
+      gap = 0;
+      tested = 0;
+      next_low = 0;
+
+      best_count[i] = count + 1;
+      best_cost[i] = 0;
+
+      for (j = i - 1; j >= 0; j--)
+	{
+	  low = TREE_INT_CST_LOW (nodes[j]->low) - base;
+	  high = TREE_INT_CST_LOW (nodes[j]->high) - base;
+	  span = top - low;
+	  values += low == high ? 1 : 2;
+	  nvalues += high - low + 1;
+	  if (j < i - 1 && next_low - high - 1 > gap)
+	    gap = next_low - high - 1;
+	  next_low = low;
+
+	  /* Testing for the nodes one at a time costs this much, plus
+	     about one ordering test for every two nodes in the tree.  */
+	  tested += node_cost[j];
+	  cost = tested + (i - 1 - j) / 2 * (1 + BRANCH_COST);
+
+	  if (j == i - 1)
+	    CONSIDER_CLUSTER (j, 0, node_cost[j]);
+
+	  if (bit_tests && span < BITS_PER_WORD && j < i - 1)
+	    {
+	      int bit_cost = case_bit_test_cost (nodes[j], nodes[i - 1]->right,
+						 span);
+
+	      if (bit_cost >= 0 && bit_cost < cost)
+		CONSIDER_CLUSTER (j, 2, bit_cost);
+	    }
+
+	  if ((tables == 2 || (tables == 1 && j == 0 && i == count))
+	      && values >= CASE_VALUES_THRESHOLD
+	      && span <= (unsigned HOST_WIDE_INT) 10 * values
+	      && gap <= nvalues)
+	    CONSIDER_CLUSTER (j, 1, case_table_cost (span));
+
+	  /* Give up once neither kind of cluster can reach any further
+	     back: each node adds at most two to VALUES.  */
+	  if ((! bit_tests || span >= BITS_PER_WORD)
+	      && (! tables
+		  || span > (unsigned HOST_WIDE_INT) 10 * (values + 2 * j)))
+	    break;
+	}
+    }
+
+#undef CONSIDER_CLUSTER
+
+  if (best_count[count] == 1 && best_kind[count] == 1)
+    return -1;
+
+  /* Rebuild the list from its end, making a node for each cluster.  */
+  list = 0;
+  nclusters = 0;
+  for (i = count; i > 0; i = j)
+    {
+      j = best_start[i];
+      if (best_kind[i] == 0)
+	n = nodes[j];
+      else
+	{
+	  n = (struct case_node *) oballoc (sizeof (struct case_node));
+	  n->low = nodes[j]->low;
+	  n->high = nodes[i - 1]->high;
+	  n->code_label = build_decl (LABEL_DECL, NULL_TREE, NULL_TREE);
+	  n->left = n->parent = 0;
+	  n->balance = 0;
+	  n->cluster = nodes[j];
+	  n->bit_test = best_kind[i] == 2;
+	  nodes[i - 1]->right = 0;
+	  clusters[nclusters++] = n;
+	}
+      n->right = list;
+      list = n;
+    }
+
+  *head = list;
+  return nclusters;
+}
+
 /* Take an ordered list of case nodes
    and transform them into a near optimal binary tree,
    on the assumption that any target code selection value is as
@@ -5801,6 +6254,107 @@ emit_case_nodes (index, node, default_label, index_type)
     }
 }
 
+/* Emit the jump table or the bit tests that dispatch on INDEX for the
+   cluster of case nodes NODE.  Values that none of the nodes of the
+   cluster covers go to DEFAULT_LABEL.  If CHECKED is nonzero, INDEX is
+   known to lie within the range of NODE.  */
+
+static void
+emit_case_cluster (index, node, default_label, checked)
+     rtx index;
+     case_node_ptr node;
+     rtx default_label;
+     int checked;
+{
+  enum machine_mode mode = GET_MODE (index);
+  unsigned HOST_WIDE_INT range
+    = TREE_INT_CST_LOW (node->high) - TREE_INT_CST_LOW (node->low);
+  rtx low = expand_expr (node->low, NULL_RTX, VOIDmode, 0);
+
+  if (low != const0_rtx)
+    index = expand_binop (mode, sub_optab, index, low, NULL_RTX, 0,
+			  OPTAB_WIDEN);
+
+  if (node->bit_test)
+    {
+      tree labels[MAX_CASE_BIT_TESTS];
+      unsigned HOST_WIDE_INT masks[MAX_CASE_BIT_TESTS];
+      int nbits[MAX_CASE_BIT_TESTS];
+      unsigned HOST_WIDE_INT all, mask;
+      int nlabels = case_bit_test_masks (node->cluster, NULL_PTR,
+					 labels, masks);
+      int covered, i, j, k;
+      rtx bits, test;
+      tree label;
+
+      if (nlabels == 0)
+	abort ();
+
+      /* Test for the labels with the most values first.  */
+      all = 0;
+      for (i = 0; i < nlabels; i++)
+	{
+	  all |= masks[i];
+	  for (nbits[i] = 0, mask = masks[i]; mask; mask &= mask - 1)
+	    nbits[i]++;
+	}
+      for (i = 0; i < nlabels; i++)
+	for (j = i + 1; j < nlabels; j++)
+	  if (nbits[j] > nbits[i])
+	    {
+	      k = nbits[i], nbits[i] = nbits[j], nbits[j] = k;
+	      mask = masks[i], masks[i] = masks[j], masks[j] = mask;
+	      label = labels[i], labels[i] = labels[j], labels[j] = label;
+	    }
+
+      /* If every value in the range goes to one of the labels, the
+	 last of them needs no test.  */
+      covered = (range + 1 < HOST_BITS_PER_WIDE_INT
+		 ? all == ((unsigned HOST_WIDE_INT) 1 << (range + 1)) - 1
+		 : all == (unsigned HOST_WIDE_INT) -1);
+
+      if (! checked)
+	{
+	  emit_cmp_insn (index, GEN_INT (range), GTU, NULL_RTX, mode, 1, 0);
+	  emit_jump_insn (gen_bgtu (default_label));
+	}
+
+      index = convert_to_mode (word_mode, index, 1);
+      bits = expand_binop (word_mode, ashl_optab, const1_rtx, index,
+			   NULL_RTX, 1, OPTAB_WIDEN);
+
+      for (i = 0; i < nlabels; i++)
+	{
+	  if (covered && i == nlabels - 1)
+	    {
+	      emit_jump (label_rtx (labels[i]));
+	      return;
+	    }
+
+	  test = expand_binop (word_mode, and_optab, bits,
+			       case_bit_test_mask (masks[i]), NULL_RTX, 1,
+			       OPTAB_WIDEN);
+	  emit_cmp_insn (test, const0_rtx, NE, NULL_RTX, word_mode, 1, 0);
+	  emit_jump_insn (gen_bne (label_rtx (labels[i])));
+	}
+
+      emit_jump (default_label);
+    }
+  else
+    {
+#ifdef HAVE_tablejump
+      rtx table_label = gen_label_rtx ();
+
+      do_tablejump (index, mode, GEN_INT (range), table_label,
+		    checked ? NULL_RTX : default_label);
+      emit_case_table (node->cluster, node->low, range + 1, table_label,
+		       default_label);
+#else
+      abort ();
+#endif
+    }
+}
+
 /* These routines are used by the loop unrolling code.  They copy BLOCK trees
    so that the debugging info will be correct for the unrolled loop.  */
 
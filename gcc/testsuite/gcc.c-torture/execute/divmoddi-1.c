@@ -0,0 +1,95 @@
+/* Check DImode multiplication, division and remainder on operands that
+   fit in a word, long numbers divided by a word, two long numbers and
+   powers of two.  Products are checked against shifts and adds.  */
+
+typedef unsigned long long UDI;
+typedef long long DI;
+
+static unsigned long state = 1;
+
+unsigned long
+random_word ()
+{
+  unsigned long high;
+
+  state = (state * 1103515245 + 12345) & 0xffffffff;
+  high = state >> 16;
+  state = (state * 1103515245 + 12345) & 0xffffffff;
+  return (high << 16 | state >> 16) & 0xffffffff;
+}
+
+UDI
+random_long ()
+{
+  UDI high = random_word ();
+
+  return high << 32 | random_word ();
+}
+
+UDI
+mul (a, b)
+     UDI a, b;
+{
+  UDI r = 0;
+
+  for (; b != 0; b >>= 1, a <<= 1)
+    if (b & 1)
+      r += a;
+  return r;
+}
+
+void
+check_unsigned (n, d)
+     UDI n, d;
+{
+  UDI q = n / d, r = n % d;
+
+  if (r >= d || mul (q, d) + r != n)
+    abort ();
+  if (n * d != mul (n, d))
+    abort ();
+}
+
+void
+check_signed (n, d)
+     DI n, d;
+{
+  DI q = n / d, r = n % d;
+
+  if ((DI) mul (q, d) + r != n)
+    abort ();
+  if (r != 0 && (r < 0) != (n < 0))
+    abort ();
+  if ((r < 0 ? -r : r) >= (d < 0 ? -d : d))
+    abort ();
+}
+
+main ()
+{
+  int i;
+
+  for (i = 0; i < 1000; i++)
+    {
+      UDI n, d;
+
+      n = random_word ();
+      d = (random_word () >> (i % 24)) | 1;
+      check_unsigned (n, d);
+      check_signed ((DI) n, (DI) d);
+
+      n = random_long ();
+      check_unsigned (n, d);
+      check_signed ((DI) n, (DI) d);
+      check_signed ((DI) n, - (DI) d);
+
+      d = (random_long () >> (i % 24)) | ((UDI) 1 << 32);
+      check_unsigned (n, d);
+      check_signed ((DI) n, (DI) d);
+
+      d = (UDI) 1 << (i % 63);
+      check_unsigned (n, d);
+      if (n / d != n >> (i % 63) || n % d != (n & (d - 1)))
+	abort ();
+    }
+  exit (0);
+}
@@ -0,0 +1,126 @@
+/* Switch statements whose values fall into several dense clusters,
+   or that reach only a few labels, are lowered to several jump tables
+   or to bit tests.  Check every value around the edges of them.  */
+
+int
+vowel (int c)
+{
+  switch (c)
+    {
+    case 'a': case 'e': case 'i': case 'o': case 'u':
+      return 1;
+    }
+  return 0;
+}
+
+int
+token (unsigned char c)
+{
+  switch (c)
+    {
+    case ' ': case '\t': case '\n':
+      return 1;
+    case '0' ... '9':
+      return 2;
+    case '+': case '-': case '*': case '/':
+      return 3;
+    default:
+      return 0;
+    }
+}
+
+int
+opcode (int op)
+{
+  switch (op)
+    {
+    case -3: return 10;
+    case -2: return 11;
+    case -1: return 12;
+    case 0: return 13;
+    case 1: return 14;
+    case 2: return 15;
+    case 100: return 20;
+    case 101: return 21;
+    case 102: return 22;
+    case 103: return 23;
+    case 104: return 24;
+    case 106: return 26;
+    case 1000: return 30;
+    case 1001 ... 1010: return 31;
+    case 1011: return 32;
+    case 1012: return 33;
+    case 1013: return 34;
+    case 1014: return 35;
+    case 1015: return 36;
+    case 100000: return 40;
+    }
+  return -1;
+}
+
+int
+state (unsigned int s)
+{
+  switch (s)
+    {
+    case 0x80000000: case 0x80000002: case 0x80000004: case 0x80000006:
+    case 0x80000009:
+      return 1;
+    case 0x80000001: case 0x80000003:
+      return 2;
+    case 0x8000001f:
+      return 3;
+    case 0: case 1: case 2: case 3: case 4: case 5: case 6: case 7:
+      return 4;
+    }
+  return 0;
+}
+
+main ()
+{
+  int i;
+
+  for (i = -10; i < 300; i++)
+    if (vowel (i) != (i == 'a' || i == 'e' || i == 'i' || i == 'o'
+		      || i == 'u'))
+      abort ();
+
+  for (i = 0; i < 256; i++)
+    if (token (i) != (i == ' ' || i == '\t' || i == '\n' ? 1
+		      : i >= '0' && i <= '9' ? 2
+		      : i == '+' || i == '-' || i == '*' || i == '/' ? 3
+		      : 0))
+      abort ();
+
+  for (i = -10; i < 1100; i++)
+    if (opcode (i) != (i >= -3 && i <= 2 ? i + 13
+		       : i >= 100 && i <= 104 || i == 106 ? i - 80
+		       : i == 1000 ? 30
+		       : i >= 1001 && i <= 1010 ? 31
+		       : i >= 1011 && i <= 1015 ? i - 979
+		       : -1))
+      abort ();
+  if (opcode (100000) != 40 || opcode (99999) != -1
+      || opcode (-2147483647 - 1) != -1)
+    abort ();
+
+  for (i = -10; i < 40; i++)
+    {
+      unsigned int s = 0x80000000 + i;
+      int expect;
+
+      switch (i)
+	{
+	case 0: case 2: case 4: case 6: case 9: expect = 1; break;
+	case 1: case 3: expect = 2; break;
+	case 31: expect = 3; break;
+	default: expect = 0;
+	}
+      if (state (s) != expect)
+	abort ();
+      if (state (i) != (i >= 0 && i <= 7 ? 4 : 0))
+	abort ();
+    }
+
+  exit (0);
+}
@@ -0,0 +1,32 @@
+/* The index of this switch is known to be constant only once it has
+   been expanded, after its values have been split into clusters.  */
+
+int y;
+
+int
+f ()
+{
+  switch (__builtin_constant_p (y))
+    {
+    case 0: return 10;
+    case 1: return 11;
+    case 2: return 12;
+    case 3: return 13;
+    case 4: return 14;
+    case 5: return 15;
+    case 100: return 2;
+    case 200: return 3;
+    case 300: return 4;
+    case 1000: return 5;
+    case 2000: return 6;
+    case 3000: return 7;
+    }
+  return 0;
+}
+
+main ()
+{
+  if (f () != 10)
+    abort ();
+  exit (0);
+}
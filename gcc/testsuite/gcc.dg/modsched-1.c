@@ -0,0 +1,101 @@
+/* Check that pipelined loops leave through the prologue, the kernel and
+   each copy of it with the right results.  */
+/* { dg-do run } */
+/* { dg-options "-O2 -fmodulo-sched" } */
+
+#define N 12
+
+int a[N + 1], b[N], c[N];
+double d[N], e[N];
+
+int
+dot (int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += a[i] * b[i];
+  return s;
+}
+
+void
+scale (int k, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    c[i] = (a[i] * k) >> 2;
+}
+
+/* The store feeds the load of the next iteration.  */
+
+void
+prefix (int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    a[i + 1] = a[i] * 3 + b[i];
+}
+
+void
+poly (int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    e[i] = ((d[i] * 0.5 + 0.25) * d[i] + 0.125) * d[i];
+}
+
+void
+init ()
+{
+  int i;
+
+  for (i = 0; i < N; i++)
+    {
+      a[i] = i - 3;
+      b[i] = 2 * i + 1;
+      d[i] = i;
+    }
+  a[N] = 0;
+}
+
+int
+main ()
+{
+  int i, n, s, t;
+
+  for (n = 1; n <= N; n++)
+    {
+      init ();
+
+      for (s = 0, i = 0; i < n; i++)
+	s += a[i] * b[i];
+      if (dot (n) != s)
+	abort ();
+
+      scale (5, n);
+      for (i = 0; i < N; i++)
+	if (c[i] != (i < n ? ((i - 3) * 5) >> 2 : 0))
+	  abort ();
+
+      poly (n);
+      for (i = 0; i < n; i++)
+	if (e[i] != ((d[i] * 0.5 + 0.25) * d[i] + 0.125) * d[i])
+	  abort ();
+
+      prefix (n);
+      for (t = -3, i = 0; i < n; i++)
+	{
+	  t = t * 3 + 2 * i + 1;
+	  if (a[i + 1] != t)
+	    abort ();
+	}
+
+      for (i = 0; i < N; i++)
+	c[i] = 0;
+    }
+
+  exit (0);
+}
@@ -0,0 +1,103 @@
+/* Check pipelined loops over halfwords, with several loads from one
+   array in each iteration, and with a recurrence through a multiply.  */
+/* { dg-do run } */
+/* { dg-options "-O2 -fmodulo-sched" } */
+
+#define N 12
+
+int x[N + 3], z[N];
+short hx[N], hy[N];
+double dx[N], dy[N], dz[N];
+int coeff[4] = { 3, -5, 7, 2 };
+
+int
+mac16 (int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += hx[i] * hy[i];
+  return s;
+}
+
+void
+fir4 (int n)
+{
+  int i;
+  int c0 = coeff[0], c1 = coeff[1], c2 = coeff[2], c3 = coeff[3];
+
+  for (i = 0; i < n; i++)
+    z[i] = c0 * x[i] + c1 * x[i + 1] + c2 * x[i + 2] + c3 * x[i + 3];
+}
+
+void
+daxpy (double k, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    dz[i] = k * dx[i] + dy[i];
+}
+
+int
+horner (int k, int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s = s * k + x[i];
+  return s;
+}
+
+void
+init ()
+{
+  int i;
+
+  for (i = 0; i < N + 3; i++)
+    x[i] = i * 7 - 20;
+  for (i = 0; i < N; i++)
+    {
+      hx[i] = i * 1000 - 5000;
+      hy[i] = 300 - i * 41;
+      dx[i] = i;
+      dy[i] = i * 0.5;
+      z[i] = 0;
+      dz[i] = 0;
+    }
+}
+
+int
+main ()
+{
+  int i, n, s;
+
+  for (n = 1; n <= N; n++)
+    {
+      init ();
+
+      for (s = 0, i = 0; i < n; i++)
+	s += (i * 1000 - 5000) * (300 - i * 41);
+      if (mac16 (n) != s)
+	abort ();
+
+      fir4 (n);
+      for (i = 0; i < N; i++)
+	if (z[i] != (i < n
+		     ? 3 * x[i] - 5 * x[i + 1] + 7 * x[i + 2] + 2 * x[i + 3]
+		     : 0))
+	  abort ();
+
+      daxpy (3.0, n);
+      for (i = 0; i < N; i++)
+	if (dz[i] != (i < n ? 3.0 * i + i * 0.5 : 0))
+	  abort ();
+
+      for (s = 0, i = 0; i < n; i++)
+	s = s * -3 + i * 7 - 20;
+      if (horner (-3, n) != s)
+	abort ();
+    }
+
+  exit (0);
+}
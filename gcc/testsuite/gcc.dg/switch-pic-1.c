@@ -0,0 +1,7 @@
+/* Switches split into several jump tables must still work when the
+   target dispatches on a table through casesi, as i386 does with
+   -fpic.  */
+/* { dg-do run } */
+/* { dg-options "-O2 -fpic" } */
+
+#include "../gcc.c-torture/execute/switch-1.c"
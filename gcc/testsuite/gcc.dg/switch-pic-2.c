@@ -0,0 +1,4 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -fpic" } */
+
+#include "../gcc.c-torture/execute/switch-2.c"
@@ -0,0 +1,161 @@
+/* Check that loops done a word of elements at a time give the right
+   results for each trip count and alignment.  The checking loops call
+   abort, so they are not vectorized themselves.  */
+/* { dg-do run } */
+/* { dg-options "-O2 -fvectorize" } */
+
+#define N 100
+
+unsigned char a[N], b[N], c[N];
+signed char sc[N];
+short g[N], h[N];
+
+void
+add (int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    a[i] = b[i] + c[i];
+}
+
+unsigned
+sum (unsigned char *p, int n)
+{
+  int i;
+  unsigned s = 0;
+
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
+
+int
+ssum (int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += sc[i];
+  return s;
+}
+
+void
+hadd (short *p, short *q, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    p[i] = q[i] + 3;
+}
+
+/* The pointers may overlap.  */
+
+void
+copy (unsigned char *p, unsigned char *q, int n)
+{
+  while (n-- > 0)
+    *p++ = *q++;
+}
+
+void
+mul (int k, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    a[i] = b[i] * k - c[i];
+}
+
+void
+shl (int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    h[i] = (g[i] << 3) ^ ~h[i];
+}
+
+void
+neg (int n)
+{
+  int i;
+
+  for (i = n - 1; i >= 0; i--)
+    a[i] = -b[i] | 5;
+}
+
+int
+main ()
+{
+  int i, n, o, t;
+  unsigned s;
+
+  for (n = 0; n < 40; n++)
+    for (o = 0; o < 3; o++)
+      {
+	for (i = 0; i < N; i++)
+	  {
+	    a[i] = 0;
+	    b[i] = i * 7 + 200;
+	    c[i] = i * 13 + 1;
+	    sc[i] = i * 37;
+	    g[i] = i * 4567;
+	    h[i] = i * 1000;
+	  }
+
+	add (n);
+	for (i = 0; i < N; i++)
+	  if (a[i] != (i < n ? (unsigned char) (b[i] + c[i]) : 0))
+	    abort ();
+
+	for (s = 0, i = 0; i < n; i++)
+	  if ((s += b[i + o]) == 1)
+	    abort ();
+	if (sum (b + o, n) != s)
+	  abort ();
+
+	for (t = 0, i = 0; i < n; i++)
+	  if ((t += sc[i]) == 12345)
+	    abort ();
+	if (ssum (n) != t)
+	  abort ();
+
+	hadd (g + o, h, n);
+	for (i = 0; i < n; i++)
+	  if (g[i + o] != (short) (h[i] + 3))
+	    abort ();
+
+	copy (a + o, b + o, n);
+	for (i = 0; i < n; i++)
+	  if (a[i + o] != b[i + o])
+	    abort ();
+
+	mul (n - 7, n);
+	for (i = 0; i < n; i++)
+	  if (a[i] != (unsigned char) (b[i] * (n - 7) - c[i]))
+	    abort ();
+
+	for (i = 0; i < N; i++)
+	  g[i] = i * 4567;
+	shl (n);
+	for (i = 0; i < n; i++)
+	  if (h[i] != (short) ((g[i] << 3) ^ ~(i * 1000)))
+	    abort ();
+
+	neg (n);
+	for (i = 0; i < n; i++)
+	  if (a[i] != (unsigned char) (-b[i] | 5))
+	    abort ();
+
+	/* Each element stored is loaded again a word later.  */
+	for (i = 0; i < N; i++)
+	  b[i] = i;
+	copy (b + 8, b, n);
+	for (i = 0; i < n; i++)
+	  if (b[i + 8] != i % 8)
+	    abort ();
+      }
+
+  exit (0);
+}
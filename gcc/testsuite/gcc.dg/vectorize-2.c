@@ -0,0 +1,90 @@
+/* Check the logical operations and the halfword loops done a word of
+   elements at a time, for each trip count and alignment.  */
+/* { dg-do run } */
+/* { dg-options "-O2 -fvectorize" } */
+
+#define N 100
+
+unsigned char a[N], b[N], c[N];
+short g[N], h[N], x[N];
+
+void
+blend (int k, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    a[i] = (b[i] & k) | (c[i] & ~k);
+}
+
+void
+hadd (short *p, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    x[i] = p[i] + h[i];
+}
+
+void
+hdiff (int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    x[i] = (g[i] << 2) - h[i];
+}
+
+int
+hsum (short *p, int n)
+{
+  int i, s = 0;
+
+  for (i = 0; i < n; i++)
+    s += p[i];
+  return s;
+}
+
+int
+main ()
+{
+  int i, n, o, s;
+
+  for (n = 0; n < 40; n++)
+    for (o = 0; o < 3; o++)
+      {
+	for (i = 0; i < N; i++)
+	  {
+	    a[i] = 0;
+	    b[i] = i * 7 + 200;
+	    c[i] = i * 13 + 1;
+	    g[i] = i * 4567;
+	    h[i] = 1000 - i * 333;
+	    x[i] = 0;
+	  }
+
+	blend (0x5a, n);
+	for (i = 0; i < N; i++)
+	  if (a[i] != (i < n ? (unsigned char) ((b[i] & 0x5a) | (c[i] & ~0x5a))
+		       : 0))
+	    abort ();
+
+	hadd (g + o, n);
+	for (i = 0; i < N; i++)
+	  if (x[i] != (i < n ? (short) (g[i + o] + h[i]) : 0))
+	    abort ();
+
+	hdiff (n);
+	for (i = 0; i < n; i++)
+	  if (x[i] != (short) ((g[i] << 2) - h[i]))
+	    abort ();
+
+	for (s = 0, i = 0; i < n; i++)
+	  if ((s += g[i + o]) == 12345)
+	    abort ();
+	if (hsum (g + o, n) != s)
+	  abort ();
+      }
+
+  exit (0);
+}
@@ -0,0 +1,431 @@
+/* Timing variables for measuring compiler performance.
+   Copyright (C) 1999 Free Software Foundation, Inc.
+
+   This file is part of GNU CC.
+
+   GNU CC is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   GNU CC is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU CC; see the file COPYING.  If not, write to
+   the Free Software Foundation, 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#include "config.h"
+#include "system.h"
+
+#ifdef HAVE_SYS_RESOURCE_H
+# include <sys/resource.h>
+#endif
+
+#ifdef HAVE_SYS_TIMES_H
+# include <sys/times.h>
+#endif
+
+#include "timevar.h"
+
+/* Decide how to measure time.  Prefer getrusage and gettimeofday,
+   which have a finer resolution than times.  */
+
+#if defined (HAVE_SYS_RESOURCE_H) && defined (HAVE_GETTIMEOFDAY) \
+    && ! defined (USG) && ! defined (VMS)
+#define USE_GETRUSAGE
+#else
+#if defined (HAVE_SYS_TIMES_H) && defined (_SC_CLK_TCK)
+#define USE_TIMES
+#endif
+#endif
+
+/* Maximum nesting of timing variables.  */
+
+#define TIMEVAR_STACK_DEPTH 32
+
+/* Number of bytes allocated so far by xmalloc and friends.  */
+
+long timevar_allocated_bytes;
+
+/* A timing variable.  */
+
+struct timevar_def
+{
+  /* Time and memory charged to this variable in the translation unit,
+     and in the current function.  */
+  struct timevar_time_def elapsed;
+  struct timevar_time_def function_elapsed;
+
+  /* The name of this variable.  */
+  char *name;
+
+  /* The variable that was on top of the stack when this one was first
+     pushed, or -1 if the stack was empty.  */
+  int parent;
+
+  /* Nonzero if this variable has been pushed in the translation unit,
+     and in the current function.  */
+  int used;
+  int function_used;
+};
+
+static struct timevar_def timevars[TIMEVAR_LAST];
+
+/* The stack of timing variables in progress.  */
+
+static timevar_id_t timevar_stack[TIMEVAR_STACK_DEPTH];
+static int timevar_depth;
+
+/* The time at which the variable on top of the stack last started
+   being charged.  */
+
+static struct timevar_time_def start_time;
+
+/* Nonzero if timing is enabled.  When it is not, all the timing
+   variables stay at zero.  */
+
+static int timevar_enable;
+
+static void get_time			PROTO ((struct timevar_time_def *));
+static void timevar_charge		PROTO ((struct timevar_time_def *));
+static void timevar_add			PROTO ((struct timevar_time_def *,
+						struct timevar_time_def *));
+static void timevar_print_line		PROTO ((FILE *, char *, int,
+						struct timevar_time_def *,
+						struct timevar_time_def *));
+static void timevar_print_tree		PROTO ((FILE *, int, int,
+						struct timevar_time_def *,
+						struct timevar_time_def *));
+
+/* Fill in NOW with the current time and allocation count.  */
+
+static void
+get_time (now)
+     struct timevar_time_def *now;
+{
+  now->user = 0;
+  now->sys = 0;
+  now->wall = 0;
+  now->mem = timevar_allocated_bytes;
+
+  if (! timevar_enable)
+    return;
+
+#ifdef USE_GETRUSAGE
+  {
+    struct rusage rusage;
+    struct timeval tv;
+
+    getrusage (RUSAGE_SELF, &rusage);
+    gettimeofday (&tv, NULL);
+    now->user = rusage.ru_utime.tv_sec + rusage.ru_utime.tv_usec / 1e6;
+    now->sys = rusage.ru_stime.tv_sec + rusage.ru_stime.tv_usec / 1e6;
+    now->wall = tv.tv_sec + tv.tv_usec / 1e6;
+  }
+#else
+#ifdef USE_TIMES
+  {
+    static double ticks_to_sec;
+    struct tms tms;
+
+    if (ticks_to_sec == 0)
+      ticks_to_sec = 1.0 / sysconf (_SC_CLK_TCK);
+    now->wall = times (&tms) * ticks_to_sec;
+    now->user = tms.tms_utime * ticks_to_sec;
+    now->sys = tms.tms_stime * ticks_to_sec;
+  }
+#else
+  now->user = (double) clock () / CLOCKS_PER_SEC;
+#endif
+#endif
+}
+
+/* Add the time and memory in DELTA to TOTAL.  */
+
+static void
+timevar_add (total, delta)
+     struct timevar_time_def *total, *delta;
+{
+  total->user += delta->user;
+  total->sys += delta->sys;
+  total->wall += delta->wall;
+  total->mem += delta->mem;
+}
+
+/* Charge the time and memory since START_TIME to the variable on top
+   of the stack, and restart the measurement at NOW.  */
+
+static void
+timevar_charge (now)
+     struct timevar_time_def *now;
+{
+  struct timevar_def *tv;
+  struct timevar_time_def delta;
+
+  get_time (now);
+  if (timevar_depth == 0)
+    return;
+
+  tv = &timevars[timevar_stack[timevar_depth - 1]];
+  delta.user = now->user - start_time.user;
+  delta.sys = now->sys - start_time.sys;
+  delta.wall = now->wall - start_time.wall;
+  delta.mem = now->mem - start_time.mem;
+  timevar_add (&tv->elapsed, &delta);
+  timevar_add (&tv->function_elapsed, &delta);
+}
+
+/* Initialize the timing variables.  Measure time only if ENABLE is
+   nonzero.  */
+
+void
+init_timevar (enable)
+     int enable;
+{
+  int i;
+
+  timevar_enable = enable;
+  timevar_depth = 0;
+  bzero ((char *) timevars, sizeof timevars);
+
+#define DEFTIMEVAR(identifier__, name__) \
+  timevars[identifier__].name = name__;
+#include "timevar.def"
+#undef DEFTIMEVAR
+
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    timevars[i].parent = -1;
+}
+
+/* Start charging time to the timing variable TV.  The time since the
+   last push or pop is charged to the variable previously on top of
+   the stack.  */
+
+void
+timevar_push (tv)
+     timevar_id_t tv;
+{
+  struct timevar_def *def = &timevars[(int) tv];
+  struct timevar_time_def now;
+
+  if (! timevar_enable)
+    return;
+
+  if (timevar_depth == TIMEVAR_STACK_DEPTH)
+    abort ();
+
+  timevar_charge (&now);
+  if (! def->used)
+    {
+      def->used = 1;
+      if (timevar_depth > 0)
+	def->parent = (int) timevar_stack[timevar_depth - 1];
+    }
+  def->function_used = 1;
+
+  timevar_stack[timevar_depth++] = tv;
+  start_time = now;
+}
+
+/* Stop charging time to the timing variable TV, which must be on top
+   of the stack.  */
+
+void
+timevar_pop (tv)
+     timevar_id_t tv;
+{
+  struct timevar_time_def now;
+
+  if (! timevar_enable)
+    return;
+
+  if (timevar_depth == 0 || timevar_stack[timevar_depth - 1] != tv)
+    abort ();
+
+  timevar_charge (&now);
+  timevar_depth--;
+  start_time = now;
+}
+
+/* Start a new function: clear the per-function measurements.  */
+
+void
+timevar_start_function ()
+{
+  int i;
+
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    {
+      bzero ((char *) &timevars[i].function_elapsed,
+	     sizeof timevars[i].function_elapsed);
+      timevars[i].function_used = 0;
+    }
+}
+
+/* Store in ELAPSED the time and memory charged so far to the timing
+   variable TV in the translation unit, excluding its descendents.  */
+
+void
+timevar_get (tv, elapsed)
+     timevar_id_t tv;
+     struct timevar_time_def *elapsed;
+{
+  struct timevar_time_def now;
+
+  /* Bring the variable on top of the stack up to date.  */
+  if (timevar_enable && timevar_depth > 0)
+    {
+      timevar_charge (&now);
+      start_time = now;
+    }
+
+  *elapsed = timevars[(int) tv].elapsed;
+}
+
+/* Print one line of a report to FP, for the variable named NAME
+   indented by INDENT, whose measurements are ELAPSED out of TOTAL.  */
+
+static void
+timevar_print_line (fp, name, indent, elapsed, total)
+     FILE *fp;
+     char *name;
+     int indent;
+     struct timevar_time_def *elapsed, *total;
+{
+#define PERCENT(FIELD) \
+  (total->FIELD == 0 ? 0 : (double) elapsed->FIELD / total->FIELD * 100)
+
+  fprintf (fp, " %*s%-*s:", indent, "", 24 - indent, name);
+  fprintf (fp, "%7.2f (%3.0f%%) usr", elapsed->user, PERCENT (user));
+  fprintf (fp, "%7.2f (%3.0f%%) sys", elapsed->sys, PERCENT (sys));
+  fprintf (fp, "%7.2f (%3.0f%%) wall", elapsed->wall, PERCENT (wall));
+  fprintf (fp, "%8ld kB (%3.0f%%)\n", elapsed->mem / 1024, PERCENT (mem));
+
+#undef PERCENT
+}
+
+/* Print to FP the subtree of timing variables whose parent is PARENT,
+   indented by INDENT.  INCLUSIVE holds the measurements of each
+   variable including its descendents, and TOTAL the overall ones.  */
+
+static void
+timevar_print_tree (fp, parent, indent, inclusive, total)
+     FILE *fp;
+     int parent, indent;
+     struct timevar_time_def *inclusive, *total;
+{
+  int i;
+
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    if (timevars[i].used && timevars[i].parent == parent)
+      {
+	timevar_print_line (fp, timevars[i].name, indent,
+			    &inclusive[i], total);
+	timevar_print_tree (fp, i, indent + 2, inclusive, total);
+      }
+}
+
+/* Print a report of the time and memory charged to each timing
+   variable in the translation unit to FP.  Each variable is listed
+   under the one that was on top of the stack when it was first
+   pushed, and its figures include those of the variables below it.  */
+
+void
+timevar_print (fp)
+     FILE *fp;
+{
+  struct timevar_time_def inclusive[TIMEVAR_LAST];
+  struct timevar_time_def total, now;
+  int i, j;
+
+  if (! timevar_enable)
+    return;
+
+  /* Bring the variable on top of the stack up to date.  */
+  if (timevar_depth > 0)
+    {
+      timevar_charge (&now);
+      start_time = now;
+    }
+
+  bzero ((char *) inclusive, sizeof inclusive);
+  bzero ((char *) &total, sizeof total);
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    if (timevars[i].used)
+      {
+	for (j = i; j != -1; j = timevars[j].parent)
+	  timevar_add (&inclusive[j], &timevars[i].elapsed);
+	timevar_add (&total, &timevars[i].elapsed);
+      }
+
+  fprintf (fp, "\nExecution times (seconds)\n");
+  timevar_print_tree (fp, -1, 0, inclusive, &total);
+}
+
+/* Print a report of the time and memory charged to each timing
+   variable in the function named NAME to FP.  Only the passes run on
+   the function are listed, each excluding the ones nested in it.  */
+
+void
+timevar_print_function (fp, name)
+     FILE *fp;
+     char *name;
+{
+  struct timevar_time_def total;
+  int i;
+
+  if (! timevar_enable)
+    return;
+
+  bzero ((char *) &total, sizeof total);
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    if (timevars[i].function_used)
+      timevar_add (&total, &timevars[i].function_elapsed);
+
+  fprintf (fp, "\nExecution times for `%s' (seconds)\n", name);
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    if (timevars[i].function_used)
+      timevar_print_line (fp, timevars[i].name, 0,
+			  &timevars[i].function_elapsed, &total);
+  timevar_print_line (fp, "total", 0, &total, &total);
+}
+
+/* Write the measurements to FP in a form meant for other programs:
+   one line for each timing variable, holding tab-separated fields
+
+     KIND NAME TIMER PARENT USER SYS WALL BYTES
+
+   where KIND is `function' or `unit', NAME the name of the function
+   or of the input file, PARENT the name of the parent timing variable
+   or `-', and the figures exclude the nested timing variables.  If
+   FUNCTION_P is nonzero, write those of the current function,
+   otherwise those of the translation unit.  */
+
+void
+timevar_print_records (fp, kind, name, function_p)
+     FILE *fp;
+     char *kind, *name;
+     int function_p;
+{
+  struct timevar_time_def *elapsed;
+  int i;
+
+  if (! timevar_enable)
+    return;
+
+  for (i = 0; i < (int) TIMEVAR_LAST; i++)
+    if (function_p ? timevars[i].function_used : timevars[i].used)
+      {
+	elapsed = (function_p ? &timevars[i].function_elapsed
+		   : &timevars[i].elapsed);
+	fprintf (fp, "%s\t%s\t%s\t%s\t%.6f\t%.6f\t%.6f\t%ld\n",
+		 kind, name, timevars[i].name,
+		 (timevars[i].parent == -1
+		  ? "-" : timevars[timevars[i].parent].name),
+		 elapsed->user, elapsed->sys, elapsed->wall, elapsed->mem);
+      }
+}
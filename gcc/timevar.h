@@ -0,0 +1,90 @@
+/* Timing variables for measuring compiler performance.
+   Copyright (C) 1999 Free Software Foundation, Inc.
+
+   This file is part of GNU CC.
+
+   GNU CC is free software; you can redistribute it and/or modify it
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   GNU CC is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with GNU CC; see the file COPYING.  If not, write to
+   the Free Software Foundation, 59 Temple Place - Suite 330,
+   Boston, MA 02111-1307, USA.  */
+
+#ifndef _TIMEVAR_H_
+#define _TIMEVAR_H_
+
+#ifndef PROTO
+#include "gansidecl.h"
+#endif
+
+/* Timing variables are used to measure the time and memory spent in
+   the passes of the compiler.  They are organized as a stack: a
+   timing variable is pushed when a pass starts and popped when it
+   ends, and elapsed time and memory are always charged to the timing
+   variable on top of the stack.  So the time recorded for a variable
+   excludes the time of the variables pushed on top of it.
+
+   Each timing variable remembers the variable that was on top of the
+   stack the first time it was pushed, and -ftime-report prints the
+   variables as a tree built from these parents, the time of each
+   variable including that of its descendents.
+
+   Memory is measured as the number of bytes obtained from xmalloc,
+   xcalloc and xrealloc, which includes the chunks of the obstacks.  */
+
+/* The time and memory measured by a timing variable.  */
+
+struct timevar_time_def
+{
+  /* User and system CPU time, and wall clock time, in seconds.  */
+  double user;
+  double sys;
+  double wall;
+
+  /* Bytes allocated.  */
+  long mem;
+};
+
+/* An enumeration of timing variable identifiers, built from the
+   definitions in timevar.def.  */
+
+#define DEFTIMEVAR(identifier__, name__) \
+    identifier__,
+typedef enum
+{
+#include "timevar.def"
+  TIMEVAR_LAST
+}
+timevar_id_t;
+#undef DEFTIMEVAR
+
+/* Execute the sequence BODY, charging its time to the timing
+   variable TV.  BODY must not jump out of itself.  */
+
+#define TIMEVAR(TV, BODY)	\
+do { timevar_push (TV); BODY; timevar_pop (TV); } while (0)
+
+/* Number of bytes allocated so far by xmalloc and friends.  */
+extern long timevar_allocated_bytes;
+
+extern void init_timevar		PROTO ((int));
+extern void timevar_push		PROTO ((timevar_id_t));
+extern void timevar_pop			PROTO ((timevar_id_t));
+extern void timevar_start_function	PROTO ((void));
+extern void timevar_get			PROTO ((timevar_id_t,
+						struct timevar_time_def *));
+#ifdef BUFSIZ
+extern void timevar_print		PROTO ((FILE *));
+extern void timevar_print_function	PROTO ((FILE *, char *));
+extern void timevar_print_records	PROTO ((FILE *, char *, char *, int));
+#endif
+
+#endif /* _TIMEVAR_H_ */
@@ -56,6 +56,7 @@ Boston, MA 02111-1307, USA.  */
 #include "output.h"
 #include "except.h"
 #include "toplev.h"
+#include "timevar.h"
 
 #ifdef DWARF_DEBUGGING_INFO
 #include "dwarfout.h"
@@ -269,8 +270,10 @@ int jump_opt_dump = 0;
 int addressof_dump = 0;
 int cse_dump = 0;
 int gcse_dump = 0;
+int vect_dump = 0;
 int loop_dump = 0;
 int cse2_dump = 0;
+int msched_dump = 0;
 int branch_prob_dump = 0;
 int flow_dump = 0;
 int combine_dump = 0;
@@ -279,6 +282,7 @@ int sched_dump = 0;
 int local_reg_dump = 0;
 int global_reg_dump = 0;
 int sched2_dump = 0;
+int bbro_dump = 0;
 int jump2_opt_dump = 0;
 #ifdef DELAY_SLOTS
 int dbr_sched_dump = 0;
@@ -398,6 +402,18 @@ int obey_regdecls = 0;
    times taken by the various passes.  -quiet.  */
 
 int quiet_flag = 0;
+
+/* Nonzero means report the time and memory spent in each pass, even
+   with -quiet.  -ftime-report.  */
+
+int flag_time_report = 0;
+
+/* Name of the file to which -ftime-report-file= appends the time and
+   memory spent in each pass, in a form meant for other programs, and
+   the file itself while it is open.  */
+
+static char *time_report_file_name;
+static FILE *time_report_file;
 
 /* -f flags.  */
 
@@ -501,6 +517,22 @@ int flag_reduce_all_givs = 0;
 
 int flag_regmove = 0;
 
+/* Nonzero to lay out the basic blocks of each function using the
+   execution counts from -fbranch-probabilities.  This is the default
+   for -O2.  */
+
+int flag_reorder_blocks = 0;
+
+/* Nonzero to software pipeline simple innermost loops by modulo
+   scheduling them.  */
+
+int flag_modulo_sched = 0;
+
+/* Nonzero to make loops over arrays of small integers work on a word
+   of elements at a time.  */
+
+int flag_vectorize = 0;
+
 /* Nonzero for -fwritable-strings:
    store string constants in data segment and don't uniquize them.  */
 
@@ -884,6 +916,12 @@ lang_independent_options f_options[] =
    "Create data files needed by gcov" },
   {"branch-probabilities", &flag_branch_probabilities, 1,
    "Use profiling information for branch porbabilities" },
+  {"reorder-blocks", &flag_reorder_blocks, 1,
+   "Lay out basic blocks using profiling information" },
+  {"modulo-sched", &flag_modulo_sched, 1,
+   "Overlap the iterations of innermost loops" },
+  {"vectorize", &flag_vectorize, 1,
+   "Do loops over small integers a word of elements at a time" },
   {"fast-math", &flag_fast_math, 1,
    "Improve FP speed by violating ANSI & IEEE rules" },
   {"common", &flag_no_common, 0,
@@ -915,6 +953,8 @@ lang_independent_options f_options[] =
    "Generate code to check every memory access" },
   {"prefix-function-name", &flag_prefix_function_name, 1,
    "Add a prefix to all function names" },
+  {"time-report", &flag_time_report, 1,
+   "Report the time and memory spent in each pass" },
   {"dump-unnumbered", &flag_dump_unnumbered, 1}
 };
 
@@ -1191,33 +1231,6 @@ FILE *asm_out_file;
 FILE *aux_info_file;
 FILE *rtl_dump_file = NULL;
 
-/* Time accumulators, to count the total time spent in various passes.  */
-
-int parse_time;
-int varconst_time;
-int integration_time;
-int jump_time;
-int cse_time;
-int gcse_time;
-int loop_time;
-int cse2_time;
-int branch_prob_time;
-int flow_time;
-int combine_time;
-int regmove_time;
-int sched_time;
-int local_alloc_time;
-int global_alloc_time;
-int sched2_time;
-#ifdef DELAY_SLOTS
-int dbr_sched_time;
-#endif
-int shorten_branch_time;
-int stack_reg_time;
-int final_time;
-int symout_time;
-int dump_time;
-
 /* Return time used so far, in microseconds.  */
 
 int
@@ -1287,9 +1300,6 @@ get_run_time ()
 #endif	/* __BEOS__ */
 }
 
-#define TIMEVAR(VAR, BODY)    \
-do { int otime = get_run_time (); BODY; VAR += get_run_time () - otime; } while (0)
-
 void
 print_time (str, total)
      char *str;
@@ -2154,6 +2164,7 @@ xmalloc (size)
   value = (char *) malloc (size);
   if (value == 0)
     fatal ("virtual memory exhausted");
+  timevar_allocated_bytes += size;
   return value;
 }
 
@@ -2171,6 +2182,7 @@ xcalloc (size1, size2)
   value = (char *) calloc (size1, size2);
   if (value == 0)
     fatal ("virtual memory exhausted");
+  timevar_allocated_bytes += (long) size1 * size2;
   return value;
 }
 
@@ -2194,6 +2206,7 @@ xrealloc (ptr, size)
 
   if (!result)
     fatal ("virtual memory exhausted");
+  timevar_allocated_bytes += size;
 
   return result;
 }
@@ -2423,7 +2436,7 @@ open_dump_file (suffix, function_name)
   char *dumpname;
 
   TIMEVAR
-    (dump_time,
+    (TV_DUMP,
      {
        dumpname = (char *) xmalloc (strlen (dump_base_name) + strlen (suffix) + 1);
 
@@ -2454,7 +2467,7 @@ close_dump_file (func, insns)
      rtx    insns;
 {
   TIMEVAR
-    (dump_time,
+    (TV_DUMP,
      {
        if (func)
 	 func (rtl_dump_file, insns);
@@ -2514,37 +2527,21 @@ compile_file (name)
      char *name;
 {
   tree globals;
-  int start_time;
 
   int name_specified = name != 0;
 
   if (dump_base_name == 0)
     dump_base_name = name ? name : "gccdump";
 
-  parse_time = 0;
-  varconst_time = 0;
-  integration_time = 0;
-  jump_time = 0;
-  cse_time = 0;
-  gcse_time = 0;
-  loop_time = 0;
-  cse2_time = 0;
-  branch_prob_time = 0;
-  flow_time = 0;
-  combine_time = 0;
-  regmove_time = 0;
-  sched_time = 0;
-  local_alloc_time = 0;
-  global_alloc_time = 0;
-  sched2_time = 0;
-#ifdef DELAY_SLOTS
-  dbr_sched_time = 0;
-#endif
-  shorten_branch_time = 0;
-  stack_reg_time = 0;
-  final_time = 0;
-  symout_time = 0;
-  dump_time = 0;
+  init_timevar (flag_time_report || time_report_file_name || ! quiet_flag);
+  timevar_push (TV_TOTAL);
+
+  if (time_report_file_name)
+    {
+      time_report_file = fopen (time_report_file_name, "a");
+      if (time_report_file == 0)
+	pfatal_with_name (time_report_file_name);
+    }
 
   /* Initialize data in various passes.  */
 
@@ -2591,6 +2588,8 @@ compile_file (name)
     clean_dump_file (".loop");
   if (cse2_dump)
     clean_dump_file (".cse2");
+  if (msched_dump)
+    clean_dump_file (".msched");
   if (branch_prob_dump)
     clean_dump_file (".bp");
   if (flow_dump)
@@ -2607,6 +2606,8 @@ compile_file (name)
     clean_dump_file (".greg");
   if (sched2_dump)
     clean_dump_file (".sched2");
+  if (bbro_dump)
+    clean_dump_file (".bbro");
   if (jump2_opt_dump)
     clean_dump_file (".jump2");
 #ifdef DELAY_SLOTS
@@ -2615,6 +2616,8 @@ compile_file (name)
 #endif
   if (gcse_dump)
     clean_dump_file (".gcse");
+  if (vect_dump)
+    clean_dump_file (".vect");
 #ifdef STACK_REGS
   if (stack_reg_dump)
     clean_dump_file (".stack");
@@ -2741,17 +2744,17 @@ compile_file (name)
      and output the predefined types.  */
 #if defined (DBX_DEBUGGING_INFO) || defined (XCOFF_DEBUGGING_INFO)
   if (write_symbols == DBX_DEBUG || write_symbols == XCOFF_DEBUG)
-    TIMEVAR (symout_time, dbxout_init (asm_out_file, main_input_filename,
+    TIMEVAR (TV_SYMOUT, dbxout_init (asm_out_file, main_input_filename,
 				       getdecls ()));
 #endif
 #ifdef SDB_DEBUGGING_INFO
   if (write_symbols == SDB_DEBUG)
-    TIMEVAR (symout_time, sdbout_init (asm_out_file, main_input_filename,
+    TIMEVAR (TV_SYMOUT, sdbout_init (asm_out_file, main_input_filename,
 				       getdecls ()));
 #endif
 #ifdef DWARF_DEBUGGING_INFO
   if (write_symbols == DWARF_DEBUG)
-    TIMEVAR (symout_time, dwarfout_init (asm_out_file, main_input_filename));
+    TIMEVAR (TV_SYMOUT, dwarfout_init (asm_out_file, main_input_filename));
 #endif
 #ifdef DWARF2_UNWIND_INFO
   if (dwarf2out_do_frame ())
@@ -2759,7 +2762,7 @@ compile_file (name)
 #endif
 #ifdef DWARF2_DEBUGGING_INFO
   if (write_symbols == DWARF2_DEBUG)
-    TIMEVAR (symout_time, dwarf2out_init (asm_out_file, main_input_filename));
+    TIMEVAR (TV_SYMOUT, dwarf2out_init (asm_out_file, main_input_filename));
 #endif
 
   /* Initialize yet another pass.  */
@@ -2767,7 +2770,7 @@ compile_file (name)
   init_final (main_input_filename);
   init_branch_prob (dump_base_name);
 
-  start_time = get_run_time ();
+  timevar_push (TV_PARSE);
 
   /* Call the parser, which parses the entire file
      (calling rest_of_compilation for each function).  */
@@ -2788,10 +2791,7 @@ compile_file (name)
   /* Compilation is now finished except for writing
      what's left of the symbol table output.  */
 
-  parse_time += get_run_time () - start_time;
-
-  parse_time -= integration_time;
-  parse_time -= varconst_time;
+  timevar_pop (TV_PARSE);
 
   globals = getdecls ();
 
@@ -2949,7 +2949,7 @@ compile_file (name)
 	    && TREE_PUBLIC (decl) && DECL_INITIAL (decl)
 	    && ! DECL_EXTERNAL (decl)
 	    && DECL_RTL (decl) != 0)
-	  TIMEVAR (symout_time, sdbout_symbol (decl, 0));
+	  TIMEVAR (TV_SYMOUT, sdbout_symbol (decl, 0));
 
 	/* Output COFF information for non-global
 	   file-scope initialized variables.  */
@@ -2959,7 +2959,7 @@ compile_file (name)
 	    && ! DECL_EXTERNAL (decl)
 	    && DECL_RTL (decl) != 0
 	    && GET_CODE (DECL_RTL (decl)) == MEM)
-	  TIMEVAR (symout_time, sdbout_toplevel_data (decl));
+	  TIMEVAR (TV_SYMOUT, sdbout_toplevel_data (decl));
 #endif /* SDB_DEBUGGING_INFO */
 #ifdef DWARF_DEBUGGING_INFO
 	/* Output DWARF information for file-scope tentative data object
@@ -2969,7 +2969,7 @@ compile_file (name)
 
 	if (write_symbols == DWARF_DEBUG
 	    && (TREE_CODE (decl) != FUNCTION_DECL || !DECL_INITIAL (decl)))
-	  TIMEVAR (symout_time, dwarfout_file_scope_decl (decl, 1));
+	  TIMEVAR (TV_SYMOUT, dwarfout_file_scope_decl (decl, 1));
 #endif
 #ifdef DWARF2_DEBUGGING_INFO
 	/* Output DWARF2 information for file-scope tentative data object
@@ -2979,7 +2979,7 @@ compile_file (name)
 
 	if (write_symbols == DWARF2_DEBUG
 	    && (TREE_CODE (decl) != FUNCTION_DECL || !DECL_INITIAL (decl)))
-	  TIMEVAR (symout_time, dwarf2out_decl (decl));
+	  TIMEVAR (TV_SYMOUT, dwarf2out_decl (decl));
 #endif
       }
   }
@@ -2991,7 +2991,7 @@ compile_file (name)
   /* Do dbx symbols */
 #if defined (DBX_DEBUGGING_INFO) || defined (XCOFF_DEBUGGING_INFO)
   if (write_symbols == DBX_DEBUG || write_symbols == XCOFF_DEBUG)
-    TIMEVAR (symout_time,
+    TIMEVAR (TV_SYMOUT,
 	     {
 	       dbxout_finish (asm_out_file, main_input_filename);
 	     });
@@ -2999,7 +2999,7 @@ compile_file (name)
 
 #ifdef DWARF_DEBUGGING_INFO
   if (write_symbols == DWARF_DEBUG)
-    TIMEVAR (symout_time,
+    TIMEVAR (TV_SYMOUT,
 	     {
 	       dwarfout_finish ();
 	     });
@@ -3012,7 +3012,7 @@ compile_file (name)
 
 #ifdef DWARF2_DEBUGGING_INFO
   if (write_symbols == DWARF2_DEBUG)
-    TIMEVAR (symout_time,
+    TIMEVAR (TV_SYMOUT,
 	     {
 	       dwarf2out_finish ();
 	     });
@@ -3025,7 +3025,7 @@ compile_file (name)
   if (branch_prob_dump)
     open_dump_file (".bp", NULL);
    
-  TIMEVAR (dump_time, end_branch_prob (rtl_dump_file));
+  TIMEVAR (TV_DUMP, end_branch_prob (rtl_dump_file));
    
   if (branch_prob_dump)
     close_dump_file (NULL, NULL_RTX);
@@ -3050,7 +3050,7 @@ compile_file (name)
   if (combine_dump)
     {
       open_dump_file (".combine", NULL);
-      TIMEVAR (dump_time, dump_combine_total_stats (rtl_dump_file));
+      TIMEVAR (TV_DUMP, dump_combine_total_stats (rtl_dump_file));
       close_dump_file (NULL, NULL_RTX);
     }
 
@@ -3063,36 +3063,18 @@ compile_file (name)
   if (ferror (asm_out_file) != 0 || fclose (asm_out_file) != 0)
     fatal_io_error (asm_file_name);
 
+  timevar_pop (TV_TOTAL);
+
   /* Print the times.  */
 
-  if (! quiet_flag)
+  if (flag_time_report || ! quiet_flag)
+    timevar_print (stderr);
+
+  if (time_report_file)
     {
-      fprintf (stderr,"\n");
-      print_time ("parse", parse_time);
-
-      print_time ("integration", integration_time);
-      print_time ("jump", jump_time);
-      print_time ("cse", cse_time);
-      print_time ("gcse", gcse_time);
-      print_time ("loop", loop_time);
-      print_time ("cse2", cse2_time);
-      print_time ("branch-prob", branch_prob_time);
-      print_time ("flow", flow_time);
-      print_time ("combine", combine_time);
-      print_time ("regmove", regmove_time);
-      print_time ("sched", sched_time);
-      print_time ("local-alloc", local_alloc_time);
-      print_time ("global-alloc", global_alloc_time);
-      print_time ("sched2", sched2_time);
-#ifdef DELAY_SLOTS
-      print_time ("dbranch", dbr_sched_time);
-#endif
-      print_time ("shorten-branch", shorten_branch_time);
-      print_time ("stack-reg", stack_reg_time);
-      print_time ("final", final_time);
-      print_time ("varconst", varconst_time);
-      print_time ("symout", symout_time);
-      print_time ("dump", dump_time);
+      timevar_print_records (time_report_file, "unit", main_input_filename, 0);
+      if (ferror (time_report_file) != 0 || fclose (time_report_file) != 0)
+	fatal_io_error (time_report_file_name);
     }
 }
 
@@ -3126,7 +3108,7 @@ rest_of_decl_compilation (decl, asmspec, top_level, at_end)
      but we need to treat them as if they were.  */
   if (TREE_STATIC (decl) || DECL_EXTERNAL (decl)
       || TREE_CODE (decl) == FUNCTION_DECL)
-    TIMEVAR (varconst_time,
+    TIMEVAR (TV_VARCONST,
 	     {
 	       make_decl_rtl (decl, asmspec, top_level);
 	       /* Initialized extern variable exists to be replaced
@@ -3162,12 +3144,12 @@ rest_of_decl_compilation (decl, asmspec, top_level, at_end)
 #if defined (DBX_DEBUGGING_INFO) || defined (XCOFF_DEBUGGING_INFO)
   else if ((write_symbols == DBX_DEBUG || write_symbols == XCOFF_DEBUG)
 	   && TREE_CODE (decl) == TYPE_DECL)
-    TIMEVAR (symout_time, dbxout_symbol (decl, 0));
+    TIMEVAR (TV_SYMOUT, dbxout_symbol (decl, 0));
 #endif
 #ifdef SDB_DEBUGGING_INFO
   else if (write_symbols == SDB_DEBUG && top_level
 	   && TREE_CODE (decl) == TYPE_DECL)
-    TIMEVAR (symout_time, sdbout_symbol (decl, 0));
+    TIMEVAR (TV_SYMOUT, sdbout_symbol (decl, 0));
 #endif
 }
 
@@ -3180,11 +3162,11 @@ rest_of_type_compilation (type, toplev)
 {
 #if defined (DBX_DEBUGGING_INFO) || defined (XCOFF_DEBUGGING_INFO)
   if (write_symbols == DBX_DEBUG || write_symbols == XCOFF_DEBUG)
-    TIMEVAR (symout_time, dbxout_symbol (TYPE_STUB_DECL (type), !toplev));
+    TIMEVAR (TV_SYMOUT, dbxout_symbol (TYPE_STUB_DECL (type), !toplev));
 #endif
 #ifdef SDB_DEBUGGING_INFO
   if (write_symbols == SDB_DEBUG)
-    TIMEVAR (symout_time, sdbout_symbol (TYPE_STUB_DECL (type), !toplev));
+    TIMEVAR (TV_SYMOUT, sdbout_symbol (TYPE_STUB_DECL (type), !toplev));
 #endif
 }
 
@@ -3192,14 +3174,21 @@ rest_of_type_compilation (type, toplev)
    after each top-level definition is parsed.
    It is supposed to compile that function or variable
    and output the assembler code for it.
-   After we return, the tree storage is freed.  */
+   After we return, the tree storage is freed.
+
+   The passes run here keep their state in file-scope variables (the insn
+   chain and label numbers in emit-rtl.c, the register tables in
+   regclass.c, the constant pool in varasm.c and so on), and what one
+   function leaves there affects the code for the next, for instance
+   which constants have already been output.  So functions are compiled
+   one at a time, in the order they are parsed; the driver's -j option is
+   the way to keep several processors busy.  */
 
 void
 rest_of_compilation (decl)
      tree decl;
 {
   register rtx insns;
-  int start_time = get_run_time ();
   int tem;
   /* Nonzero if we have saved the original DECL_INITIAL of the function,
      to be restored after we finish compiling the function
@@ -3209,17 +3198,21 @@ rest_of_compilation (decl)
   tree saved_arguments = 0;
   int failure = 0;
 
+  timevar_push (TV_REST_OF_COMPILATION);
+  timevar_start_function ();
+
   /* If we are reconsidering an inline function
      at the end of compilation, skip the stuff for making it inline.  */
 
   if (DECL_SAVED_INSNS (decl) == 0)
     {
       int inlinable = 0;
+      int skip_function = 0;
       char *lose;
 
       /* If requested, consider whether to make this function inline.  */
       if (DECL_INLINE (decl) || flag_inline_functions)
-	TIMEVAR (integration_time,
+	TIMEVAR (TV_INTEGRATION,
 		 {
 		   lose = function_cannot_inline_p (decl);
 		   if (lose || ! optimize)
@@ -3233,7 +3226,7 @@ rest_of_compilation (decl)
 		       if (DECL_EXTERNAL (decl))
 			 {
 			   DECL_INITIAL (decl) = 0;
-			   goto exit_rest_of_compilation;
+			   skip_function = 1;
 			 }
 		     }
 		   else
@@ -3244,6 +3237,9 @@ rest_of_compilation (decl)
 		     inlinable = DECL_INLINE (decl) = 1;
 		 });
 
+      if (skip_function)
+	goto exit_rest_of_compilation;
+
       insns = get_insns ();
 
       /* Dump the rtl code if we are dumping rtl.  */
@@ -3318,7 +3314,7 @@ rest_of_compilation (decl)
 	  if (write_symbols == DWARF_DEBUG)
 	    {
 	      set_decl_abstract_flags (decl, 1);
-	      TIMEVAR (symout_time, dwarfout_file_scope_decl (decl, 0));
+	      TIMEVAR (TV_SYMOUT, dwarfout_file_scope_decl (decl, 0));
 	      set_decl_abstract_flags (decl, 0);
 	    }
 #endif
@@ -3329,11 +3325,11 @@ rest_of_compilation (decl)
 	  if (write_symbols == DWARF2_DEBUG)
 	    {
 	      set_decl_abstract_flags (decl, 1);
-	      TIMEVAR (symout_time, dwarf2out_decl (decl));
+	      TIMEVAR (TV_SYMOUT, dwarf2out_decl (decl));
 	      set_decl_abstract_flags (decl, 0);
 	    }
 #endif
-	  TIMEVAR (integration_time, save_for_inline_nocopy (decl));
+	  TIMEVAR (TV_INTEGRATION, save_for_inline_nocopy (decl));
 	  RTX_INTEGRATED_P (DECL_SAVED_INSNS (decl)) = inlinable;
 	  goto exit_rest_of_compilation;
 	}
@@ -3350,7 +3346,7 @@ rest_of_compilation (decl)
 	  if (write_symbols == DWARF_DEBUG)
 	    {
 	      set_decl_abstract_flags (decl, 1);
-	      TIMEVAR (symout_time, dwarfout_file_scope_decl (decl, 0));
+	      TIMEVAR (TV_SYMOUT, dwarfout_file_scope_decl (decl, 0));
 	      set_decl_abstract_flags (decl, 0);
 	    }
 #endif
@@ -3362,13 +3358,13 @@ rest_of_compilation (decl)
 	  if (write_symbols == DWARF2_DEBUG)
 	    {
 	      set_decl_abstract_flags (decl, 1);
-	      TIMEVAR (symout_time, dwarf2out_decl (decl));
+	      TIMEVAR (TV_SYMOUT, dwarf2out_decl (decl));
 	      set_decl_abstract_flags (decl, 0);
 	    }
 #endif
 	  saved_block_tree = DECL_INITIAL (decl);
 	  saved_arguments = DECL_ARGUMENTS (decl);
-	  TIMEVAR (integration_time, save_for_inline_copying (decl));
+	  TIMEVAR (TV_INTEGRATION, save_for_inline_copying (decl));
 	  RTX_INTEGRATED_P (DECL_SAVED_INSNS (decl)) = inlinable;
 	}
 
@@ -3440,8 +3436,8 @@ rest_of_compilation (decl)
   /* Always do one jump optimization pass to ensure that JUMP_LABEL fields
      are initialized and to compute whether control can drop off the end
      of the function.  */
-  TIMEVAR (jump_time, reg_scan (insns, max_reg_num (), 0));
-  TIMEVAR (jump_time, jump_optimize (insns, !JUMP_CROSS_JUMP, !JUMP_NOOP_MOVES,
+  TIMEVAR (TV_JUMP, reg_scan (insns, max_reg_num (), 0));
+  TIMEVAR (TV_JUMP, jump_optimize (insns, !JUMP_CROSS_JUMP, !JUMP_NOOP_MOVES,
 				     JUMP_AFTER_REGSCAN));
 
   /* Now is when we stop if -fsyntax-only and -Wreturn-type.  */
@@ -3463,18 +3459,18 @@ rest_of_compilation (decl)
       if (cse_dump)
 	open_dump_file (".cse", decl_printable_name (decl, 2));
 
-      TIMEVAR (cse_time, reg_scan (insns, max_reg_num (), 1));
+      TIMEVAR (TV_CSE, reg_scan (insns, max_reg_num (), 1));
 
       if (flag_thread_jumps)
 	/* Hacks by tiemann & kenner.  */
-	TIMEVAR (jump_time, thread_jumps (insns, max_reg_num (), 1));
+	TIMEVAR (TV_JUMP, thread_jumps (insns, max_reg_num (), 1));
 
-      TIMEVAR (cse_time, tem = cse_main (insns, max_reg_num (),
+      TIMEVAR (TV_CSE, tem = cse_main (insns, max_reg_num (),
 					 0, rtl_dump_file));
-      TIMEVAR (cse_time, delete_trivially_dead_insns (insns, max_reg_num ()));
+      TIMEVAR (TV_CSE, delete_trivially_dead_insns (insns, max_reg_num ()));
 
       if (tem || optimize > 1)
-	TIMEVAR (jump_time, jump_optimize (insns, !JUMP_CROSS_JUMP,
+	TIMEVAR (TV_JUMP, jump_optimize (insns, !JUMP_CROSS_JUMP,
 					   !JUMP_NOOP_MOVES,
 					   !JUMP_AFTER_REGSCAN));
 
@@ -3497,11 +3493,26 @@ rest_of_compilation (decl)
       if (gcse_dump)
 	open_dump_file (".gcse", IDENTIFIER_POINTER (DECL_NAME (decl)));
       
-      TIMEVAR (gcse_time, gcse_main (insns, rtl_dump_file));
+      TIMEVAR (TV_GCSE, gcse_main (insns, rtl_dump_file));
 
       if (gcse_dump)
 	close_dump_file (print_rtl, insns);
     }
+
+  /* Make loops over small integers work on a word at a time.  */
+
+  if (optimize > 0 && flag_vectorize && ! optimize_size)
+    {
+      if (vect_dump)
+	open_dump_file (".vect", decl_printable_name (decl, 2));
+
+      TIMEVAR (TV_VECTORIZE, vectorize_loops (insns, rtl_dump_file));
+      TIMEVAR (TV_VECTORIZE, reg_scan (insns, max_reg_num (), 1));
+
+      if (vect_dump)
+	close_dump_file (print_rtl, insns);
+    }
+
   /* Move constant computations out of loops.  */
 
   if (optimize > 0)
@@ -3510,7 +3521,7 @@ rest_of_compilation (decl)
 	open_dump_file (".loop", decl_printable_name (decl, 2));
 	
       TIMEVAR
-	(loop_time,
+	(TV_LOOP,
 	 {
 	   if (flag_rerun_loop_opt)
 	     {
@@ -3550,16 +3561,16 @@ rest_of_compilation (decl)
 	     the second CSE pass to do a better job.  Jump_optimize can change
 	     max_reg_num so we must rerun reg_scan afterwards.
 	     ??? Rework to not call reg_scan so often.  */
-	  TIMEVAR (jump_time, reg_scan (insns, max_reg_num (), 0));
-	  TIMEVAR (jump_time, jump_optimize (insns, !JUMP_CROSS_JUMP,
+	  TIMEVAR (TV_JUMP, reg_scan (insns, max_reg_num (), 0));
+	  TIMEVAR (TV_JUMP, jump_optimize (insns, !JUMP_CROSS_JUMP,
 					     !JUMP_NOOP_MOVES,
 					     JUMP_AFTER_REGSCAN));
 	  
-	  TIMEVAR (cse2_time, reg_scan (insns, max_reg_num (), 0));
-	  TIMEVAR (cse2_time, tem = cse_main (insns, max_reg_num (),
+	  TIMEVAR (TV_CSE2, reg_scan (insns, max_reg_num (), 0));
+	  TIMEVAR (TV_CSE2, tem = cse_main (insns, max_reg_num (),
 					      1, rtl_dump_file));
 	  if (tem)
-	    TIMEVAR (jump_time, jump_optimize (insns, !JUMP_CROSS_JUMP,
+	    TIMEVAR (TV_JUMP, jump_optimize (insns, !JUMP_CROSS_JUMP,
 					       !JUMP_NOOP_MOVES,
 					       !JUMP_AFTER_REGSCAN));
 	}
@@ -3568,8 +3579,8 @@ rest_of_compilation (decl)
 	{
 	  /* This pass of jump threading straightens out code
 	     that was kinked by loop optimization.  */
-	  TIMEVAR (jump_time, reg_scan (insns, max_reg_num (), 0));
-	  TIMEVAR (jump_time, thread_jumps (insns, max_reg_num (), 0));
+	  TIMEVAR (TV_JUMP, reg_scan (insns, max_reg_num (), 0));
+	  TIMEVAR (TV_JUMP, thread_jumps (insns, max_reg_num (), 0));
 	}
       
       /* Dump rtl code after cse, if we are doing that.  */
@@ -3577,6 +3588,21 @@ rest_of_compilation (decl)
       if (cse2_dump)
 	close_dump_file (print_rtl, insns);
     }
+
+  /* Software pipeline the innermost loops.  */
+
+  if (optimize > 0 && flag_modulo_sched)
+    {
+      if (msched_dump)
+	open_dump_file (".msched", decl_printable_name (decl, 2));
+
+      /* The alias analysis needs the register scan information.  */
+      TIMEVAR (TV_MODULO_SCHED, reg_scan (insns, max_reg_num (), 0));
+      TIMEVAR (TV_MODULO_SCHED, modulo_schedule_loops (insns, rtl_dump_file));
+
+      if (msched_dump)
+	close_dump_file (print_rtl, insns);
+    }
   
   if (profile_arc_flag || flag_test_coverage || flag_branch_probabilities)
     {
@@ -3584,7 +3610,7 @@ rest_of_compilation (decl)
 	open_dump_file (".bp", decl_printable_name (decl, 2));
     
       TIMEVAR
-	(branch_prob_time,
+	(TV_BRANCH_PROB,
 	 {
 	   branch_prob (insns, rtl_dump_file);
 	 });
@@ -3614,7 +3640,7 @@ rest_of_compilation (decl)
   
   if (obey_regdecls)
     {
-      TIMEVAR (flow_time,
+      TIMEVAR (TV_FLOW,
 	       {
 		 regclass (insns, max_reg_num ());
 		 stupid_life_analysis (insns, max_reg_num (),
@@ -3627,7 +3653,7 @@ rest_of_compilation (decl)
 	 and write some of the results to dump file.  */
 
       TIMEVAR
-	(flow_time,
+	(TV_FLOW,
 	 {
 	   find_basic_blocks (insns, max_reg_num (), rtl_dump_file, 1);
 	   life_analysis (insns, max_reg_num (), rtl_dump_file);
@@ -3649,7 +3675,7 @@ rest_of_compilation (decl)
 
   if (optimize > 0)
     {
-      TIMEVAR (combine_time, combine_instructions (insns, max_reg_num ()));
+      TIMEVAR (TV_COMBINE, combine_instructions (insns, max_reg_num ()));
       
       /* Dump rtl code after insn combination.  */
       
@@ -3664,7 +3690,7 @@ rest_of_compilation (decl)
       if (regmove_dump)
 	open_dump_file (".regmove", decl_printable_name (decl, 2));
       
-      TIMEVAR (regmove_time, regmove_optimize (insns, max_reg_num (),
+      TIMEVAR (TV_REGMOVE, regmove_optimize (insns, max_reg_num (),
 					       rtl_dump_file));
       
       if (regmove_dump)
@@ -3682,7 +3708,7 @@ rest_of_compilation (decl)
       /* Do control and data sched analysis,
 	 and write some of the results to dump file.  */
 
-      TIMEVAR (sched_time, schedule_insns (rtl_dump_file));
+      TIMEVAR (TV_SCHED, schedule_insns (rtl_dump_file));
       
       /* Dump rtl after instruction scheduling.  */
       
@@ -3694,7 +3720,7 @@ rest_of_compilation (decl)
      allocate pseudo-regs that are used only within 1 basic block.  */
 
   if (!obey_regdecls)
-    TIMEVAR (local_alloc_time,
+    TIMEVAR (TV_LOCAL_ALLOC,
 	     {
 	       recompute_reg_usage (insns);
 	       regclass (insns, max_reg_num ());
@@ -3707,8 +3733,8 @@ rest_of_compilation (decl)
     {
       open_dump_file (".lreg", decl_printable_name (decl, 2));
       
-      TIMEVAR (dump_time, dump_flow_info (rtl_dump_file));
-      TIMEVAR (dump_time, dump_local_alloc (rtl_dump_file));
+      TIMEVAR (TV_DUMP, dump_flow_info (rtl_dump_file));
+      TIMEVAR (TV_DUMP, dump_local_alloc (rtl_dump_file));
       
       close_dump_file (print_rtl_with_bb, insns);
     }
@@ -3724,7 +3750,7 @@ rest_of_compilation (decl)
      allocate remaining pseudo-regs, then do the reload pass
      fixing up any insns that are invalid.  */
 
-  TIMEVAR (global_alloc_time,
+  TIMEVAR (TV_GLOBAL_ALLOC,
 	   {
 	     if (!obey_regdecls)
 	       failure = global_alloc (rtl_dump_file);
@@ -3751,7 +3777,7 @@ rest_of_compilation (decl)
 
   if (global_reg_dump)
     {
-      TIMEVAR (dump_time, dump_global_regs (rtl_dump_file));
+      TIMEVAR (TV_DUMP, dump_global_regs (rtl_dump_file));
       close_dump_file (print_rtl_with_bb, insns);
     }
   if (optimize > 0 && flag_schedule_insns_after_reload)
@@ -3762,7 +3788,7 @@ rest_of_compilation (decl)
       /* Do control and data sched analysis again,
 	 and write some more of the results to dump file.  */
 
-      TIMEVAR (sched2_time, schedule_insns (rtl_dump_file));
+      TIMEVAR (TV_SCHED2, schedule_insns (rtl_dump_file));
 
       /* Dump rtl after post-reorder instruction scheduling.  */
 
@@ -3776,6 +3802,19 @@ rest_of_compilation (decl)
     leaf_function = 1;
 #endif
 
+  /* Lay out the basic blocks using the profile data, if any.  */
+
+  if (optimize > 0 && flag_reorder_blocks)
+    {
+      if (bbro_dump)
+	open_dump_file (".bbro", decl_printable_name (decl, 2));
+
+      TIMEVAR (TV_REORDER_BLOCKS, reorder_basic_blocks (insns, rtl_dump_file));
+
+      if (bbro_dump)
+	close_dump_file (print_rtl_with_bb, insns);
+    }
+
   /* One more attempt to remove jumps to .+1
      left by dead-store-elimination.
      Also do cross-jumping this time
@@ -3783,7 +3822,7 @@ rest_of_compilation (decl)
 
   if (optimize > 0)
     {
-      TIMEVAR (jump_time, jump_optimize (insns, JUMP_CROSS_JUMP,
+      TIMEVAR (TV_JUMP, jump_optimize (insns, JUMP_CROSS_JUMP,
 					 JUMP_NOOP_MOVES,
 					 !JUMP_AFTER_REGSCAN));
       
@@ -3807,7 +3846,7 @@ rest_of_compilation (decl)
 #ifdef DELAY_SLOTS
   if (optimize > 0 && flag_delayed_branch)
     {
-      TIMEVAR (dbr_sched_time, dbr_schedule (insns, rtl_dump_file));
+      TIMEVAR (TV_DBR_SCHED, dbr_schedule (insns, rtl_dump_file));
       
       if (dbr_sched_dump)
 	dump_rtl (".dbr", decl, print_rtl_with_bb, insns);
@@ -3815,13 +3854,13 @@ rest_of_compilation (decl)
 #endif
 
   /* Shorten branches.  */
-  TIMEVAR (shorten_branch_time,
+  TIMEVAR (TV_SHORTEN_BRANCH,
 	   {
 	     shorten_branches (get_insns ());
 	   });
 
 #ifdef STACK_REGS
-  TIMEVAR (stack_reg_time, reg_to_stack (insns, rtl_dump_file));
+  TIMEVAR (TV_STACK_REG, reg_to_stack (insns, rtl_dump_file));
 
   if (stack_reg_dump)
     dump_rtl (".stack", decl, print_rtl_with_bb, insns);
@@ -3829,7 +3868,7 @@ rest_of_compilation (decl)
 
   /* Now turn the rtl into assembler code.  */
 
-  TIMEVAR (final_time,
+  TIMEVAR (TV_FINAL,
 	   {
 	     rtx x;
 	     char *fnname;
@@ -3870,17 +3909,17 @@ rest_of_compilation (decl)
 
 #ifdef DBX_DEBUGGING_INFO
   if (write_symbols == DBX_DEBUG)
-    TIMEVAR (symout_time, dbxout_function (decl));
+    TIMEVAR (TV_SYMOUT, dbxout_function (decl));
 #endif
 
 #ifdef DWARF_DEBUGGING_INFO
   if (write_symbols == DWARF_DEBUG)
-    TIMEVAR (symout_time, dwarfout_file_scope_decl (decl, 0));
+    TIMEVAR (TV_SYMOUT, dwarfout_file_scope_decl (decl, 0));
 #endif
 
 #ifdef DWARF2_DEBUGGING_INFO
   if (write_symbols == DWARF2_DEBUG)
-    TIMEVAR (symout_time, dwarf2out_decl (decl));
+    TIMEVAR (TV_SYMOUT, dwarf2out_decl (decl));
 #endif
 
  exit_rest_of_compilation:
@@ -3907,7 +3946,7 @@ rest_of_compilation (decl)
 
   reload_completed = 0;
 
-  TIMEVAR (final_time,
+  TIMEVAR (TV_FINAL,
 	   {
 	      /* Clear out the insn_length contents now that they are no
 		 longer valid.  */
@@ -3935,10 +3974,13 @@ rest_of_compilation (decl)
 
   init_recog_no_volatile ();
 
-  /* The parsing time is all the time spent in yyparse
-     *except* what is spent in this function.  */
+  timevar_pop (TV_REST_OF_COMPILATION);
 
-  parse_time -= get_run_time () - start_time;
+  if (flag_time_report && ! quiet_flag)
+    timevar_print_function (stderr, (*decl_printable_name) (decl, 2));
+  if (time_report_file)
+    timevar_print_records (time_report_file, "function",
+			   IDENTIFIER_POINTER (DECL_ASSEMBLER_NAME (decl)), 1);
 }
 
 static void
@@ -4290,6 +4332,7 @@ main (argc, argv, envp)
       flag_schedule_insns_after_reload = 1;
 #endif
       flag_regmove = 1;
+      flag_reorder_blocks = 1;
       /* We don't set flag_strict_aliasing here because we're still
 	 testing the functionality.  After it has been tested, it
 	 should be turned on here.  */
@@ -4375,8 +4418,11 @@ main (argc, argv, envp)
  		    rtl_dump = 1;
  		    cse_dump = 1, cse2_dump = 1;
 		    gcse_dump = 1;
+		    vect_dump = 1;
+		    msched_dump = 1;
  		    sched_dump = 1;
  		    sched2_dump = 1;
+		    bbro_dump = 1;
 #ifdef STACK_REGS
 		    stack_reg_dump = 1;
 #endif
@@ -4390,6 +4436,9 @@ main (argc, argv, envp)
 		  case 'b':
 		    branch_prob_dump = 1;
 		    break;
+		  case 'B':
+		    bbro_dump = 1;
+		    break;
 		  case 'c':
 		    combine_dump = 1;
 		    break;
@@ -4435,6 +4484,9 @@ main (argc, argv, envp)
 		    mach_dep_reorg_dump = 1;
 		    break;
 #endif
+		  case 'o':
+		    msched_dump = 1;
+		    break;
 		  case 'p':
 		    flag_print_asm_name = 1;
 		    break;
@@ -4453,6 +4505,9 @@ main (argc, argv, envp)
 		  case 't':
 		    cse2_dump = 1;
 		    break;
+		  case 'V':
+		    vect_dump = 1;
+		    break;
 		  case 'N':
 		    regmove_dump = 1;
 		    break;
@@ -4503,6 +4558,8 @@ main (argc, argv, envp)
 		fix_sched_param("verbose",&p[14]);
 #endif
 #endif  /* HAIFA */
+	      else if (!strncmp (p, "time-report-file=", 17))
+		time_report_file_name = &p[17];
 	      else if (!strncmp (p, "fixed-", 6))
 		fix_register (&p[6], 1, 1);
 	      else if (!strncmp (p, "call-used-", 10))
@@ -4850,6 +4907,7 @@ main (argc, argv, envp)
       char *lim = (char *) sbrk (0);
 
       fprintf (stderr, "Data size %ld.\n", (long)(lim - (char *) &environ));
+      dump_identifier_statistics ();
       fflush (stderr);
 
 #ifndef __MSDOS__
@@ -248,10 +248,32 @@ char *tree_node_kind_names[] = {
   "lang_type kinds"
 };
 
-/* Hash table for uniquizing IDENTIFIER_NODEs by name.  */
+/* Hash table for uniquizing IDENTIFIER_NODEs by name.
 
-#define MAX_HASH_TABLE 1009
-static tree hash_table[MAX_HASH_TABLE];	/* id hash buckets */
+   The table is open-addressed with linear probing.  Its size is always
+   a power of two, and it is doubled whenever it becomes more than
+   half full.  Each slot records the full hash code of its
+   identifier next to the node, so that a probe only has to look at
+   the name when the hash codes already match.  */
+
+struct id_hash_entry
+{
+  unsigned int hash;
+  tree id;
+};
+
+#define INITIAL_ID_HASH_SIZE 1024
+
+static struct id_hash_entry *id_hash_table;
+static unsigned int id_hash_size;	/* Number of slots; a power of 2.  */
+static unsigned int id_hash_count;	/* Number of slots in use.  */
+
+/* Statistics about the identifier hash table, printed by
+   dump_identifier_statistics.  */
+static int id_hash_searches;
+static int id_hash_probes;
+static int id_hash_max_probes;
+static int id_hash_expansions;
 
 /* 0 while creating built-in identifiers.  */
 static int do_identifier_warnings;
@@ -270,6 +292,10 @@ int (*lang_get_alias_set) PROTO((tree));
 #define TYPE_HASH(TYPE) ((unsigned long) (TYPE) & 0777777)
 
 static void append_random_chars PROTO((char *));
+static unsigned int identifier_hash PROTO((char *, int));
+static struct id_hash_entry *lookup_identifier_slot PROTO((char *, int,
+							   unsigned int));
+static void expand_identifier_table PROTO((void));
 
 extern char *mode_name[];
 
@@ -301,7 +327,10 @@ init_obstacks ()
   rtl_obstack = saveable_obstack = &permanent_obstack;
 
   /* Init the hash table of identifiers.  */
-  bzero ((char *) hash_table, sizeof hash_table);
+  id_hash_size = INITIAL_ID_HASH_SIZE;
+  id_hash_count = 0;
+  id_hash_table = (struct id_hash_entry *)
+    xcalloc (id_hash_size, sizeof (struct id_hash_entry));
 }
 
 void
@@ -1247,7 +1276,84 @@ copy_list (list)
   return head;
 }
 
-#define HASHBITS 30
+/* Return the hash code of the first HASH_LEN characters of TEXT.  */
+
+static unsigned int
+identifier_hash (text, hash_len)
+     char *text;
+     int hash_len;
+{
+  register unsigned int hi = hash_len;
+  register int i;
+
+  for (i = 0; i < hash_len; i++)
+    hi = (hi * 613) + (unsigned char) text[i];
+
+  /* The table index is taken from the low bits, so fold the high
+     bits down into them.  */
+  hi ^= hi >> 15;
+  hi *= 0x2c1b3c6d;
+  hi ^= hi >> 12;
+  return hi;
+}
+
+/* Find the slot for the identifier TEXT of length LEN whose hash
+   code is HASH.  Return either the slot holding that identifier, or
+   the empty slot at which it should be entered.  */
+
+static struct id_hash_entry *
+lookup_identifier_slot (text, len, hash)
+     char *text;
+     int len;
+     unsigned int hash;
+{
+  register unsigned int mask = id_hash_size - 1;
+  register unsigned int i = hash & mask;
+  register struct id_hash_entry *entry;
+  int probes = 1;
+
+  id_hash_searches++;
+  for (entry = &id_hash_table[i]; entry->id != NULL_TREE;
+       i = (i + 1) & mask, entry = &id_hash_table[i], probes++)
+    if (entry->hash == hash
+	&& IDENTIFIER_LENGTH (entry->id) == len
+	&& IDENTIFIER_POINTER (entry->id)[0] == text[0]
+	&& !bcmp (IDENTIFIER_POINTER (entry->id), text, len))
+      break;
+
+  id_hash_probes += probes;
+  if (probes > id_hash_max_probes)
+    id_hash_max_probes = probes;
+  return entry;
+}
+
+/* Double the size of the identifier hash table and reenter all the
+   identifiers in it.  */
+
+static void
+expand_identifier_table ()
+{
+  struct id_hash_entry *old_table = id_hash_table;
+  unsigned int old_size = id_hash_size;
+  unsigned int mask, i, j;
+
+  id_hash_size = old_size * 2;
+  mask = id_hash_size - 1;
+  id_hash_table = (struct id_hash_entry *)
+    xcalloc (id_hash_size, sizeof (struct id_hash_entry));
+
+  for (i = 0; i < old_size; i++)
+    if (old_table[i].id != NULL_TREE)
+      {
+	for (j = old_table[i].hash & mask; id_hash_table[j].id != NULL_TREE;
+	     j = (j + 1) & mask)
+	  ;
+	id_hash_table[j] = old_table[i];
+      }
+
+  free (old_table);
+  id_hash_expansions++;
+}
 
 /* Return an IDENTIFIER_NODE whose name is TEXT (a null-terminated string).
    If an identifier with that name has previously been referred to,
@@ -1257,10 +1363,10 @@ tree
 get_identifier (text)
      register char *text;
 {
-  register int hi;
-  register int i;
   register tree idp;
   register int len, hash_len;
+  unsigned int hash;
+  struct id_hash_entry *entry;
 
   /* Compute length of text in len.  */
   for (len = 0; text[len]; len++);
@@ -1270,35 +1376,38 @@ get_identifier (text)
   if (warn_id_clash && len > id_clash_len)
     hash_len = id_clash_len;
 
-  /* Compute hash code */
-  hi = hash_len * 613 + (unsigned) text[0];
-  for (i = 1; i < hash_len; i += 2)
-    hi = ((hi * 613) + (unsigned) (text[i]));
-
-  hi &= (1 << HASHBITS) - 1;
-  hi %= MAX_HASH_TABLE;
-  
   /* Search table for identifier */
-  for (idp = hash_table[hi]; idp; idp = TREE_CHAIN (idp))
-    if (IDENTIFIER_LENGTH (idp) == len
-	&& IDENTIFIER_POINTER (idp)[0] == text[0]
-	&& !bcmp (IDENTIFIER_POINTER (idp), text, len))
-      return idp;		/* <-- return if found */
-
-  /* Not found; optionally warn about a similar identifier */
+  hash = identifier_hash (text, hash_len);
+  entry = lookup_identifier_slot (text, len, hash);
+  if (entry->id != NULL_TREE)
+    return entry->id;		/* <-- return if found */
+
+  /* Not found; optionally warn about a similar identifier.  Every
+     identifier sharing the first ID_CLASH_LEN characters has the same
+     hash code, so it lies in the run of slots just searched.  */
   if (warn_id_clash && do_identifier_warnings && len >= id_clash_len)
-    for (idp = hash_table[hi]; idp; idp = TREE_CHAIN (idp))
-      if (!strncmp (IDENTIFIER_POINTER (idp), text, id_clash_len))
+    {
+      unsigned int mask = id_hash_size - 1;
+      unsigned int i;
+
+      for (i = hash & mask; id_hash_table[i].id != NULL_TREE;
+	   i = (i + 1) & mask)
 	{
-	  warning ("`%s' and `%s' identical in first %d characters",
-		   IDENTIFIER_POINTER (idp), text, id_clash_len);
-	  break;
+	  idp = id_hash_table[i].id;
+	  if (id_hash_table[i].hash == hash
+	      && !strncmp (IDENTIFIER_POINTER (idp), text, id_clash_len))
+	    {
+	      warning ("`%s' and `%s' identical in first %d characters",
+		       IDENTIFIER_POINTER (idp), text, id_clash_len);
+	      break;
+	    }
 	}
+    }
 
   if (tree_code_length[(int) IDENTIFIER_NODE] < 0)
     abort ();			/* set_identifier_size hasn't been called.  */
 
-  /* Not found, create one, add to chain */
+  /* Not found, create one, add to table */
   idp = make_node (IDENTIFIER_NODE);
   IDENTIFIER_LENGTH (idp) = len;
 #ifdef GATHER_STATISTICS
@@ -1307,8 +1416,10 @@ get_identifier (text)
 
   IDENTIFIER_POINTER (idp) = obstack_copy0 (&permanent_obstack, text, len);
 
-  TREE_CHAIN (idp) = hash_table[hi];
-  hash_table[hi] = idp;
+  entry->hash = hash;
+  entry->id = idp;
+  if (++id_hash_count * 2 > id_hash_size)
+    expand_identifier_table ();
   return idp;			/* <-- return if created */
 }
 
@@ -1320,9 +1431,6 @@ tree
 maybe_get_identifier (text)
      register char *text;
 {
-  register int hi;
-  register int i;
-  register tree idp;
   register int len, hash_len;
 
   /* Compute length of text in len.  */
@@ -1333,22 +1441,26 @@ maybe_get_identifier (text)
   if (warn_id_clash && len > id_clash_len)
     hash_len = id_clash_len;
 
-  /* Compute hash code */
-  hi = hash_len * 613 + (unsigned) text[0];
-  for (i = 1; i < hash_len; i += 2)
-    hi = ((hi * 613) + (unsigned) (text[i]));
-
-  hi &= (1 << HASHBITS) - 1;
-  hi %= MAX_HASH_TABLE;
-  
   /* Search table for identifier */
-  for (idp = hash_table[hi]; idp; idp = TREE_CHAIN (idp))
-    if (IDENTIFIER_LENGTH (idp) == len
-	&& IDENTIFIER_POINTER (idp)[0] == text[0]
-	&& !bcmp (IDENTIFIER_POINTER (idp), text, len))
-      return idp;		/* <-- return if found */
+  return lookup_identifier_slot (text, len,
+				 identifier_hash (text, hash_len))->id;
+}
 
-  return NULL_TREE;
+/* Print statistics about the identifier hash table to stderr.  */
+
+void
+dump_identifier_statistics ()
+{
+  fprintf (stderr, "\nIdentifier hash table\n\n");
+  fprintf (stderr, "%-20s %9u\n", "identifiers", id_hash_count);
+  fprintf (stderr, "%-20s %9u\n", "slots", id_hash_size);
+  fprintf (stderr, "%-20s %9d\n", "expansions", id_hash_expansions);
+  fprintf (stderr, "%-20s %9d\n", "searches", id_hash_searches);
+  fprintf (stderr, "%-20s %9d\n", "probes", id_hash_probes);
+  if (id_hash_searches)
+    fprintf (stderr, "%-20s %9.2f\n", "probes/search",
+	     (double) id_hash_probes / id_hash_searches);
+  fprintf (stderr, "%-20s %9d\n", "longest search", id_hash_max_probes);
 }
 
 /* Enable warnings on similar identifiers (if requested).
@@ -4801,6 +4913,7 @@ dump_tree_statistics ()
   print_obstack_statistics ("temp_decl_obstack", &temp_decl_obstack);
   print_inline_obstack_statistics ();
   print_lang_statistics ();
+  dump_identifier_statistics ();
 }
 
 #define FILE_FUNCTION_PREFIX_LEN 9
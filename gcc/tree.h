@@ -2089,6 +2089,7 @@ extern void rtl_in_current_obstack	PROTO ((void));
 extern void rtl_in_saveable_obstack	PROTO ((void));
 extern void init_tree_codes		PROTO ((void));
 extern void dump_tree_statistics	PROTO ((void));
+extern void dump_identifier_statistics	PROTO ((void));
 extern void print_obstack_statistics	PROTO ((char *, struct obstack *));
 #ifdef BUFSIZ
 extern void print_obstack_name		PROTO ((char *, FILE *, char *));
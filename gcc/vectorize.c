@@ -0,0 +1,2013 @@
+/* Vectorization of loops over arrays of small integers.
+   Copyright (C) 1999 Free Software Foundation, Inc.
+
+This file is part of GNU CC.
+
+GNU CC is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+GNU CC is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with GNU CC; see the file COPYING.  If not, write to
+the Free Software Foundation, 59 Temple Place - Suite 330,
+Boston, MA 02111-1307, USA.  */
+
+
+/* This pass makes loops that work on one byte or halfword at a time
+   work on a whole word at a time.  A word is treated as a vector of
+   lanes, each holding one element, and the operations of the loop are
+   done on all the lanes at once with ordinary word instructions
+   ("SIMD within a register").  No vector modes or instructions are
+   needed, so this works on any target whose words are at least twice
+   as wide as the elements; it pays best on 64-bit targets, which do
+   eight byte operations at a time.
+
+   Logical operations work on lanes as they stand.  Additions,
+   subtractions and negations keep the carries from crossing from one
+   lane into the next by working on the low bits of each lane and
+   putting the top bits back with an exclusive or.  Shifts left mask
+   off the bits shifted out of each lane.  A multiplication by a number
+   that is the same in every iteration is done on the even and the odd
+   lanes separately, each in a field twice as wide as a lane.  A sum of
+   the elements is kept in an accumulator word, to which the lanes of
+   each word are folded.
+
+   The loops handled are those the loop optimizer would see as a single
+   basic block: a NOTE_INSN_LOOP_BEG note, a label used only by the
+   branch back to it, single sets, the conditional branch back, and the
+   NOTE_INSN_LOOP_END note.  The pass runs after global CSE and before
+   loop optimization, so that the loop optimizer strength reduces the
+   addresses of the new loop.  A loop is vectorized when
+
+	- each register set in it is set once, and is an induction
+	  variable incremented by a constant, a sum of elements, or a
+	  temporary not used outside the loop;
+	- each memory reference has the same integer mode, at most half a
+	  word wide, and an address that advances by the size of that
+	  mode in each iteration;
+	- the data of each store and sum is computed from loads with the
+	  operations above, at least as wide as the elements, and from
+	  values that are the same in every iteration;
+	- the exit test compares a linear function of the induction
+	  variables with a value that is the same in every iteration, so
+	  that the trip count can be computed before the loop.
+
+   Before the loop, the trip count N is computed, and the vector loop
+   is run N / VF times, where VF is the number of lanes in a word,
+   provided that this is not zero and that every address is word
+   aligned on entry.  The original loop then runs the remaining
+   iterations, or all of them if the vector loop could not be used.
+
+   Since every reference has the same size and stride, and they are all
+   aligned on entry, two references to the same element are either
+   made in the same iteration, in which case the vector loop makes them
+   in the same order, or a multiple of VF iterations apart, in which
+   case they fall in the same lane of different iterations of the
+   vector loop.  So the loop may store into the arrays it loads from
+   and nothing needs to be known about the pointers.  */
+
+#include "config.h"
+#include "system.h"
+#include "rtl.h"
+#include "regs.h"
+#include "flags.h"
+#include "insn-config.h"
+#include "insn-flags.h"
+#include "recog.h"
+#include "expr.h"
+#include "toplev.h"
+
+/* The largest loop body handled, in insns.  */
+#define MAX_LOOP_INSNS 64
+
+/* The largest number of memory references in a loop body, and of
+   terms in the linear function of an address or exit test.  */
+#define MAX_MEMS 16
+#define MAX_TERMS 6
+
+/* The most nodes walked to decide whether a value is the same in each
+   iteration, which keeps values built from shared subexpressions from
+   taking exponential time.  */
+#define MAX_NODES 200
+
+/* The number of simple insns a multiply is taken to cost.  */
+#define MULT_INSNS 4
+
+/* What a register is in the loop being vectorized.  */
+
+enum vect_kind
+{
+  /* Not set in the loop.  */
+  V_INVARIANT,
+  /* Incremented by a constant once in each iteration.  */
+  V_BIV,
+  /* Set once to itself plus an element, and not otherwise used.  */
+  V_SUM,
+  /* Set once, and not yet classified.  */
+  V_TEMP,
+  /* A temporary with the same value in each iteration.  */
+  V_CONSTANT,
+  /* A temporary with a different value in each iteration, computed
+     from induction variables only.  */
+  V_SCALAR,
+  /* A temporary holding an element.  */
+  V_LANES,
+  /* A temporary that the vector loop does not compute.  */
+  V_UNKNOWN
+};
+
+/* A linear function of the induction variables: the sum of CONSTANT
+   and of each term times its coefficient.  A term is an induction
+   variable or a value that is the same in every iteration.  */
+
+struct linear
+{
+  int n_terms;
+  rtx terms[MAX_TERMS];
+  HOST_WIDE_INT coefs[MAX_TERMS];
+  HOST_WIDE_INT constant;
+};
+
+/* The memory references of the loop in the order they are made, and
+   the linear function of the address of the word each is in in the
+   vector loop.  */
+
+struct vect_mem
+{
+  rtx mem;
+  struct linear addr;
+};
+
+static struct vect_mem mems[MAX_MEMS];
+static int n_mems;
+
+/* How much the addresses change from one iteration to the next.  */
+static HOST_WIDE_INT mem_stride;
+
+/* The number of stores in the loop.  */
+static int n_stores;
+
+/* The index in MEMS of the next reference to be emitted.  */
+static int next_mem;
+
+/* The induction variables of the loop.  */
+static rtx bivs[MAX_LOOP_INSNS];
+static int n_bivs;
+
+/* The sums of the loop, whether the elements of each are sign
+   extended, and the accumulator of each in the vector loop.  */
+
+struct vect_sum
+{
+  rtx reg;
+  int signedp;
+  rtx acc;
+};
+
+static struct vect_sum sums[MAX_LOOP_INSNS];
+static int n_sums;
+
+/* The mode of the elements, its width in bits, and the number of lanes
+   in a word.  */
+static enum machine_mode lane_mode;
+static int lane_bits;
+static int n_lanes;
+
+/* The exit test: the loop goes on while EXIT_VAR, which changes by
+   EXIT_STEP in each iteration, compares with EXIT_BOUND by EXIT_CODE
+   in EXIT_MODE.  EXIT_VAR is its value at the end of the first
+   iteration.  */
+static struct linear exit_var, exit_bound;
+static HOST_WIDE_INT exit_step;
+static enum rtx_code exit_code;
+static enum machine_mode exit_mode;
+
+/* The words set up before the vector loop: constants, values that are
+   the same in each iteration copied into each lane, and multipliers in
+   the low lane only.  */
+
+enum inv_kind
+{
+  INV_CONST,
+  INV_SPLAT,
+  INV_LANE
+};
+
+struct vect_inv
+{
+  enum inv_kind kind;
+  rtx value;
+  rtx reg;
+};
+
+static struct vect_inv *invariants;
+static int n_invariants;
+static int max_invariants;
+
+/* The number of pseudo registers before the pass, the size of the
+   following arrays.  */
+static int vect_max_reg;
+
+/* For each register, the number of times it is set and used in
+   the loop being vectorized, its kind, and whether the insn that sets
+   it has been reached in the scan of the body.  */
+static int *reg_sets;
+static int *reg_refs;
+static char *reg_kind;
+static char *reg_reached;
+
+/* For each induction variable, its step.  For each V_CONSTANT or
+   V_SCALAR temporary, its value in terms of the registers not set in
+   the loop and of the induction variables at the top of the loop.  For
+   each V_LANES temporary, the expression it is set to; and in the
+   vector loop, the register holding its lanes.  */
+static HOST_WIDE_INT *reg_step;
+static rtx *reg_tree;
+static rtx *reg_src;
+static rtx *reg_vector;
+
+/* The registers whose entries in the arrays above have been changed.  */
+static int *touched;
+static int n_touched;
+
+/* The number of nodes that may still be walked.  */
+static int budget;
+
+static FILE *vect_dump;
+
+static rtx insn_set			PROTO ((rtx));
+static int loop_ok			PROTO ((rtx, rtx *, rtx *, rtx *));
+static int note_refs			PROTO ((rtx));
+static int classify_regs		PROTO ((rtx, rtx));
+static int temp_mentioned_p		PROTO ((rtx));
+static int outside_refs_p		PROTO ((rtx, rtx, rtx));
+static rtx value_tree			PROTO ((rtx));
+static int invariant_p			PROTO ((rtx));
+static int lin_add			PROTO ((struct linear *, rtx,
+						HOST_WIDE_INT));
+static int lin_init			PROTO ((struct linear *, rtx));
+static HOST_WIDE_INT lin_stride		PROTO ((struct linear *));
+static int lin_equal			PROTO ((struct linear *,
+						struct linear *));
+static int lane_free_p			PROTO ((rtx));
+static int lanes_p			PROTO ((rtx));
+static int record_mem			PROTO ((rtx));
+static int data_cost			PROTO ((rtx, int *));
+static int temp_cost			PROTO ((rtx, int *));
+static int sum_cost			PROTO ((rtx, rtx, int *));
+static int analyze_exit			PROTO ((rtx));
+static int analyze_loop			PROTO ((rtx, rtx, int *, int *));
+static rtx lane_constant		PROTO ((HOST_WIDE_INT, int, int));
+static rtx invariant_reg		PROTO ((rtx, enum inv_kind));
+static rtx word_op			PROTO ((optab, rtx, rtx));
+static rtx expand_tree			PROTO ((rtx));
+static rtx expand_lin			PROTO ((struct linear *,
+						enum machine_mode));
+static void emit_jump_if		PROTO ((enum rtx_code, rtx, rtx,
+						enum machine_mode, rtx));
+static void emit_invariant		PROTO ((struct vect_inv *));
+static rtx lanes_add			PROTO ((rtx, rtx));
+static rtx lanes_sub			PROTO ((rtx, rtx));
+static rtx lanes_shift			PROTO ((rtx, int));
+static rtx lanes_mult			PROTO ((rtx, rtx));
+static rtx fold_lanes			PROTO ((rtx));
+static rtx word_mem			PROTO ((rtx));
+static rtx emit_data			PROTO ((rtx));
+static void emit_sum			PROTO ((rtx, rtx));
+static void emit_body			PROTO ((rtx, rtx));
+static void vectorize_loop		PROTO ((rtx, rtx, rtx, rtx));
+static void try_loop			PROTO ((rtx, rtx));
+
+/* The bits of a lane, and its top bit.  */
+#define LANE_MASK \
+  ((HOST_WIDE_INT) (((unsigned HOST_WIDE_INT) 2 << (lane_bits - 1)) - 1))
+#define LANE_HIGH ((HOST_WIDE_INT) 1 << (lane_bits - 1))
+
+/* Return the set made by INSN, or zero if it does anything else.  The
+   insn may also clobber hard or scratch registers, as a multiplication
+   does on some targets.  */
+
+static rtx
+insn_set (insn)
+     rtx insn;
+{
+  rtx pat = PATTERN (insn);
+  rtx x;
+  int i;
+
+  if (GET_CODE (pat) == SET)
+    return pat;
+  if (GET_CODE (pat) != PARALLEL || GET_CODE (XVECEXP (pat, 0, 0)) != SET)
+    return 0;
+
+  for (i = 1; i < XVECLEN (pat, 0); i++)
+    {
+      x = XVECEXP (pat, 0, i);
+      if (GET_CODE (x) != CLOBBER
+	  || (GET_CODE (XEXP (x, 0)) != SCRATCH
+	      && (GET_CODE (XEXP (x, 0)) != REG
+		  || REGNO (XEXP (x, 0)) >= FIRST_PSEUDO_REGISTER)))
+	return 0;
+    }
+  return XVECEXP (pat, 0, 0);
+}
+
+/* Return nonzero if the insns after the NOTE_INSN_LOOP_BEG note
+   LOOP_BEG form a loop this pass can handle.  Store the label at its
+   top, the branch back to it and the NOTE_INSN_LOOP_END note in *PTOP,
+   *PJUMP and *PEND.  */
+
+static int
+loop_ok (loop_beg, ptop, pjump, pend)
+     rtx loop_beg;
+     rtx *ptop, *pjump, *pend;
+{
+  rtx insn, top;
+  int n = 0;
+
+  for (top = NEXT_INSN (loop_beg); top && GET_CODE (top) == NOTE;
+       top = NEXT_INSN (top))
+    if (NOTE_LINE_NUMBER (top) == NOTE_INSN_LOOP_BEG
+	|| NOTE_LINE_NUMBER (top) == NOTE_INSN_LOOP_END)
+      return 0;
+
+  if (top == 0 || GET_CODE (top) != CODE_LABEL || LABEL_NUSES (top) != 1
+      || LABEL_PRESERVE_P (top))
+    return 0;
+
+  for (insn = NEXT_INSN (top); insn; insn = NEXT_INSN (insn))
+    {
+      switch (GET_CODE (insn))
+	{
+	case NOTE:
+	  if (NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_END
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_EH_REGION_BEG
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_EH_REGION_END
+	      || NOTE_LINE_NUMBER (insn) == NOTE_INSN_SETJMP)
+	    return 0;
+	  continue;
+
+	case INSN:
+	  if (++n >= MAX_LOOP_INSNS || insn_set (insn) == 0)
+	    return 0;
+	  continue;
+
+	case JUMP_INSN:
+	  if (! condjump_p (insn) || JUMP_LABEL (insn) != top
+	      || GET_CODE (SET_SRC (PATTERN (insn))) != IF_THEN_ELSE)
+	    return 0;
+	  break;
+
+	default:
+	  return 0;
+	}
+      break;
+    }
+
+  if (insn == 0 || n == 0)
+    return 0;
+  *pjump = insn;
+
+  for (insn = NEXT_INSN (insn); insn && GET_CODE (insn) == NOTE;
+       insn = NEXT_INSN (insn))
+    if (NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_END)
+      {
+	*ptop = top;
+	*pend = insn;
+	return 1;
+      }
+
+  return 0;
+}
+
+/* Count the references to registers in X.  Return zero if X mentions a
+   hard register other than the stack, frame and argument pointers, or
+   a register made after the pass started.  */
+
+static int
+note_refs (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i, j;
+  int regno;
+
+  if (code == REG)
+    {
+      regno = REGNO (x);
+      if (regno >= vect_max_reg
+	  || (regno < FIRST_PSEUDO_REGISTER
+	      && regno != STACK_POINTER_REGNUM
+	      && regno != FRAME_POINTER_REGNUM
+	      && regno != HARD_FRAME_POINTER_REGNUM
+	      && regno != ARG_POINTER_REGNUM))
+	return 0;
+      if (reg_sets[regno] == 0 && reg_refs[regno] == 0)
+	touched[n_touched++] = regno;
+      reg_refs[regno]++;
+      return 1;
+    }
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (! note_refs (XEXP (x, i)))
+	    return 0;
+	}
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (! note_refs (XVECEXP (x, i, j)))
+	    return 0;
+    }
+  return 1;
+}
+
+/* Count the sets and references of the registers in the loop from TOP
+   to JUMP, and find the induction variables, sums and temporaries.
+   Return zero if the loop sets something this pass cannot handle.  */
+
+static int
+classify_regs (top, jump)
+     rtx top, jump;
+{
+  rtx insn, set, dest;
+  int regno;
+
+  for (insn = NEXT_INSN (top); ; insn = NEXT_INSN (insn))
+    {
+      if (GET_CODE (insn) == NOTE)
+	continue;
+      if (volatile_refs_p (PATTERN (insn)))
+	return 0;
+      set = insn_set (insn);
+      if (insn == jump)
+	return note_refs (SET_SRC (set));
+
+      dest = SET_DEST (set);
+      if (GET_CODE (dest) == REG)
+	{
+	  regno = REGNO (dest);
+	  if (regno < FIRST_PSEUDO_REGISTER || regno >= vect_max_reg)
+	    return 0;
+	  if (reg_sets[regno] == 0 && reg_refs[regno] == 0)
+	    touched[n_touched++] = regno;
+	  reg_sets[regno]++;
+	}
+      else if (GET_CODE (dest) != MEM || ! note_refs (XEXP (dest, 0)))
+	return 0;
+
+      if (! note_refs (SET_SRC (set)))
+	return 0;
+    }
+}
+
+/* Return nonzero if X mentions a temporary of the loop being
+   vectorized.  */
+
+static int
+temp_mentioned_p (x)
+     rtx x;
+{
+  register RTX_CODE code;
+  register char *fmt;
+  register int i, j;
+
+  if (x == 0)
+    return 0;
+
+  code = GET_CODE (x);
+  if (code == REG)
+    return REGNO (x) < vect_max_reg && reg_kind[REGNO (x)] == V_TEMP;
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    {
+      if (fmt[i] == 'e')
+	{
+	  if (temp_mentioned_p (XEXP (x, i)))
+	    return 1;
+	}
+      else if (fmt[i] == 'E')
+	for (j = 0; j < XVECLEN (x, i); j++)
+	  if (temp_mentioned_p (XVECEXP (x, i, j)))
+	    return 1;
+    }
+  return 0;
+}
+
+/* Return nonzero if a temporary of the loop from TOP to JUMP in
+   function F is mentioned outside it.  The vector loop does not set
+   the temporaries.  */
+
+static int
+outside_refs_p (f, top, jump)
+     rtx f, top, jump;
+{
+  rtx insn;
+
+  for (insn = f; insn; insn = NEXT_INSN (insn))
+    {
+      if (insn == top)
+	insn = jump;
+      else if (GET_RTX_CLASS (GET_CODE (insn)) == 'i'
+	       && (temp_mentioned_p (PATTERN (insn))
+		   || temp_mentioned_p (REG_NOTES (insn))
+		   || (GET_CODE (insn) == CALL_INSN
+		       && temp_mentioned_p (CALL_INSN_FUNCTION_USAGE (insn)))))
+	return 1;
+    }
+  return 0;
+}
+
+/* Return the value of X at the current point of the scan of the loop
+   body, in terms of the registers not set in the loop and of the
+   induction variables at the top of the loop; or zero if X loads from
+   memory or uses an element or an operation not handled here.  */
+
+static rtx
+value_tree (x)
+     rtx x;
+{
+  enum rtx_code code = GET_CODE (x);
+  enum machine_mode mode = GET_MODE (x);
+  rtx op0, op1, tem;
+  int regno;
+
+  switch (code)
+    {
+    case CONST_INT:
+    case CONST_DOUBLE:
+    case SYMBOL_REF:
+    case LABEL_REF:
+    case CONST:
+      return x;
+
+    case REG:
+      regno = REGNO (x);
+      switch (reg_kind[regno])
+	{
+	case V_INVARIANT:
+	  return x;
+
+	case V_BIV:
+	  if (reg_reached[regno])
+	    return gen_rtx_PLUS (mode, x, GEN_INT (reg_step[regno]));
+	  return x;
+
+	case V_CONSTANT:
+	case V_SCALAR:
+	  return reg_tree[regno];
+
+	default:
+	  return 0;
+	}
+
+    case SUBREG:
+      if (! subreg_lowpart_p (x)
+	  || (op0 = value_tree (SUBREG_REG (x))) == 0)
+	return 0;
+      if (GET_CODE (op0) == CONST_INT || GET_CODE (op0) == CONST_DOUBLE)
+	return gen_lowpart_common (mode, op0);
+      if (op0 == SUBREG_REG (x))
+	return x;
+      return gen_rtx_SUBREG (mode, op0, SUBREG_WORD (x));
+
+    case NEG:
+    case NOT:
+    case ZERO_EXTEND:
+    case SIGN_EXTEND:
+    case TRUNCATE:
+      if ((op0 = value_tree (XEXP (x, 0))) == 0)
+	return 0;
+      if (GET_MODE (XEXP (x, 0)) != VOIDmode
+	  && (tem = simplify_unary_operation (code, mode, op0,
+					      GET_MODE (XEXP (x, 0)))) != 0)
+	return tem;
+      if (op0 == XEXP (x, 0))
+	return x;
+      return gen_rtx_fmt_e (code, mode, op0);
+
+    case PLUS:
+    case MINUS:
+    case MULT:
+    case AND:
+    case IOR:
+    case XOR:
+    case ASHIFT:
+    case LSHIFTRT:
+    case ASHIFTRT:
+    case EQ:
+    case NE:
+    case LT:
+    case LE:
+    case GT:
+    case GE:
+    case LTU:
+    case LEU:
+    case GTU:
+    case GEU:
+      if ((op0 = value_tree (XEXP (x, 0))) == 0
+	  || (op1 = value_tree (XEXP (x, 1))) == 0)
+	return 0;
+      if (GET_RTX_CLASS (code) != '<'
+	  && (tem = simplify_binary_operation (code, mode, op0, op1)) != 0)
+	return tem;
+      if (op0 == XEXP (x, 0) && op1 == XEXP (x, 1))
+	return x;
+      return gen_rtx_fmt_ee (code, mode, op0, op1);
+
+    default:
+      return 0;
+    }
+}
+
+/* Return nonzero if the value X returned by value_tree is the same in
+   each iteration and can be computed before the loop.  */
+
+static int
+invariant_p (x)
+     rtx x;
+{
+  if (--budget < 0)
+    return 0;
+
+  switch (GET_CODE (x))
+    {
+    case REG:
+      return reg_kind[REGNO (x)] == V_INVARIANT;
+
+    case CONST_INT:
+    case CONST_DOUBLE:
+    case SYMBOL_REF:
+    case LABEL_REF:
+    case CONST:
+      return 1;
+
+    case SUBREG:
+    case NEG:
+    case NOT:
+    case ZERO_EXTEND:
+    case SIGN_EXTEND:
+    case TRUNCATE:
+      return invariant_p (XEXP (x, 0));
+
+    case PLUS:
+    case MINUS:
+    case MULT:
+    case AND:
+    case IOR:
+    case XOR:
+    case ASHIFT:
+    case LSHIFTRT:
+    case ASHIFTRT:
+      return invariant_p (XEXP (x, 0)) && invariant_p (XEXP (x, 1));
+
+    default:
+      return 0;
+    }
+}
+
+/* Add SCALE times the value X returned by value_tree to the linear
+   function LIN.  Return zero if X is not linear in the induction
+   variables.  */
+
+static int
+lin_add (lin, x, scale)
+     struct linear *lin;
+     rtx x;
+     HOST_WIDE_INT scale;
+{
+  int i;
+
+  if (--budget < 0)
+    return 0;
+
+  switch (GET_CODE (x))
+    {
+    case CONST_INT:
+      lin->constant += scale * INTVAL (x);
+      return 1;
+
+    case PLUS:
+      return (lin_add (lin, XEXP (x, 0), scale)
+	      && lin_add (lin, XEXP (x, 1), scale));
+
+    case MINUS:
+      return (lin_add (lin, XEXP (x, 0), scale)
+	      && lin_add (lin, XEXP (x, 1), - scale));
+
+    case NEG:
+      return lin_add (lin, XEXP (x, 0), - scale);
+
+    case MULT:
+      if (GET_CODE (XEXP (x, 1)) == CONST_INT)
+	return lin_add (lin, XEXP (x, 0), scale * INTVAL (XEXP (x, 1)));
+      break;
+
+    case ASHIFT:
+      if (GET_CODE (XEXP (x, 1)) == CONST_INT
+	  && INTVAL (XEXP (x, 1)) >= 0
+	  && INTVAL (XEXP (x, 1)) < HOST_BITS_PER_WIDE_INT / 2)
+	return lin_add (lin, XEXP (x, 0), scale << INTVAL (XEXP (x, 1)));
+      break;
+
+    case REG:
+      if (reg_kind[REGNO (x)] == V_BIV)
+	goto term;
+      break;
+
+    default:
+      break;
+    }
+
+  if (! invariant_p (x))
+    return 0;
+
+ term:
+  for (i = 0; i < lin->n_terms; i++)
+    if (rtx_equal_p (lin->terms[i], x))
+      {
+	lin->coefs[i] += scale;
+	return 1;
+      }
+  if (lin->n_terms == MAX_TERMS)
+    return 0;
+  lin->terms[lin->n_terms] = x;
+  lin->coefs[lin->n_terms++] = scale;
+  return 1;
+}
+
+/* Set LIN to the linear function for the value X returned by
+   value_tree.  Return zero if there is none.  */
+
+static int
+lin_init (lin, x)
+     struct linear *lin;
+     rtx x;
+{
+  lin->n_terms = 0;
+  lin->constant = 0;
+  budget = MAX_NODES;
+  return x != 0 && lin_add (lin, x, (HOST_WIDE_INT) 1);
+}
+
+/* Return how much LIN changes from one iteration to the next.  */
+
+static HOST_WIDE_INT
+lin_stride (lin)
+     struct linear *lin;
+{
+  HOST_WIDE_INT stride = 0;
+  int i;
+
+  for (i = 0; i < lin->n_terms; i++)
+    if (GET_CODE (lin->terms[i]) == REG
+	&& reg_kind[REGNO (lin->terms[i])] == V_BIV)
+      stride += lin->coefs[i] * reg_step[REGNO (lin->terms[i])];
+  return stride;
+}
+
+/* Return nonzero if A and B are the same linear function.  */
+
+static int
+lin_equal (a, b)
+     struct linear *a, *b;
+{
+  int i;
+
+  if (a->n_terms != b->n_terms || a->constant != b->constant)
+    return 0;
+  for (i = 0; i < a->n_terms; i++)
+    if (a->coefs[i] != b->coefs[i] || ! rtx_equal_p (a->terms[i], b->terms[i]))
+      return 0;
+  return 1;
+}
+
+/* Return nonzero if X does not depend on the elements or the induction
+   variables, so that it is the same in each lane.  */
+
+static int
+lane_free_p (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i;
+
+  if (code == MEM)
+    return 0;
+  if (code == REG)
+    return (reg_kind[REGNO (x)] == V_INVARIANT
+	    || reg_kind[REGNO (x)] == V_CONSTANT);
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    if (fmt[i] == 'E' || (fmt[i] == 'e' && ! lane_free_p (XEXP (x, i))))
+      return 0;
+  return 1;
+}
+
+/* Return nonzero if X depends on an element, or on a temporary that
+   the vector loop does not compute.  */
+
+static int
+lanes_p (x)
+     rtx x;
+{
+  register RTX_CODE code = GET_CODE (x);
+  register char *fmt;
+  register int i;
+
+  if (code == MEM)
+    return 1;
+  if (code == REG)
+    return (reg_kind[REGNO (x)] == V_LANES
+	    || reg_kind[REGNO (x)] == V_UNKNOWN);
+
+  fmt = GET_RTX_FORMAT (code);
+  for (i = GET_RTX_LENGTH (code) - 1; i >= 0; i--)
+    if (fmt[i] == 'E' || (fmt[i] == 'e' && lanes_p (XEXP (x, i))))
+      return 1;
+  return 0;
+}
+
+/* Record the memory reference MEM, whose mode sets the size of the
+   elements if it is the first.  Return zero if it cannot be made a
+   word at a time.  */
+
+static int
+record_mem (mem)
+     rtx mem;
+{
+  enum machine_mode mode = GET_MODE (mem);
+  struct linear *addr;
+  HOST_WIDE_INT stride;
+
+  if (n_mems == MAX_MEMS || MEM_VOLATILE_P (mem)
+      || GET_MODE_CLASS (mode) != MODE_INT
+      || GET_MODE_SIZE (mode) * 2 > UNITS_PER_WORD)
+    return 0;
+
+  if (lane_mode == VOIDmode)
+    {
+      lane_mode = mode;
+      lane_bits = GET_MODE_BITSIZE (mode);
+      n_lanes = UNITS_PER_WORD / GET_MODE_SIZE (mode);
+    }
+  else if (mode != lane_mode)
+    return 0;
+
+  /* The references must all go up or all go down by one element.  A
+     word of a loop that goes down starts at the last element.  */
+  addr = &mems[n_mems].addr;
+  if (! lin_init (addr, value_tree (XEXP (mem, 0))))
+    return 0;
+  stride = lin_stride (addr);
+  if (n_mems > 0 ? stride != mem_stride
+      : stride != GET_MODE_SIZE (mode) && stride != - GET_MODE_SIZE (mode))
+    return 0;
+  mem_stride = stride;
+  if (stride < 0)
+    addr->constant -= (n_lanes - 1) * GET_MODE_SIZE (mode);
+
+  mems[n_mems++].mem = mem;
+  return 1;
+}
+
+/* Return the number of insns needed to compute the lanes of X in the
+   vector loop, and add the number needed to compute one element to
+   *SCALAR; or return -1 if X cannot be computed in lanes.  */
+
+static int
+data_cost (x, scalar)
+     rtx x;
+     int *scalar;
+{
+  enum rtx_code code = GET_CODE (x);
+  enum machine_mode mode = GET_MODE (x);
+  rtx tree, data;
+  int cost, cost1;
+
+  /* A value that is the same in every lane is set up before the
+     loop.  */
+  if (lane_free_p (x))
+    {
+      tree = value_tree (x);
+      budget = MAX_NODES;
+      return tree != 0 && invariant_p (tree) ? 0 : -1;
+    }
+
+  switch (code)
+    {
+    case MEM:
+      if (! record_mem (x))
+	return -1;
+      *scalar += 1;
+      return 1;
+
+    case REG:
+      return reg_kind[REGNO (x)] == V_LANES ? 0 : -1;
+
+    case SUBREG:
+      if (! subreg_lowpart_p (x))
+	return -1;
+      cost = data_cost (SUBREG_REG (x), scalar);
+      break;
+
+    case ZERO_EXTEND:
+    case SIGN_EXTEND:
+    case TRUNCATE:
+      cost = data_cost (XEXP (x, 0), scalar);
+      break;
+
+    case NOT:
+    case NEG:
+      cost = data_cost (XEXP (x, 0), scalar);
+      if (cost >= 0)
+	cost += code == NOT ? 1 : 5;
+      *scalar += 1;
+      break;
+
+    case AND:
+    case IOR:
+    case XOR:
+    case PLUS:
+    case MINUS:
+      cost = data_cost (XEXP (x, 0), scalar);
+      cost1 = data_cost (XEXP (x, 1), scalar);
+      if (cost >= 0 && cost1 >= 0)
+	cost += cost1 + (code == PLUS || code == MINUS ? 6 : 1);
+      else
+	cost = -1;
+      *scalar += 1;
+      break;
+
+    case ASHIFT:
+      cost = data_cost (XEXP (x, 0), scalar);
+      if (GET_CODE (XEXP (x, 1)) != CONST_INT
+	  || INTVAL (XEXP (x, 1)) < 0 || INTVAL (XEXP (x, 1)) >= lane_bits)
+	return -1;
+      if (cost >= 0)
+	cost += 2;
+      *scalar += 1;
+      break;
+
+    case MULT:
+      if (lane_free_p (XEXP (x, 0)))
+	tree = value_tree (XEXP (x, 0)), data = XEXP (x, 1);
+      else if (lane_free_p (XEXP (x, 1)))
+	tree = value_tree (XEXP (x, 1)), data = XEXP (x, 0);
+      else
+	return -1;
+      budget = MAX_NODES;
+      if (tree == 0 || ! invariant_p (tree))
+	return -1;
+      cost = data_cost (data, scalar);
+      if (cost >= 0)
+	cost += 6 + 2 * MULT_INSNS;
+      *scalar += MULT_INSNS;
+      break;
+
+    default:
+      return -1;
+    }
+
+  if (cost < 0 || GET_MODE_CLASS (mode) != MODE_INT
+      || GET_MODE_SIZE (mode) < GET_MODE_SIZE (lane_mode))
+    return -1;
+  return cost;
+}
+
+/* Like data_cost, for the source X of an insn that sets a temporary;
+   but forget the memory references in X if it cannot be computed in
+   lanes.  */
+
+static int
+temp_cost (x, scalar)
+     rtx x;
+     int *scalar;
+{
+  enum machine_mode old_lane_mode = lane_mode;
+  int old_n_mems = n_mems;
+  int old_scalar = *scalar;
+  int cost;
+
+  if ((cost = data_cost (x, scalar)) < 0)
+    {
+      lane_mode = old_lane_mode;
+      n_mems = old_n_mems;
+      *scalar = old_scalar;
+    }
+  return cost;
+}
+
+/* Return the number of insns needed in the vector loop for the insn
+   that sets the sum DEST to SRC, and add the number needed for one
+   element to *SCALAR; or return -1 if it cannot be done.  The elements
+   must be zero or sign extended from the mode of the elements, unless
+   the sum is in that mode.  */
+
+static int
+sum_cost (dest, src, scalar)
+     rtx dest, src;
+     int *scalar;
+{
+  rtx x, elt;
+  int cost, shift, signedp = 0;
+
+  x = rtx_equal_p (XEXP (src, 0), dest) ? XEXP (src, 1) : XEXP (src, 0);
+  if (lane_free_p (x) || (cost = data_cost (x, scalar)) < 0)
+    return -1;
+
+  for (elt = x; GET_CODE (elt) == REG; elt = reg_src[REGNO (elt)])
+    if (reg_kind[REGNO (elt)] != V_LANES)
+      return -1;
+
+  if ((GET_CODE (elt) == ZERO_EXTEND || GET_CODE (elt) == SIGN_EXTEND)
+      && GET_MODE (XEXP (elt, 0)) == lane_mode)
+    signedp = GET_CODE (elt) == SIGN_EXTEND;
+  else if (GET_MODE (dest) != lane_mode)
+    return -1;
+
+  sums[n_sums].reg = dest;
+  sums[n_sums].signedp = signedp;
+  sums[n_sums++].acc = 0;
+
+  /* Folding the lanes into the accumulator.  */
+  cost += signedp + (2 * lane_bits == BITS_PER_WORD ? 4 : 5);
+  for (shift = 2 * lane_bits; shift < BITS_PER_WORD; shift *= 2)
+    cost += 2;
+  *scalar += 1;
+  return cost;
+}
+
+/* Find the exit test of the loop from the branch JUMP back to its top,
+   and set EXIT_VAR, EXIT_STEP, EXIT_BOUND, EXIT_CODE and EXIT_MODE.
+   Return zero if the trip count cannot be computed before the
+   loop.  */
+
+static int
+analyze_exit (jump)
+     rtx jump;
+{
+  rtx src = SET_SRC (PATTERN (jump));
+  rtx cond = XEXP (src, 0);
+  enum rtx_code code = GET_CODE (cond);
+  rtx op0, op1, tem;
+  HOST_WIDE_INT step;
+
+  if (GET_CODE (XEXP (src, 1)) != LABEL_REF)
+    code = reverse_condition (code);
+
+  op0 = value_tree (XEXP (cond, 0));
+  op1 = value_tree (XEXP (cond, 1));
+  if (op0 == 0 || op1 == 0)
+    return 0;
+
+  /* Look through the store flag insn of a target without condition
+     codes.  */
+  if ((code == NE || code == EQ) && op1 == const0_rtx
+      && GET_RTX_CLASS (GET_CODE (op0)) == '<')
+    {
+      code = code == NE ? GET_CODE (op0) : reverse_condition (GET_CODE (op0));
+      op1 = XEXP (op0, 1);
+      op0 = XEXP (op0, 0);
+    }
+
+  exit_mode = GET_MODE (op0) != VOIDmode ? GET_MODE (op0) : GET_MODE (op1);
+  if (GET_MODE_CLASS (exit_mode) != MODE_INT
+      || GET_MODE_SIZE (exit_mode) > UNITS_PER_WORD
+      || cmp_optab->handlers[(int) exit_mode].insn_code == CODE_FOR_nothing)
+    return 0;
+
+  budget = MAX_NODES;
+  if (invariant_p (op0))
+    {
+      tem = op0, op0 = op1, op1 = tem;
+      code = swap_condition (code);
+    }
+  budget = MAX_NODES;
+  if (! invariant_p (op1)
+      || ! lin_init (&exit_var, op0) || ! lin_init (&exit_bound, op1))
+    return 0;
+
+  step = exit_step = lin_stride (&exit_var);
+  if (step < 0)
+    step = - step;
+  if (exact_log2 (step) < 0)
+    return 0;
+
+  switch (code)
+    {
+    case LT:
+    case LTU:
+    case LE:
+      if (exit_step < 0)
+	return 0;
+      break;
+
+    case GT:
+    case GTU:
+    case GE:
+      if (exit_step > 0)
+	return 0;
+      break;
+
+    case NE:
+      if (step != 1)
+	return 0;
+      break;
+
+    default:
+      return 0;
+    }
+
+  exit_code = code;
+  return 1;
+}
+
+/* Check that each insn of the loop from TOP to JUMP can be done a word
+   at a time.  Store the number of insns the vector loop needs for the
+   body in *PVECTOR and the number the original loop needs in *PSCALAR.
+   Return zero if the loop cannot be vectorized.  */
+
+static int
+analyze_loop (top, jump, pvector, pscalar)
+     rtx top, jump;
+     int *pvector, *pscalar;
+{
+  rtx insn, set, dest, src, note, tree;
+  int regno, cost, vector = 0, scalar = 0;
+
+  for (insn = NEXT_INSN (top); insn != jump; insn = NEXT_INSN (insn))
+    {
+      if (GET_CODE (insn) != INSN)
+	continue;
+
+      set = insn_set (insn);
+      dest = SET_DEST (set);
+      src = SET_SRC (set);
+      if (GET_CODE (dest) == MEM)
+	{
+	  if ((cost = data_cost (src, &scalar)) < 0 || ! record_mem (dest))
+	    return 0;
+	  vector += cost + 1;
+	  scalar += 1;
+	  n_stores++;
+	  continue;
+	}
+
+      regno = REGNO (dest);
+      switch (reg_kind[regno])
+	{
+	case V_BIV:
+	  reg_reached[regno] = 1;
+	  break;
+
+	case V_SUM:
+	  if ((cost = sum_cost (dest, src, &scalar)) < 0)
+	    return 0;
+	  vector += cost;
+	  break;
+
+	default:
+	  /* A temporary that cannot be computed is left out of the
+	     vector loop, which is given up only if something needs it.
+	     An element is often sign extended by a pair of shifts, which
+	     cannot be done in lanes; the REG_EQUAL note says what they
+	     do.  */
+	  if (lanes_p (src))
+	    {
+	      note = find_reg_note (insn, REG_EQUAL, NULL_RTX);
+	      if ((cost = temp_cost (src, &scalar)) < 0 && note != 0
+		  && lanes_p (XEXP (note, 0)))
+		{
+		  src = XEXP (note, 0);
+		  cost = temp_cost (src, &scalar);
+		}
+	      if (cost >= 0)
+		{
+		  reg_kind[regno] = V_LANES;
+		  reg_src[regno] = src;
+		  vector += cost;
+		}
+	      else
+		reg_kind[regno] = V_UNKNOWN;
+	    }
+	  else if ((tree = value_tree (src)) != 0)
+	    {
+	      reg_tree[regno] = tree;
+	      budget = MAX_NODES;
+	      reg_kind[regno] = invariant_p (tree) ? V_CONSTANT : V_SCALAR;
+	    }
+	  else
+	    reg_kind[regno] = V_UNKNOWN;
+	  break;
+	}
+    }
+
+  if (lane_mode == VOIDmode || n_stores + n_sums == 0
+      || ! analyze_exit (jump))
+    return 0;
+
+  *pvector = vector;
+  *pscalar = scalar;
+  return 1;
+}
+
+/* Return a word holding COUNT copies of the low WIDTH bits of VALUE,
+   the first in the low bits and each WIDTH bits above the last.  */
+
+static rtx
+lane_constant (value, width, count)
+     HOST_WIDE_INT value;
+     int width, count;
+{
+  HOST_WIDE_INT low = 0, high = 0;
+  int i, pos;
+
+  if (width < HOST_BITS_PER_WIDE_INT)
+    value &= ((HOST_WIDE_INT) 1 << width) - 1;
+
+  for (i = 0, pos = 0; i < count; i++, pos += width)
+    if (pos < HOST_BITS_PER_WIDE_INT)
+      low |= value << pos;
+    else
+      high |= value << (pos - HOST_BITS_PER_WIDE_INT);
+
+  return immed_double_const (low, high, word_mode);
+}
+
+/* Return the register that holds VALUE, as a word of kind KIND, in the
+   vector loop.  */
+
+static rtx
+invariant_reg (value, kind)
+     rtx value;
+     enum inv_kind kind;
+{
+  int i;
+
+  for (i = 0; i < n_invariants; i++)
+    if (invariants[i].kind == kind && rtx_equal_p (invariants[i].value, value))
+      return invariants[i].reg;
+
+  if (n_invariants == max_invariants)
+    {
+      max_invariants *= 2;
+      invariants = (struct vect_inv *)
+	xrealloc ((char *) invariants,
+		  max_invariants * sizeof (struct vect_inv));
+    }
+
+  invariants[n_invariants].kind = kind;
+  invariants[n_invariants].value = value;
+  invariants[n_invariants].reg = gen_reg_rtx (word_mode);
+  return invariants[n_invariants++].reg;
+}
+
+/* Emit insns to apply BINOPTAB to the words X and Y.  */
+
+static rtx
+word_op (binoptab, x, y)
+     optab binoptab;
+     rtx x, y;
+{
+  return expand_binop (word_mode, binoptab, x, y, NULL_RTX, 1,
+		       OPTAB_LIB_WIDEN);
+}
+
+/* Emit insns to compute the value X returned by value_tree, which
+   invariant_p accepts or is an induction variable, and return where it
+   is.  */
+
+static rtx
+expand_tree (x)
+     rtx x;
+{
+  enum machine_mode mode = GET_MODE (x);
+  enum machine_mode inner_mode;
+  rtx op0, op1;
+  optab binoptab;
+
+  switch (GET_CODE (x))
+    {
+    case REG:
+    case CONST_INT:
+    case CONST_DOUBLE:
+    case SYMBOL_REF:
+    case LABEL_REF:
+      return x;
+
+    case CONST:
+      return copy_rtx (x);
+
+    case SUBREG:
+      inner_mode = GET_MODE (SUBREG_REG (x));
+      return gen_lowpart (mode,
+			  force_reg (inner_mode,
+				     expand_tree (SUBREG_REG (x))));
+
+    case ZERO_EXTEND:
+    case SIGN_EXTEND:
+    case TRUNCATE:
+      return convert_modes (mode, GET_MODE (XEXP (x, 0)),
+			    expand_tree (XEXP (x, 0)),
+			    GET_CODE (x) == ZERO_EXTEND);
+
+    case NEG:
+      return expand_unop (mode, neg_optab, expand_tree (XEXP (x, 0)),
+			  NULL_RTX, 0);
+
+    case NOT:
+      return expand_unop (mode, one_cmpl_optab, expand_tree (XEXP (x, 0)),
+			  NULL_RTX, 0);
+
+    case MULT:
+      op0 = expand_tree (XEXP (x, 0));
+      op1 = expand_tree (XEXP (x, 1));
+      return expand_mult (mode, force_reg (mode, op0), op1, NULL_RTX, 0);
+
+    case PLUS:
+      binoptab = add_optab;
+      break;
+    case MINUS:
+      binoptab = sub_optab;
+      break;
+    case AND:
+      binoptab = and_optab;
+      break;
+    case IOR:
+      binoptab = ior_optab;
+      break;
+    case XOR:
+      binoptab = xor_optab;
+      break;
+    case ASHIFT:
+      binoptab = ashl_optab;
+      break;
+    case LSHIFTRT:
+      binoptab = lshr_optab;
+      break;
+    case ASHIFTRT:
+      binoptab = ashr_optab;
+      break;
+
+    default:
+      abort ();
+    }
+
+  op0 = expand_tree (XEXP (x, 0));
+  op1 = expand_tree (XEXP (x, 1));
+  return expand_binop (mode, binoptab, op0, op1, NULL_RTX, 0,
+		       OPTAB_LIB_WIDEN);
+}
+
+/* Emit insns to compute the linear function LIN in MODE from the
+   current values of the induction variables, and return where it
+   is.  */
+
+static rtx
+expand_lin (lin, mode)
+     struct linear *lin;
+     enum machine_mode mode;
+{
+  rtx sum = 0, term;
+  int i;
+
+  for (i = 0; i < lin->n_terms; i++)
+    {
+      if (lin->coefs[i] == 0)
+	continue;
+      term = expand_tree (lin->terms[i]);
+      if (lin->coefs[i] != 1)
+	term = expand_mult (mode, force_reg (mode, term),
+			    GEN_INT (lin->coefs[i]), NULL_RTX, 0);
+      sum = (sum == 0 ? term
+	     : expand_binop (mode, add_optab, sum, term, NULL_RTX, 0,
+			     OPTAB_LIB_WIDEN));
+    }
+
+  if (sum == 0)
+    return GEN_INT (lin->constant);
+  if (lin->constant != 0)
+    sum = expand_binop (mode, add_optab, sum, GEN_INT (lin->constant),
+			NULL_RTX, 0, OPTAB_LIB_WIDEN);
+  return sum;
+}
+
+/* Emit a branch to LABEL if OP0 compares with OP1 in MODE by CODE.  */
+
+static void
+emit_jump_if (code, op0, op1, mode, label)
+     enum rtx_code code;
+     rtx op0, op1;
+     enum machine_mode mode;
+     rtx label;
+{
+  rtx insn;
+
+  emit_cmp_insn (force_reg (mode, op0), op1, code, NULL_RTX, mode,
+		 code == LTU || code == LEU || code == GTU || code == GEU, 0);
+  insn = emit_jump_insn ((*bcc_gen_fctn[(int) code]) (label));
+  JUMP_LABEL (insn) = label;
+  LABEL_NUSES (label)++;
+}
+
+/* Emit the insns that set up the word INV before the vector loop.  */
+
+static void
+emit_invariant (inv)
+     struct vect_inv *inv;
+{
+  rtx word;
+  int shift;
+
+  if (inv->kind == INV_CONST)
+    {
+      emit_move_insn (inv->reg, inv->value);
+      return;
+    }
+
+  word = convert_modes (word_mode, GET_MODE (inv->value),
+			expand_tree (inv->value), 1);
+  word = word_op (and_optab, word, lane_constant (LANE_MASK, lane_bits, 1));
+  if (inv->kind == INV_SPLAT)
+    for (shift = lane_bits; shift < BITS_PER_WORD; shift *= 2)
+      word = word_op (ior_optab, word,
+		      word_op (ashl_optab, word, GEN_INT (shift)));
+  emit_move_insn (inv->reg, word);
+}
+
+/* Emit insns to add the lanes of X and Y.  The top bit of each lane is
+   left out of the addition, so that the carry out of a lane does not
+   reach the next, and then put back with an exclusive or.  */
+
+static rtx
+lanes_add (x, y)
+     rtx x, y;
+{
+  rtx high = invariant_reg (lane_constant (LANE_HIGH, lane_bits, n_lanes),
+			    INV_CONST);
+  rtx low = invariant_reg (lane_constant (LANE_HIGH - 1, lane_bits,
+					  n_lanes),
+			   INV_CONST);
+  rtx sum;
+
+  sum = word_op (add_optab, word_op (and_optab, x, low),
+		 word_op (and_optab, y, low));
+  return word_op (xor_optab, sum,
+		  word_op (and_optab, word_op (xor_optab, x, y), high));
+}
+
+/* Emit insns to subtract the lanes of Y from those of X, or to negate
+   them if X is zero.  The top bit of each lane of X is set, so that the
+   borrow into a lane does not come from the next, and then the top
+   bits are corrected with an exclusive or.  */
+
+static rtx
+lanes_sub (x, y)
+     rtx x, y;
+{
+  rtx high = invariant_reg (lane_constant (LANE_HIGH, lane_bits, n_lanes),
+			    INV_CONST);
+  rtx low = invariant_reg (lane_constant (LANE_HIGH - 1, lane_bits,
+					  n_lanes),
+			   INV_CONST);
+  rtx diff, sign;
+
+  diff = word_op (sub_optab, x ? word_op (ior_optab, x, high) : high,
+		  word_op (and_optab, y, low));
+  sign = x ? word_op (xor_optab, x, y) : y;
+  return word_op (xor_optab, diff,
+		  word_op (xor_optab, word_op (and_optab, sign, high), high));
+}
+
+/* Emit insns to shift the lanes of X left by COUNT bits.  */
+
+static rtx
+lanes_shift (x, count)
+     rtx x;
+     int count;
+{
+  rtx mask = invariant_reg (lane_constant ((LANE_MASK << count) & LANE_MASK,
+					   lane_bits, n_lanes),
+			    INV_CONST);
+
+  return word_op (and_optab, word_op (ashl_optab, x, GEN_INT (count)), mask);
+}
+
+/* Emit insns to multiply the lanes of X by K, a word holding a number
+   in its low lane.  The even and the odd lanes are multiplied
+   separately, each in a field twice as wide as a lane, so that the
+   products do not overlap.  */
+
+static rtx
+lanes_mult (x, k)
+     rtx x, k;
+{
+  rtx even = invariant_reg (lane_constant (LANE_MASK, 2 * lane_bits,
+					   n_lanes / 2),
+			    INV_CONST);
+  rtx lo, hi;
+
+  lo = word_op (and_optab, x, even);
+  hi = word_op (and_optab, word_op (lshr_optab, x, GEN_INT (lane_bits)),
+		even);
+  lo = expand_mult (word_mode, lo, k, NULL_RTX, 1);
+  hi = expand_mult (word_mode, hi, k, NULL_RTX, 1);
+  return word_op (ior_optab, word_op (and_optab, lo, even),
+		  word_op (ashl_optab, word_op (and_optab, hi, even),
+			   GEN_INT (lane_bits)));
+}
+
+/* Emit insns to add up the lanes of X, and return a word holding the
+   sum.  Pairs of lanes are added in fields twice as wide as a lane, and
+   then the fields are added into the low one.  */
+
+static rtx
+fold_lanes (x)
+     rtx x;
+{
+  rtx even = invariant_reg (lane_constant (LANE_MASK, 2 * lane_bits,
+					   n_lanes / 2),
+			    INV_CONST);
+  rtx odd, sum;
+  int shift;
+
+  odd = word_op (lshr_optab, x, GEN_INT (lane_bits));
+  if (2 * lane_bits < BITS_PER_WORD)
+    odd = word_op (and_optab, odd, even);
+  sum = word_op (add_optab, word_op (and_optab, x, even), odd);
+
+  for (shift = 2 * lane_bits; shift < BITS_PER_WORD; shift *= 2)
+    sum = word_op (add_optab, sum,
+		   word_op (lshr_optab, sum, GEN_INT (shift)));
+
+  if (2 * lane_bits < BITS_PER_WORD)
+    sum = word_op (and_optab, sum,
+		   lane_constant ((HOST_WIDE_INT) -1, 2 * lane_bits, 1));
+  return sum;
+}
+
+/* Return the word reference that the vector loop makes in place of the
+   element reference MEM, the next one recorded.  */
+
+static rtx
+word_mem (mem)
+     rtx mem;
+{
+  rtx addr;
+
+  if (next_mem == n_mems || mems[next_mem].mem != mem)
+    abort ();
+
+  addr = expand_lin (&mems[next_mem++].addr, Pmode);
+  return change_address (mem, word_mode, force_reg (Pmode, addr));
+}
+
+/* Emit insns to compute the lanes of X, which data_cost accepted, and
+   return the register holding them.  */
+
+static rtx
+emit_data (x)
+     rtx x;
+{
+  rtx tree, op0, op1, reg;
+
+  if (lane_free_p (x))
+    {
+      tree = value_tree (x);
+      if (GET_CODE (tree) == CONST_INT)
+	return invariant_reg (lane_constant (INTVAL (tree), lane_bits,
+					     n_lanes),
+			      INV_CONST);
+      return invariant_reg (tree, INV_SPLAT);
+    }
+
+  switch (GET_CODE (x))
+    {
+    case MEM:
+      reg = gen_reg_rtx (word_mode);
+      emit_move_insn (reg, word_mem (x));
+      return reg;
+
+    case REG:
+      return reg_vector[REGNO (x)];
+
+    case SUBREG:
+    case ZERO_EXTEND:
+    case SIGN_EXTEND:
+    case TRUNCATE:
+      return emit_data (XEXP (x, 0));
+
+    case NOT:
+      return expand_unop (word_mode, one_cmpl_optab,
+			  emit_data (XEXP (x, 0)), NULL_RTX, 1);
+
+    case NEG:
+      return lanes_sub (NULL_RTX, emit_data (XEXP (x, 0)));
+
+    case ASHIFT:
+      return lanes_shift (emit_data (XEXP (x, 0)), INTVAL (XEXP (x, 1)));
+
+    case MULT:
+      if (lane_free_p (XEXP (x, 0)))
+	tree = value_tree (XEXP (x, 0)), op0 = emit_data (XEXP (x, 1));
+      else
+	tree = value_tree (XEXP (x, 1)), op0 = emit_data (XEXP (x, 0));
+      if (GET_CODE (tree) == CONST_INT)
+	op1 = lane_constant (INTVAL (tree), lane_bits, 1);
+      else
+	op1 = invariant_reg (tree, INV_LANE);
+      return lanes_mult (op0, op1);
+
+    default:
+      break;
+    }
+
+  op0 = emit_data (XEXP (x, 0));
+  op1 = emit_data (XEXP (x, 1));
+  switch (GET_CODE (x))
+    {
+    case AND:
+      return word_op (and_optab, op0, op1);
+    case IOR:
+      return word_op (ior_optab, op0, op1);
+    case XOR:
+      return word_op (xor_optab, op0, op1);
+    case PLUS:
+      return lanes_add (op0, op1);
+    case MINUS:
+      return lanes_sub (op0, op1);
+    default:
+      abort ();
+    }
+}
+
+/* Emit insns to add the lanes of the element in SRC, the source of the
+   insn that sets the sum DEST, to the accumulator of the sum.  */
+
+static void
+emit_sum (dest, src)
+     rtx dest, src;
+{
+  rtx x, lanes, acc, tem;
+  int i;
+
+  for (i = 0; sums[i].reg != dest; i++)
+    ;
+
+  x = rtx_equal_p (XEXP (src, 0), dest) ? XEXP (src, 1) : XEXP (src, 0);
+  lanes = emit_data (x);
+
+  /* Biasing signed elements by the top bit of a lane makes them
+     unsigned; the bias is taken out of the accumulator before the
+     loop.  */
+  if (sums[i].signedp)
+    lanes = word_op (xor_optab, lanes,
+		     invariant_reg (lane_constant (LANE_HIGH, lane_bits,
+						   n_lanes),
+				    INV_CONST));
+
+  acc = sums[i].acc = gen_reg_rtx (word_mode);
+  tem = expand_binop (word_mode, add_optab, acc, fold_lanes (lanes), acc, 1,
+		      OPTAB_LIB_WIDEN);
+  if (tem != acc)
+    emit_move_insn (acc, tem);
+}
+
+/* Emit the body of the vector loop for the loop from TOP to JUMP.  */
+
+static void
+emit_body (top, jump)
+     rtx top, jump;
+{
+  rtx insn, set, dest, src, lanes;
+
+  next_mem = 0;
+  for (insn = NEXT_INSN (top); insn != jump; insn = NEXT_INSN (insn))
+    {
+      if (GET_CODE (insn) != INSN)
+	continue;
+
+      set = insn_set (insn);
+      dest = SET_DEST (set);
+      src = SET_SRC (set);
+      if (GET_CODE (dest) == MEM)
+	{
+	  lanes = emit_data (src);
+	  emit_move_insn (word_mem (dest), lanes);
+	}
+      else if (reg_kind[REGNO (dest)] == V_LANES)
+	reg_vector[REGNO (dest)] = emit_data (reg_src[REGNO (dest)]);
+      else if (reg_kind[REGNO (dest)] == V_SUM)
+	emit_sum (dest, src);
+    }
+}
+
+/* Emit the vector loop for the loop from TOP to JUMP between the
+   NOTE_INSN_LOOP_BEG note LOOP_BEG and the NOTE_INSN_LOOP_END note
+   LOOP_END, with the code that decides whether to run it, before the
+   original loop.  */
+
+static void
+vectorize_loop (loop_beg, top, jump, loop_end)
+     rtx loop_beg, top, jump, loop_end;
+{
+  enum machine_mode mode = exit_mode;
+  rtx vtop = gen_label_rtx ();
+  rtx scalar = gen_label_rtx ();
+  rtx done = gen_label_rtx ();
+  rtx count = gen_reg_rtx (mode);
+  rtx k = gen_reg_rtx (mode);
+  rtx var, bound, tem, addrs, reg, body, setup;
+  int log_lanes = exact_log2 (n_lanes);
+  int shift = exact_log2 (exit_step < 0 ? - exit_step : exit_step);
+  int i, j;
+
+  n_invariants = 0;
+
+  /* The vector loop runs K times, and then the original loop runs
+     COUNT mod N_LANES times.  */
+  start_sequence ();
+  emit_note (NULL_PTR, NOTE_INSN_LOOP_BEG);
+  emit_label (vtop);
+  emit_body (top, jump);
+  emit_note (NULL_PTR, NOTE_INSN_LOOP_CONT);
+  for (i = 0; i < n_bivs; i++)
+    {
+      reg = bivs[i];
+      tem = expand_binop (GET_MODE (reg), add_optab, reg,
+			  GEN_INT (n_lanes * reg_step[REGNO (reg)]), reg, 0,
+			  OPTAB_LIB_WIDEN);
+      if (tem != reg)
+	emit_move_insn (reg, tem);
+    }
+  tem = expand_binop (mode, sub_optab, k, const1_rtx, k, 0, OPTAB_LIB_WIDEN);
+  if (tem != k)
+    emit_move_insn (k, tem);
+  emit_jump_if (NE, k, const0_rtx, mode, vtop);
+  emit_note (NULL_PTR, NOTE_INSN_LOOP_END);
+
+  for (i = 0; i < n_sums; i++)
+    {
+      reg = sums[i].reg;
+      tem = convert_modes (GET_MODE (reg), word_mode, sums[i].acc, 1);
+      tem = expand_binop (GET_MODE (reg), add_optab, reg, tem, reg, 0,
+			  OPTAB_LIB_WIDEN);
+      if (tem != reg)
+	emit_move_insn (reg, tem);
+    }
+  emit_jump_if (EQ, expand_binop (mode, and_optab, count,
+				  GEN_INT (n_lanes - 1), NULL_RTX, 1,
+				  OPTAB_LIB_WIDEN),
+		const0_rtx, mode, done);
+  emit_label (scalar);
+  body = get_insns ();
+  end_sequence ();
+
+  /* Compute the trip count.  The original loop always runs once; it
+     goes on while EXIT_VAR, whose value at the end of the first
+     iteration is VAR, compares with BOUND by EXIT_CODE.  */
+  start_sequence ();
+  var = force_reg (mode, expand_lin (&exit_var, mode));
+  bound = force_reg (mode, expand_lin (&exit_bound, mode));
+  if (exit_code != NE)
+    emit_jump_if (reverse_condition (exit_code), var, bound, mode, scalar);
+  if (exit_step > 0)
+    tem = expand_binop (mode, sub_optab, bound, var, NULL_RTX, 1,
+			OPTAB_LIB_WIDEN);
+  else
+    tem = expand_binop (mode, sub_optab, var, bound, NULL_RTX, 1,
+			OPTAB_LIB_WIDEN);
+  if (exit_code == NE)
+    tem = expand_binop (mode, add_optab, tem, const1_rtx, NULL_RTX, 1,
+			OPTAB_LIB_WIDEN);
+  else
+    {
+      if (exit_code != LE && exit_code != GE)
+	tem = expand_binop (mode, sub_optab, tem, const1_rtx, NULL_RTX, 1,
+			    OPTAB_LIB_WIDEN);
+      if (shift > 0)
+	tem = expand_binop (mode, lshr_optab, tem, GEN_INT (shift), NULL_RTX,
+			    1, OPTAB_LIB_WIDEN);
+      tem = expand_binop (mode, add_optab, tem, GEN_INT (2), NULL_RTX, 1,
+			  OPTAB_LIB_WIDEN);
+    }
+  emit_move_insn (count, tem);
+  emit_move_insn (k, expand_binop (mode, lshr_optab, count,
+				   GEN_INT (log_lanes), NULL_RTX, 1,
+				   OPTAB_LIB_WIDEN));
+  emit_jump_if (EQ, k, const0_rtx, mode, scalar);
+
+  /* Check that every address is word aligned.  */
+  addrs = 0;
+  for (i = 0; i < n_mems; i++)
+    {
+      for (j = 0; j < i; j++)
+	if (lin_equal (&mems[i].addr, &mems[j].addr))
+	  break;
+      if (j < i)
+	continue;
+      tem = expand_lin (&mems[i].addr, Pmode);
+      addrs = (addrs == 0 ? tem
+	       : expand_binop (Pmode, ior_optab, addrs, tem, NULL_RTX, 1,
+			       OPTAB_LIB_WIDEN));
+    }
+  addrs = expand_binop (Pmode, and_optab, addrs, GEN_INT (UNITS_PER_WORD - 1),
+			NULL_RTX, 1, OPTAB_LIB_WIDEN);
+  emit_jump_if (NE, addrs, const0_rtx, Pmode, scalar);
+
+  for (i = 0; i < n_invariants; i++)
+    emit_invariant (&invariants[i]);
+
+  /* The accumulators of signed sums start with minus the bias that
+     will be added to them.  */
+  for (i = 0; i < n_sums; i++)
+    {
+      if (! sums[i].signedp)
+	{
+	  emit_move_insn (sums[i].acc, const0_rtx);
+	  continue;
+	}
+      tem = convert_modes (word_mode, mode, k, 1);
+      tem = expand_binop (word_mode, ashl_optab, tem,
+			  GEN_INT (log_lanes + lane_bits - 1), NULL_RTX, 1,
+			  OPTAB_LIB_WIDEN);
+      emit_move_insn (sums[i].acc,
+		      expand_unop (word_mode, neg_optab, tem, NULL_RTX, 0));
+    }
+  setup = get_insns ();
+  end_sequence ();
+
+  emit_insns_before (setup, loop_beg);
+  emit_insns_before (body, loop_beg);
+  emit_label_after (done, loop_end);
+}
+
+/* Vectorize the loop starting with the NOTE_INSN_LOOP_BEG note LOOP_BEG
+   in function F, if it can be done and is worth doing.  */
+
+static void
+try_loop (f, loop_beg)
+     rtx f, loop_beg;
+{
+  rtx top, jump, loop_end, insn, set, src, dest;
+  int i, regno, vector, scalar;
+
+  if (! loop_ok (loop_beg, &top, &jump, &loop_end))
+    return;
+
+  n_touched = n_mems = n_stores = n_bivs = n_sums = 0;
+  lane_mode = VOIDmode;
+
+  if (! classify_regs (top, jump))
+    {
+      if (vect_dump)
+	fprintf (vect_dump, "Loop at insn %d: cannot be vectorized.\n",
+		 INSN_UID (loop_beg));
+      goto done;
+    }
+
+  /* Sort out the registers set in the loop.  */
+  for (insn = NEXT_INSN (top); insn != jump; insn = NEXT_INSN (insn))
+    {
+      if (GET_CODE (insn) != INSN)
+	continue;
+      set = insn_set (insn);
+      dest = SET_DEST (set);
+      src = SET_SRC (set);
+      if (GET_CODE (dest) != REG)
+	continue;
+
+      regno = REGNO (dest);
+      if (reg_sets[regno] > 1)
+	{
+	  if (vect_dump)
+	    fprintf (vect_dump,
+		     "Loop at insn %d: register %d set more than once.\n",
+		     INSN_UID (loop_beg), regno);
+	  goto done;
+	}
+
+      if (GET_CODE (src) == PLUS && rtx_equal_p (XEXP (src, 0), dest)
+	  && GET_CODE (XEXP (src, 1)) == CONST_INT)
+	{
+	  reg_kind[regno] = V_BIV;
+	  reg_step[regno] = INTVAL (XEXP (src, 1));
+	  bivs[n_bivs++] = dest;
+	}
+      else if (GET_CODE (src) == PLUS && reg_refs[regno] == 1
+	       && (rtx_equal_p (XEXP (src, 0), dest)
+		   || rtx_equal_p (XEXP (src, 1), dest))
+	       && GET_MODE_CLASS (GET_MODE (dest)) == MODE_INT
+	       && GET_MODE_SIZE (GET_MODE (dest)) <= UNITS_PER_WORD)
+	reg_kind[regno] = V_SUM;
+      else
+	reg_kind[regno] = V_TEMP;
+    }
+
+  if (outside_refs_p (f, top, jump))
+    {
+      if (vect_dump)
+	fprintf (vect_dump,
+		 "Loop at insn %d: temporary used outside the loop.\n",
+		 INSN_UID (loop_beg));
+      goto done;
+    }
+
+  if (! analyze_loop (top, jump, &vector, &scalar))
+    {
+      if (vect_dump)
+	fprintf (vect_dump, "Loop at insn %d: cannot be vectorized.\n",
+		 INSN_UID (loop_beg));
+      goto done;
+    }
+
+  /* Compare the insns for N_LANES iterations of the original loop,
+     counting the increments and the branch, with those for one of the
+     vector loop, which also counts down K.  */
+  vector += n_bivs + 2;
+  scalar = n_lanes * (scalar + n_bivs + 1);
+
+  if (vect_dump)
+    fprintf (vect_dump,
+	     "Loop at insn %d: %d lanes, %d insns per word against %d, %s.\n",
+	     INSN_UID (loop_beg), n_lanes, vector, scalar,
+	     vector < scalar ? "vectorized" : "not vectorized");
+
+  if (vector < scalar)
+    vectorize_loop (loop_beg, top, jump, loop_end);
+
+ done:
+  /* Reset the register information for the next loop.  */
+  for (i = 0; i < n_touched; i++)
+    {
+      regno = touched[i];
+      reg_sets[regno] = reg_refs[regno] = 0;
+      reg_kind[regno] = V_INVARIANT;
+      reg_reached[regno] = 0;
+      reg_tree[regno] = reg_src[regno] = reg_vector[regno] = 0;
+    }
+}
+
+/* Vectorize the innermost loops of the function whose insns start with
+   F.  Write a report to FILE if it is nonzero.  */
+
+void
+vectorize_loops (f, file)
+     rtx f;
+     FILE *file;
+{
+  rtx insn, next;
+
+  /* The constants built for the lanes must fit in a CONST_DOUBLE.  */
+  if (BITS_PER_WORD > 2 * HOST_BITS_PER_WIDE_INT)
+    return;
+
+  vect_dump = file;
+  vect_max_reg = max_reg_num ();
+  reg_sets = (int *) xcalloc (vect_max_reg, sizeof (int));
+  reg_refs = (int *) xcalloc (vect_max_reg, sizeof (int));
+  reg_kind = (char *) xcalloc (vect_max_reg, sizeof (char));
+  reg_reached = (char *) xcalloc (vect_max_reg, sizeof (char));
+  reg_step = (HOST_WIDE_INT *) xcalloc (vect_max_reg,
+					sizeof (HOST_WIDE_INT));
+  reg_tree = (rtx *) xcalloc (vect_max_reg, sizeof (rtx));
+  reg_src = (rtx *) xcalloc (vect_max_reg, sizeof (rtx));
+  reg_vector = (rtx *) xcalloc (vect_max_reg, sizeof (rtx));
+  touched = (int *) xmalloc (vect_max_reg * sizeof (int));
+  max_invariants = 16;
+  invariants = (struct vect_inv *) xmalloc (max_invariants
+					    * sizeof (struct vect_inv));
+
+  for (insn = f; insn; insn = next)
+    {
+      next = NEXT_INSN (insn);
+      if (GET_CODE (insn) == NOTE
+	  && NOTE_LINE_NUMBER (insn) == NOTE_INSN_LOOP_BEG)
+	try_loop (f, insn);
+    }
+
+  free (reg_sets);
+  free (reg_refs);
+  free (reg_kind);
+  free (reg_reached);
+  free (reg_step);
+  free (reg_tree);
+  free (reg_src);
+  free (reg_vector);
+  free (touched);
+  free (invariants);
+}
@@ -31,6 +31,38 @@ Written by Per Bothner (bothner@cygnus.com). */
 #include <errno.h>
 #include "builtinbuf.h"
 
+#if !defined(filebuf_vtable) && defined(__cplusplus)
+#ifdef __GNUC__
+extern char filebuf_vtable[]
+  asm (_G_VTABLE_LABEL_PREFIX
+#if _G_VTABLE_LABEL_HAS_LENGTH
+       "7"
+#endif
+       "filebuf");
+#else /* !__GNUC__ */
+#if _G_VTABLE_LABEL_HAS_LENGTH
+#define filebuf_vtable _G_VTABLE_LABEL_PREFIX_ID##7filebuf
+#else
+#define filebuf_vtable _G_VTABLE_LABEL_PREFIX_ID##filebuf
+#endif
+extern char filebuf_vtable[];
+#endif /* !__GNUC__ */
+#endif /* !defined(filebuf_vtable) && defined(__cplusplus) */
+
+// Mark FB as a plain file (see fileops.c) if it is a filebuf proper,
+// and not of a derived class that may have its own sys_read or sys_write.
+// Constructors cannot do this, since a derived class's vtable is not
+// in place yet while they run.
+
+static filebuf *
+mark_plain_file (filebuf *fb)
+{
+  if (fb != NULL
+      && _IO_JUMPS (fb) == (const struct _IO_jump_t *) filebuf_vtable)
+    fb->_IO_file_flags |= _IO_PLAIN_FILE;
+  return fb;
+}
+
 void filebuf::init()
 {
   _IO_file_init(this);
@@ -112,8 +144,9 @@ filebuf* filebuf::open(const char *filename, ios::openmode mode, int prot)
   if (mode & (int)ios::noreplace)
     posix_mode |= O_EXCL;
 #if _G_HAVE_IO_FILE_OPEN
-  return (filebuf*)_IO_file_open (this, filename, posix_mode, prot,
-				  read_write, 0);
+  return mark_plain_file ((filebuf*)_IO_file_open (this, filename,
+						   posix_mode, prot,
+						   read_write, 0));
 #else
   int fd = ::open(filename, posix_mode, prot);
   if (fd < 0)
@@ -125,22 +158,22 @@ filebuf* filebuf::open(const char *filename, ios::openmode mode, int prot)
       return NULL;
   }
   _IO_link_in(this);
-  return this;
+  return mark_plain_file (this);
 #endif
 }
 
 filebuf* filebuf::open(const char *filename, const char *mode)
 {
 #if _G_IO_IO_FILE_VERSION == 0x20001
-  return (filebuf*)_IO_file_fopen(this, filename, mode, 0);
+  return mark_plain_file ((filebuf*)_IO_file_fopen(this, filename, mode, 0));
 #else
-  return (filebuf*)_IO_file_fopen(this, filename, mode);
+  return mark_plain_file ((filebuf*)_IO_file_fopen(this, filename, mode));
 #endif
 }
 
 filebuf* filebuf::attach(int fd)
 {
-  return (filebuf*)_IO_file_attach(this, fd);
+  return mark_plain_file ((filebuf*)_IO_file_attach(this, fd));
 }
 
 streambuf* filebuf::setbuf(char* p, int len)
@@ -207,8 +240,12 @@ streamsize filebuf::xsputn(const char *s, streamsize n)
 
 streamsize filebuf::xsgetn(char *s, streamsize n)
 {
-    // FIXME: OPTIMIZE THIS (specifically, when unbuffered()).
-    return streambuf::xsgetn(s, n);
+#if _IO_PLAIN_FILE
+  return _IO_file_xsgetn(this, s, n);
+#else
+  // The C library's libio may not have _IO_file_xsgetn.
+  return streambuf::xsgetn(s, n);
+#endif
 }
 
 // Non-ANSI AT&T-ism:  Default open protection.
@@ -33,11 +33,15 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 #ifndef errno
 extern int errno;
 #endif
+#if _IO_HAVE_WRITEV
+# include <sys/uio.h>
+#endif
 
 
 #ifdef _LIBC
@@ -47,6 +51,13 @@ extern int errno;
 # define lseek(FD, Offset, Whence) __lseek (FD, Offset, Whence)
 # define read(FD, Buf, NBytes) __read (FD, Buf, NBytes)
 # define write(FD, Buf, NBytes) __write (FD, Buf, NBytes)
+# define readv(FD, Iov, Count) __readv (FD, Iov, Count)
+# define writev(FD, Iov, Count) __writev (FD, Iov, Count)
+#endif
+
+/* A file buffer that keeps filling up is doubled, up to this size. */
+#ifndef _IO_BUFSIZ_MAX
+# define _IO_BUFSIZ_MAX 65536
 #endif
 
 /* An fstream can be in at most one of put mode, get mode, or putback mode.
@@ -97,6 +108,14 @@ extern int errno;
 
    UNBUFFERED STREAMS:
    If a filebuf is unbuffered(), the _shortbuf[1] is used as the buffer.
+
+   PLAIN FILES:
+   If _IO_PLAIN_FILE is set, the read and write jumps are those of
+   _IO_file_jumps, so _IO_file_xsputn and _IO_file_xsgetn may go to
+   _fileno themselves, moving the buffer and the caller's data with a
+   single writev or readv.  Such a file's buffer is also doubled, up to
+   _IO_BUFSIZ_MAX, each time it is found completely full or completely
+   used up, so that a file read or written in bulk makes fewer calls.
 */
 
 #define CLOSED_FILEBUF_FLAGS \
@@ -203,6 +222,8 @@ _IO_file_fopen (fp, filename, mode)
     if (_IO_SEEKOFF (fp, (_IO_off_t)0, _IO_seek_end, _IOS_INPUT|_IOS_OUTPUT)
 	== _IO_pos_BAD && errno != ESPIPE)
       return NULL;
+  if (_IO_JUMPS (fp) == &_IO_file_jumps)
+    fp->_flags |= _IO_PLAIN_FILE;
   _IO_link_in (fp);
   return fp;
 }
@@ -223,6 +244,8 @@ _IO_file_attach (fp, fd)
   if (_IO_SEEKOFF (fp, (_IO_off_t)0, _IO_seek_cur, _IOS_INPUT|_IOS_OUTPUT)
       == _IO_pos_BAD && errno != ESPIPE)
     return NULL;
+  if (_IO_JUMPS (fp) == &_IO_file_jumps)
+    fp->_flags |= _IO_PLAIN_FILE;
   return fp;
 }
 
@@ -279,6 +302,115 @@ _IO_do_write (fp, data, to_do)
   return count != to_do ? EOF : 0;
 }
 
+#if _IO_HAVE_WRITEV
+/* Write the characters buffered in FP followed by TO_DO bytes from DATA,
+   using writev so that both normally go out in one system call.
+   Then mark FP as having empty buffers, as _IO_do_write does.
+   Return the number of bytes from DATA that were written. */
+
+static _IO_size_t _IO_file_writev __P ((_IO_FILE *, const char *,
+					_IO_size_t));
+
+static _IO_size_t
+_IO_file_writev (fp, data, to_do)
+     _IO_FILE *fp;
+     const char *data;
+     _IO_size_t to_do;
+{
+  const char *base = fp->_IO_write_base;
+  _IO_size_t pending = fp->_IO_write_ptr - fp->_IO_write_base;
+  _IO_size_t done = 0;
+  struct iovec iov[2];
+
+  if (fp->_flags & _IO_IS_APPENDING)
+    fp->_offset = _IO_pos_BAD;
+  else if (fp->_IO_read_end != fp->_IO_write_base)
+    {
+      _IO_pos_t new_pos
+	= _IO_SYSSEEK (fp, fp->_IO_write_base - fp->_IO_read_end, 1);
+      if (new_pos == _IO_pos_BAD)
+	return 0;
+      fp->_offset = new_pos;
+    }
+  if (fp->_cur_column)
+    {
+      fp->_cur_column = _IO_adjust_column (fp->_cur_column - 1, base,
+					   pending) + 1;
+      fp->_cur_column = _IO_adjust_column (fp->_cur_column - 1, data,
+					   to_do) + 1;
+    }
+  while (pending + to_do > 0)
+    {
+      _IO_ssize_t count;
+      int n_iov = 0;
+      if (pending > 0)
+	{
+	  iov[n_iov].iov_base = (char *) base;
+	  iov[n_iov++].iov_len = pending;
+	}
+      if (to_do > 0)
+	{
+	  iov[n_iov].iov_base = (char *) data;
+	  iov[n_iov++].iov_len = to_do;
+	}
+      count = writev (fp->_fileno, iov, n_iov);
+      if (count == EOF)
+	{
+	  fp->_flags |= _IO_ERR_SEEN;
+	  break;
+	}
+      if (fp->_offset >= 0)
+	fp->_offset += count;
+      if ((_IO_size_t) count < pending)
+	{
+	  base += count;
+	  pending -= count;
+	}
+      else
+	{
+	  count -= pending;
+	  pending = 0;
+	  data += count;
+	  to_do -= count;
+	  done += count;
+	}
+    }
+  _IO_setg (fp, fp->_IO_buf_base, fp->_IO_buf_base, fp->_IO_buf_base);
+  fp->_IO_write_base = fp->_IO_write_ptr = fp->_IO_buf_base;
+  fp->_IO_write_end = ((fp->_flags & (_IO_LINE_BUF+_IO_UNBUFFERED))
+		       ? fp->_IO_buf_base : fp->_IO_buf_end);
+  return done;
+}
+#endif /* _IO_HAVE_WRITEV */
+
+/* Double the buffer of FP, which holds no unread or unwritten characters,
+   if FP is a plain, fully buffered file that owns its buffer and the
+   buffer is still smaller than _IO_BUFSIZ_MAX.  If no memory can be had,
+   FP just keeps the buffer it has. */
+
+static int _IO_file_grow_buffer __P ((_IO_FILE *));
+
+static int
+_IO_file_grow_buffer (fp)
+     _IO_FILE *fp;
+{
+  _IO_size_t size = 2 * (fp->_IO_buf_end - fp->_IO_buf_base);
+  char *p;
+
+  if ((fp->_flags & (_IO_PLAIN_FILE+_IO_USER_BUF+_IO_LINE_BUF+_IO_UNBUFFERED))
+      != _IO_PLAIN_FILE
+      || size > _IO_BUFSIZ_MAX
+      || _IO_have_markers (fp) || _IO_in_backup (fp))
+    return 0;
+  ALLOC_BUF (p, size, EOF);
+  _IO_setb (fp, p, p + size, 1);
+  _IO_setg (fp, p, p, p);
+  fp->_IO_write_base = fp->_IO_write_ptr = p;
+  fp->_IO_write_end = ((fp->_flags & _IO_CURRENTLY_PUTTING)
+		       ? fp->_IO_buf_end : p);
+  return 0;
+}
+
 int
 _IO_file_underflow (fp)
      _IO_FILE *fp;
@@ -300,6 +432,10 @@ _IO_file_underflow (fp)
 
   if (fp->_IO_buf_base == NULL)
     _IO_doallocbuf (fp);
+  else if (fp->_IO_read_end == fp->_IO_buf_end
+	   && !(fp->_flags & _IO_CURRENTLY_PUTTING))
+    /* The last read filled the whole buffer and it has all been used. */
+    _IO_file_grow_buffer (fp);
 
   /* Flush all line buffered files before reading. */
   /* FIXME This can/should be moved to genops ?? */
@@ -375,8 +511,11 @@ _IO_file_overflow (f, ch)
   if (ch == EOF)
     return _IO_do_flush (f);
   if (f->_IO_write_ptr == f->_IO_buf_end ) /* Buffer is really full */
-    if (_IO_do_flush (f) == EOF)
-      return EOF;
+    {
+      if (_IO_do_flush (f) == EOF)
+	return EOF;
+      _IO_file_grow_buffer (f);
+    }
   *f->_IO_write_ptr++ = ch;
   if ((f->_flags & _IO_UNBUFFERED)
       || ((f->_flags & _IO_LINE_BUF) && ch == '\n'))
@@ -655,6 +794,27 @@ _IO_file_xsputn (f, data, n)
      If the amount to be written straddles a block boundary
      (or the filebuf is unbuffered), use sys_write directly. */
 
+#if _IO_HAVE_WRITEV
+  /* If the data is at least a buffer full, write what is buffered and
+     the data with one writev instead of copying some of the data into
+     the buffer first.  As below, write a whole number of blocks. */
+  if ((f->_flags & (_IO_PLAIN_FILE+_IO_CURRENTLY_PUTTING
+		    +_IO_LINE_BUF+_IO_UNBUFFERED))
+      == _IO_PLAIN_FILE+_IO_CURRENTLY_PUTTING
+      && n >= (_IO_size_t) (f->_IO_buf_end - f->_IO_buf_base))
+    {
+      _IO_size_t block_size, dont_write;
+      block_size = f->_IO_buf_end - f->_IO_buf_base;
+      dont_write = (block_size >= 128
+		    ? (f->_IO_write_ptr - f->_IO_write_base + n) % block_size
+		    : 0);
+      count = _IO_file_writev (f, s, n - dont_write);
+      if (count == n - dont_write && dont_write)
+	count += _IO_default_xsputn (f, s + count, dont_write);
+      return count;
+    }
+#endif
+
   /* First figure out how much space is available in the buffer. */
   count = f->_IO_write_end - f->_IO_write_ptr; /* Space available. */
   if ((f->_flags & _IO_LINE_BUF) && (f->_flags & _IO_CURRENTLY_PUTTING))
@@ -697,9 +857,12 @@ _IO_file_xsputn (f, data, n)
   if (to_do + must_flush > 0)
     {
       _IO_size_t block_size, dont_write;
+      int full = f->_IO_buf_base != NULL && f->_IO_write_ptr == f->_IO_buf_end;
       /* Next flush the (full) buffer. */
       if (__overflow (f, EOF) == EOF)
 	return n - to_do;
+      if (full)
+	_IO_file_grow_buffer (f);
 
       /* Try to maintain alignment: write a whole number of blocks.
 	 dont_write is what gets left over. */
@@ -720,76 +883,85 @@ _IO_file_xsputn (f, data, n)
   return n - to_do;
 }
 
-#if 0
-/* Work in progress */
 _IO_size_t
 _IO_file_xsgetn (fp, data, n)
      _IO_FILE *fp;
      void *data;
      _IO_size_t n;
 {
-  register _IO_size_t more = n;
-  register char *s = data;
-  for (;;)
+#if _IO_HAVE_WRITEV
+  /* If at least a buffer full is wanted, hand over what is buffered,
+     then read the rest straight into DATA and refill the buffer with
+     the same readv. */
+  if ((fp->_flags & (_IO_PLAIN_FILE+_IO_NO_READS+_IO_UNBUFFERED))
+      == _IO_PLAIN_FILE
+      && !_IO_have_markers (fp) && !_IO_in_backup (fp))
     {
-      /* Data available. */
-      _IO_ssize_t count = fp->_IO_read_end - fp->_IO_read_ptr;
-      if (count > 0)
+      if (fp->_IO_buf_base == NULL)
+	_IO_doallocbuf (fp);
+      if (n >= (_IO_size_t) (fp->_IO_buf_end - fp->_IO_buf_base))
 	{
-	  if (count > more)
-	    count = more;
-	  if (count > 20)
+	  register _IO_size_t want = n;
+	  register char *s = (char *) data;
+	  _IO_ssize_t count = fp->_IO_read_end - fp->_IO_read_ptr;
+	  struct iovec iov[2];
+
+	  if (count > 0)
 	    {
+	      if ((_IO_size_t) count > want)
+		count = want;
 	      memcpy (s, fp->_IO_read_ptr, count);
-	      s += count;
 	      fp->_IO_read_ptr += count;
+	      s += count;
+	      want -= count;
 	    }
-	  else if (count <= 0)
-	    count = 0;
-	  else
-	    {
-	      register char *p = fp->_IO_read_ptr;
-	      register int i = (int) count;
-	      while (--i >= 0)
-		*s++ = *p++;
-	      fp->_IO_read_ptr = p;
-            }
-            more -= count;
-        }
-#if 0
-      if (! _IO_in put_mode (fp)
-	  && ! _IO_have_markers (fp) && ! IO_have_backup (fp))
-	{
-	  /* This is an optimization of _IO_file_underflow */
-	  if (fp->_flags & _IO_NO_READS)
-	    break;
-	  /* If we're reading a lot of data, don't bother allocating
-	     a buffer.  But if we're only reading a bit, perhaps we should ??*/
-	  if (count <= 512 && fp->_IO_buf_base == NULL)
-	    _IO_doallocbuf (fp);
-	  if (fp->_flags & (_IO_LINE_BUF|_IO_UNBUFFERED))
-	    _IO_flush_all_linebuffered ();
+	  if (want == 0)
+	    return n;
 
-	  _IO_switch_to_get_mode (fp); ???;
-	  count = _IO_SYSREAD (fp, s, more);
-	  if (count <= 0)
-	     {
-	       if (count == 0)
-		 fp->_flags |= _IO_EOF_SEEN;
-	       else
-		 fp->_flags |= _IO_ERR_SEEN, count = 0;
-	     }
-
-	  s += count;
-	  more -= count;
+	  /* As in _IO_file_underflow. */
+	  if (fp->_flags & _IO_LINE_BUF)
+	    _IO_flush_all_linebuffered ();
+	  if (_IO_switch_to_get_mode (fp) == EOF)
+	    return n - want;
+	  fp->_IO_read_base = fp->_IO_read_ptr = fp->_IO_buf_base;
+	  fp->_IO_read_end = fp->_IO_buf_base;
+	  fp->_IO_write_base = fp->_IO_write_ptr = fp->_IO_write_end
+	    = fp->_IO_buf_base;
+
+	  while (want > 0)
+	    {
+	      iov[0].iov_base = s;
+	      iov[0].iov_len = want;
+	      iov[1].iov_base = fp->_IO_buf_base;
+	      iov[1].iov_len = fp->_IO_buf_end - fp->_IO_buf_base;
+	      count = readv (fp->_fileno, iov, 2);
+	      if (count <= 0)
+		{
+		  if (count == 0)
+		    fp->_flags |= _IO_EOF_SEEN;
+		  else
+		    fp->_flags |= _IO_ERR_SEEN;
+		  break;
+		}
+	      if (fp->_offset != _IO_pos_BAD)
+		_IO_pos_adjust (fp->_offset, count);
+	      if ((_IO_size_t) count <= want)
+		{
+		  s += count;
+		  want -= count;
+		}
+	      else
+		{
+		  fp->_IO_read_end += count - want;
+		  want = 0;
+		}
+	    }
+	  return n - want;
 	}
-#endif
-      if (more == 0 || __underflow (fp) == EOF)
-	break;
     }
-  return n - more;
-}
 #endif
+  return _IO_default_xsgetn (fp, data, n);
+}
 
 struct _IO_jump_t _IO_file_jumps =
 {
@@ -800,7 +972,7 @@ struct _IO_jump_t _IO_file_jumps =
   JUMP_INIT(uflow, _IO_default_uflow),
   JUMP_INIT(pbackfail, _IO_default_pbackfail),
   JUMP_INIT(xsputn, _IO_file_xsputn),
-  JUMP_INIT(xsgetn, _IO_default_xsgetn),
+  JUMP_INIT(xsgetn, _IO_file_xsgetn),
   JUMP_INIT(seekoff, _IO_file_seekoff),
   JUMP_INIT(seekpos, _IO_default_seekpos),
   JUMP_INIT(setbuf, _IO_file_setbuf),
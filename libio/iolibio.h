@@ -55,6 +55,7 @@ extern int _IO_obstack_printf __P ((struct obstack *, const char *, ...));
 #define _IO_fileno(FP) ((FP)->_fileno)
 extern _IO_FILE* _IO_popen __P((const char*, const char*));
 #define _IO_pclose _IO_fclose
+extern _IO_FILE* _IO_mmap_fopen __P((const char*));
 #define _IO_setbuf(_FP, _BUF) _IO_setbuffer(_FP, _BUF, _IO_BUFSIZ)
 #define _IO_setlinebuf(_FP) _IO_setvbuf(_FP, NULL, 1, 0)
 
@@ -0,0 +1,289 @@
+/* Copyright (C) 1999 Free Software Foundation, Inc.
+   This file is part of the GNU IO Library.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2, or (at
+   your option) any later version.
+
+   This library is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this library; see the file COPYING.  If not, write to
+   the Free Software Foundation, 59 Temple Place - Suite 330, Boston,
+   MA 02111-1307, USA.
+
+   As a special exception, if you link this library with files
+   compiled with a GNU compiler to produce an executable, this does
+   not cause the resulting executable to be covered by the GNU General
+   Public License.  This exception does not however invalidate any
+   other reasons why the executable file might be covered by the GNU
+   General Public License.  */
+
+
+/* An mmap_file is a file opened for reading whose contents are mapped
+   into memory as a whole when it is opened.  The mapping is the get
+   area, so reading from the file (_IO_getline, _IO_vfscanf, xsgetn)
+   takes the characters straight from it, without a system call or a
+   copy into a buffer.  The mapping is read-only, so a character put
+   back that differs from the one read goes into a backup area.
+   Since there is nothing more to read once the get area is used up,
+   underflow just reports end of file, and seeking only moves
+   _IO_read_ptr. */
+
+#include "libioP.h"
+#ifndef _G_HAVE_MMAP_FILE
+/* This _G_config.h did not come from gen-params; it is that of a
+   C library with its own libio. */
+#define _G_HAVE_MMAP_FILE _G_HAVE_MMAP
+#endif
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if _G_HAVE_MMAP_FILE
+#include <sys/mman.h>
+#endif
+#ifdef __STDC__
+#include <stdlib.h>
+#endif
+#include <errno.h>
+#ifndef errno
+extern int errno;
+#endif
+
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+
+/* Open FILENAME for reading and map it into memory as the get area of
+   FP, whose jump table must be _IO_mmap_jumps or act like it.  Return
+   NULL, with errno set, if FILENAME is not a regular file or cannot
+   be mapped. */
+
+_IO_FILE *
+_IO_mmap_open (fp, filename)
+     _IO_FILE *fp;
+     const char *filename;
+{
+#if _G_HAVE_MMAP_FILE
+  struct stat st;
+  char *p;
+  int fd, save_errno;
+
+  if (_IO_file_is_open (fp))
+    return NULL;
+  fd = open (filename, O_RDONLY, 0);
+  if (fd < 0)
+    return NULL;
+  if (fstat (fd, &st) < 0)
+    goto fail;
+  if (!S_ISREG (st.st_mode))
+    {
+      __set_errno (EINVAL);
+      goto fail;
+    }
+  /* An empty file has nothing to map.  Its get area is empty, but
+     must not be at NULL, which genops takes for no buffer at all. */
+  if (st.st_size == 0)
+    p = fp->_shortbuf;
+  else
+    {
+      p = (char *) mmap (0, st.st_size, PROT_READ, MAP_PRIVATE,
+			 fd, 0);
+      if (p == (char *) MAP_FAILED)
+	goto fail;
+    }
+  fp->_fileno = fd;
+  _IO_mask_flags (fp, _IO_NO_WRITES,
+		  _IO_NO_READS+_IO_NO_WRITES+_IO_IS_APPENDING);
+  /* The mapping is not a buffer _IO_setb could free; _IO_mmap_close
+     unmaps it. */
+  _IO_setb (fp, p, p + st.st_size, 0);
+  _IO_setg (fp, p, p, p + st.st_size);
+  _IO_setp (fp, p, p);
+  _IO_link_in (fp);
+  return fp;
+
+ fail:
+  save_errno = errno;
+  close (fd);
+  __set_errno (save_errno);
+  return NULL;
+#else /* !_G_HAVE_MMAP_FILE */
+  __set_errno (EINVAL);
+  return NULL;
+#endif /* !_G_HAVE_MMAP_FILE */
+}
+
+_IO_FILE *
+_IO_mmap_fopen (filename)
+     const char *filename;
+{
+  struct locked_FILE
+  {
+    struct _IO_FILE_plus fp;
+#ifdef _IO_MTSAFE_IO
+    _IO_lock_t lock;
+#endif
+  } *new_f = (struct locked_FILE *) malloc (sizeof (struct locked_FILE));
+
+  if (new_f == NULL)
+    return NULL;
+#ifdef _IO_MTSAFE_IO
+  new_f->fp.file._lock = &new_f->lock;
+#endif
+  _IO_init (&new_f->fp.file, 0);
+  _IO_JUMPS (&new_f->fp.file) = &_IO_mmap_jumps;
+  _IO_file_init (&new_f->fp.file);
+#if  !_IO_UNIFIED_JUMPTABLES
+  new_f->fp.vtable = NULL;
+#endif
+  if (_IO_mmap_open (&new_f->fp.file, filename) != NULL)
+    return (_IO_FILE *) &new_f->fp;
+  _IO_un_link (&new_f->fp.file);
+  free (new_f);
+  return NULL;
+}
+
+int
+_IO_mmap_underflow (fp)
+     _IO_FILE *fp;
+{
+  if (fp->_IO_read_ptr < fp->_IO_read_end)
+    return *(unsigned char *) fp->_IO_read_ptr;
+  fp->_flags |= _IO_EOF_SEEN;
+  return EOF;
+}
+
+/* The mapping must not be written to, so a character that is not the
+   one before _IO_read_ptr is put back into a backup area, as at the
+   start of the file.  The main get area is made to begin at
+   _IO_read_ptr first, so that reading goes on from there once the
+   backup area is used up. */
+
+int
+_IO_mmap_pbackfail (fp, c)
+     _IO_FILE *fp;
+     int c;
+{
+  if (fp->_IO_read_ptr > fp->_IO_read_base && !_IO_in_backup (fp)
+      && c != EOF && *(unsigned char *) (fp->_IO_read_ptr - 1) != c)
+    fp->_IO_read_base = fp->_IO_read_ptr;
+  return _IO_default_pbackfail (fp, c);
+}
+
+/* The buffer is always the whole file, so the position is just where
+   _IO_read_ptr is in it, less any characters left in a backup area.
+   A seek drops them. */
+
+#if defined(_G_IO_IO_FILE_VERSION) && _G_IO_IO_FILE_VERSION == 0x20001
+_IO_off64_t
+_IO_mmap_seekoff (fp, offset, dir, mode)
+     _IO_FILE *fp;
+     _IO_off64_t offset;
+#else
+_IO_off_t
+_IO_mmap_seekoff (fp, offset, dir, mode)
+     _IO_FILE *fp;
+     _IO_off_t offset;
+#endif
+     int dir;
+     int mode;
+{
+  if (mode == 0)
+    dir = _IO_seek_cur, offset = 0; /* Don't move any pointers. */
+
+  switch (dir)
+    {
+    case _IO_seek_cur:
+      if (_IO_in_backup (fp))
+	offset += (fp->_IO_save_base - fp->_IO_buf_base
+		   - (fp->_IO_read_end - fp->_IO_read_ptr));
+      else
+	offset += fp->_IO_read_ptr - fp->_IO_buf_base;
+      break;
+    case _IO_seek_set:
+      break;
+    case _IO_seek_end:
+      offset += fp->_IO_buf_end - fp->_IO_buf_base;
+      break;
+    }
+  if (offset < 0 || offset > fp->_IO_buf_end - fp->_IO_buf_base)
+    {
+      __set_errno (EINVAL);
+      return EOF;
+    }
+  if (mode != 0)
+    {
+      if (_IO_have_backup (fp))
+	_IO_free_backup_area (fp);
+      _IO_setg (fp, fp->_IO_buf_base, fp->_IO_buf_base + offset,
+		fp->_IO_buf_end);
+      _IO_mask_flags (fp, 0, _IO_EOF_SEEN);
+    }
+  return offset;
+}
+
+/* There is no buffer to replace. */
+
+_IO_FILE *
+_IO_mmap_setbuf (fp, p, len)
+     _IO_FILE *fp;
+     char *p;
+     _IO_ssize_t len;
+{
+  return fp;
+}
+
+/* Nothing is ever waiting to be written. */
+
+int
+_IO_mmap_sync (fp)
+     _IO_FILE *fp;
+{
+  return 0;
+}
+
+int
+_IO_mmap_close (fp)
+     _IO_FILE *fp;
+{
+  /* Any putback buffer must go before the mapping; _IO_default_finish
+     would otherwise free the saved main get area. */
+  if (_IO_have_backup (fp))
+    _IO_free_backup_area (fp);
+#if _G_HAVE_MMAP_FILE
+  if (fp->_IO_buf_end > fp->_IO_buf_base && (fp->_flags & _IO_USER_BUF))
+    munmap (fp->_IO_buf_base, fp->_IO_buf_end - fp->_IO_buf_base);
+#endif
+  _IO_setb (fp, NULL, NULL, 0);
+  _IO_setg (fp, NULL, NULL, NULL);
+  _IO_setp (fp, NULL, NULL);
+  return close (fp->_fileno);
+}
+
+struct _IO_jump_t _IO_mmap_jumps =
+{
+  JUMP_INIT_DUMMY,
+  JUMP_INIT(finish, _IO_file_finish),
+  JUMP_INIT(overflow, _IO_file_overflow),
+  JUMP_INIT(underflow, _IO_mmap_underflow),
+  JUMP_INIT(uflow, _IO_default_uflow),
+  JUMP_INIT(pbackfail, _IO_mmap_pbackfail),
+  JUMP_INIT(xsputn, _IO_default_xsputn),
+  JUMP_INIT(xsgetn, _IO_default_xsgetn),
+  JUMP_INIT(seekoff, _IO_mmap_seekoff),
+  JUMP_INIT(seekpos, _IO_default_seekpos),
+  JUMP_INIT(setbuf, _IO_mmap_setbuf),
+  JUMP_INIT(sync, _IO_mmap_sync),
+  JUMP_INIT(doallocate, _IO_file_doallocate),
+  JUMP_INIT(read, _IO_file_read),
+  JUMP_INIT(write, _IO_file_write),
+  JUMP_INIT(seek, _IO_file_seek),
+  JUMP_INIT(close, _IO_mmap_close),
+  JUMP_INIT(stat, _IO_file_stat)
+};
@@ -182,6 +182,122 @@ extern double modf __P((double, double*));
 #define	ZEROPAD		0x20		/* zero (as opposed to blank) pad */
 #define	HEXPREFIX	0x40		/* add 0x or 0X prefix */
 
+/*
+ * The decimal digits of 0 to 99, two characters each, so that numbers
+ * can be converted two digits per division.
+ */
+static const char digit_pairs[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/*
+ * Convert VAL to decimal, backwards from END; return the first digit.
+ */
+static char *
+cvt_decimal (val, end)
+     register unsigned long val;
+     register char *end;
+{
+	register int n;
+
+	while (val >= 100) {
+		n = (int) (val % 100) * 2;
+		val /= 100;
+		*--end = digit_pairs[n + 1];
+		*--end = digit_pairs[n];
+	}
+	if (val >= 10) {
+		n = (int) val * 2;
+		*--end = digit_pairs[n + 1];
+		*--end = digit_pairs[n];
+	} else
+		*--end = to_char(val);
+	return end;
+}
+
+#if defined(FLOATING_POINT) && defined(_IO_USE_DTOA)
+
+/*
+ * %f with a precision of at most FIXED_MAXPREC is converted by
+ * cvt_fixed when the scaled number is below FIXED_LIMIT, which leaves
+ * it an error of at most 2^-12 and makes FIXED_SLOP a safe margin
+ * around halfway cases.
+ */
+#define	FIXED_MAXPREC	9
+#define	FIXED_LIMIT	1099511627776.0	/* 2^40 */
+#define	FIXED_SLOP	(1.0 / 1024)
+
+static const double fixed_scale[FIXED_MAXPREC + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+/*
+ * Convert NUMBER as %.PRECf (with the `#' flag if ALT), backwards from
+ * END, and set *SIGNP if NUMBER is negative, as _IO_outfloat does.
+ * Return the first character, or NULL if NUMBER is too large, or too
+ * close to halfway between two results to tell which one _IO_dtoa
+ * would round it to; then _IO_outfloat must do it.
+ */
+static char *
+cvt_fixed (number, prec, alt, end, signp)
+     double number;
+     int prec;
+     int alt;
+     char *end;
+     int *signp;
+{
+	static const double zero = 0.0;
+	double scaled, whole, fract, hi;
+	unsigned long lo;
+	register char *cp = end;
+	int i;
+
+	/* -0.0 prints as "-0.000", like any other negative number. */
+	*signp = number < 0
+		|| (number == 0 && memcmp(&number, &zero, sizeof(number)));
+	if (*signp)
+		number = -number;
+	scaled = number * fixed_scale[prec];
+	if (!(scaled < FIXED_LIMIT && number < 4294967295.0))
+		return NULL;	/* also Infinity and NaN */
+	fract = modf(scaled, &whole);
+	if (fract > 0.5 - FIXED_SLOP && fract < 0.5 + FIXED_SLOP)
+		return NULL;
+	if (fract > 0.5)
+		whole += 1;
+
+	/* Split WHOLE into the integer part and the fraction digits;
+	   the division may be off by one, but the products are exact. */
+	(void)modf(whole / fixed_scale[prec], &hi);
+	fract = whole - hi * fixed_scale[prec];
+	if (fract < 0) {
+		hi -= 1;
+		fract += fixed_scale[prec];
+	} else if (fract >= fixed_scale[prec]) {
+		hi += 1;
+		fract -= fixed_scale[prec];
+	}
+
+	lo = (unsigned long)fract;
+	for (i = prec; i > 0; i--) {
+		*--cp = to_char(lo % 10);
+		lo /= 10;
+	}
+	if (prec || alt)
+		*--cp = '.';
+	return cvt_decimal((unsigned long)hi, cp);
+}
+
+#endif /* defined(FLOATING_POINT) && defined(_IO_USE_DTOA) */
+
 int
 _IO_vfprintf (fp, fmt0, ap)
      _IO_FILE *fp;
@@ -218,12 +334,23 @@ _IO_vfprintf (fp, fmt0, ap)
 	char ox[2];		/* space for 0x hex-prefix */
 
 	/*
-	 * BEWARE, these `goto error' on error, and PAD uses `n'.
+	 * BEWARE, these `goto error' on error.  Like _IO_putc_unlocked,
+	 * they store straight into the put area when there is room, and
+	 * only call _IO_sputn or _IO_padn, which can flush, when not.
 	 */
 #define	PRINT(ptr, len) \
-  do { if (_IO_sputn(fp,ptr, len) != len) goto error; } while (0)
-#define PAD_SP(howmany) if (_IO_padn(fp, ' ', howmany) < (howmany)) goto error;
-#define PAD_0(howmany) if (_IO_padn(fp, '0', howmany) < (howmany)) goto error;
+  do { if (fp->_IO_write_end - fp->_IO_write_ptr >= (len)) { \
+	 memcpy(fp->_IO_write_ptr, ptr, len); fp->_IO_write_ptr += (len); \
+       } else if (_IO_sputn(fp,ptr, len) != len) goto error; } while (0)
+#define	PAD(ch, howmany) \
+  do { if ((howmany) <= 0) break; \
+       if (fp->_IO_write_end - fp->_IO_write_ptr >= (howmany)) { \
+	 memset(fp->_IO_write_ptr, ch, howmany); \
+	 fp->_IO_write_ptr += (howmany); \
+       } else if (_IO_padn(fp, ch, howmany) < (howmany)) goto error; \
+  } while (0)
+#define PAD_SP(howmany) PAD(' ', howmany)
+#define PAD_0(howmany) PAD('0', howmany)
 
 	/*
 	 * To extend shorts properly, we need both signed and unsigned
@@ -368,6 +495,15 @@ reswitch:	switch (ch) {
 		case 'G':
 			_double = va_arg(ap, double);
 #ifdef _IO_USE_DTOA
+			if (ch == 'f' && (n = prec < 0 ? DEFPREC : prec)
+			    <= FIXED_MAXPREC
+			    && (cp = cvt_fixed(_double, n, flags & ALT,
+					       buf + BUF, &softsign)) != NULL) {
+				size = buf + BUF - cp;
+				if (softsign)
+					sign = '-';
+				break;
+			}
 			{
 			    int fmt_flags = 0;
 			    int fill = ' ';
@@ -514,12 +650,7 @@ number:			if ((dprec = prec) >= 0)
 					break;
 
 				case DEC:
-					/* many numbers are 1 digit */
-					while (_ulong >= 10) {
-						*--cp = to_char(_ulong % 10);
-						_ulong /= 10;
-					}
-					*--cp = to_char(_ulong);
+					cp = cvt_decimal(_ulong, cp);
 					break;
 
 				case HEX:
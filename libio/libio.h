@@ -37,6 +37,7 @@
 #define _IO_uid_t _G_uid_t
 #define _IO_HAVE_SYS_WAIT _G_HAVE_SYS_WAIT
 #define _IO_HAVE_ST_BLKSIZE _G_HAVE_ST_BLKSIZE
+#define _IO_HAVE_WRITEV _G_HAVE_WRITEV
 #define _IO_BUFSIZ _G_BUFSIZ
 #define _IO_va_list _G_va_list
 #if defined(_G_IO_IO_FILE_VERSION) && _G_IO_IO_FILE_VERSION == 0x20001
@@ -136,6 +137,7 @@
 #define _IO_IS_APPENDING 0x1000
 #define _IO_IS_FILEBUF 0x2000
 #define _IO_BAD_SEEN 0x4000
+#define _IO_PLAIN_FILE 0x8000 /* Reads and writes go straight to _fileno. */
 
 /* These are "formatting flags" matching the iostream fmtflags enum values. */
 #define _IO_SKIPWS 01
@@ -39,6 +39,11 @@
 
 #include "iolibio.h"
 
+/* The libio.h of a C library that has its own libio may not have this.  */
+#ifndef _IO_PLAIN_FILE
+# define _IO_PLAIN_FILE 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -356,6 +361,7 @@ extern int _IO_default_sync __P ((_IO_FILE *));
 extern struct _IO_jump_t _IO_file_jumps;
 extern struct _IO_jump_t _IO_streambuf_jumps;
 extern struct _IO_jump_t _IO_proc_jumps;
+extern struct _IO_jump_t _IO_mmap_jumps;
 extern struct _IO_jump_t _IO_str_jumps;
 extern int _IO_do_write __P ((_IO_FILE *, const char *, _IO_size_t));
 extern int _IO_flush_all __P ((void));
@@ -389,6 +395,7 @@ extern _IO_off_t _IO_file_seekoff __P ((_IO_FILE *, _IO_off_t, int, int));
 extern _IO_off_t _IO_file_seek __P ((_IO_FILE *, _IO_off_t, int));
 #endif
 extern _IO_size_t _IO_file_xsputn __P ((_IO_FILE *, const void *, _IO_size_t));
+extern _IO_size_t _IO_file_xsgetn __P ((_IO_FILE *, void *, _IO_size_t));
 extern int _IO_file_stat __P ((_IO_FILE *, void *));
 extern int _IO_file_close __P ((_IO_FILE *));
 extern int _IO_file_underflow __P ((_IO_FILE *));
@@ -415,6 +422,19 @@ extern void _IO_file_finish __P ((_IO_FILE *, int));
 extern _IO_FILE* _IO_proc_open __P ((_IO_FILE *, const char *, const char *));
 extern int _IO_proc_close __P ((_IO_FILE *));
 
+/* Jumptable functions for mmap_files. */
+extern _IO_FILE* _IO_mmap_open __P ((_IO_FILE *, const char *));
+extern int _IO_mmap_underflow __P ((_IO_FILE *));
+extern int _IO_mmap_pbackfail __P ((_IO_FILE *, int));
+#if defined(_G_IO_IO_FILE_VERSION) && _G_IO_IO_FILE_VERSION == 0x20001
+extern _IO_off64_t _IO_mmap_seekoff __P ((_IO_FILE *, _IO_off64_t, int, int));
+#else
+extern _IO_off_t _IO_mmap_seekoff __P ((_IO_FILE *, _IO_off_t, int, int));
+#endif
+extern _IO_FILE* _IO_mmap_setbuf __P ((_IO_FILE *, char *, _IO_ssize_t));
+extern int _IO_mmap_sync __P ((_IO_FILE *));
+extern int _IO_mmap_close __P ((_IO_FILE *));
+
 /* Jumptable functions for strfiles. */
 extern int _IO_str_underflow __P ((_IO_FILE *));
 extern int _IO_str_overflow __P ((_IO_FILE *, int));
@@ -0,0 +1,75 @@
+/* This is part of libio/iostream, providing -*- C++ -*- input/output.
+Copyright (C) 1999 Free Software Foundation
+
+This file is part of the GNU IO Library.  This library is free
+software; you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the
+Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this library; see the file COPYING.  If not, write to the Free
+Software Foundation, 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+As a special exception, if you link this library with files
+compiled with a GNU compiler to produce an executable, this does not cause
+the resulting executable to be covered by the GNU General Public License.
+This exception does not however invalidate any other reasons why
+the executable file might be covered by the GNU General Public License. */
+
+#ifdef __GNUG__
+#pragma implementation
+#endif
+
+#include "libioP.h"
+#include "mmapbuf.h"
+
+mmapbuf::mmapbuf(const char *filename) : filebuf()
+{
+  _IO_mmap_open(this, filename);
+}
+
+mmapbuf* mmapbuf::open(const char *filename)
+{
+  return (mmapbuf*)_IO_mmap_open(this, filename);
+}
+
+int mmapbuf::underflow()
+{
+  return _IO_mmap_underflow(this);
+}
+
+int mmapbuf::pbackfail(int c)
+{
+  return _IO_mmap_pbackfail(this, c);
+}
+
+streampos mmapbuf::seekoff(streamoff offset, _seek_dir dir, int mode)
+{
+  return _IO_mmap_seekoff(this, offset, dir, mode);
+}
+
+streambuf* mmapbuf::setbuf(char* p, int len)
+{
+  return (streambuf*)_IO_mmap_setbuf(this, p, len);
+}
+
+int mmapbuf::sync()
+{
+  return _IO_mmap_sync(this);
+}
+
+int mmapbuf::sys_close()
+{
+  return _IO_mmap_close(this);
+}
+
+mmapbuf::~mmapbuf()
+{
+  close();
+}
@@ -0,0 +1,67 @@
+/* This is part of libio/iostream, providing -*- C++ -*- input/output.
+Copyright (C) 1999 Free Software Foundation
+
+This file is part of the GNU IO Library.  This library is free
+software; you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the
+Free Software Foundation; either version 2, or (at your option)
+any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this library; see the file COPYING.  If not, write to the Free
+Software Foundation, 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+As a special exception, if you link this library with files
+compiled with a GNU compiler to produce an executable, this does not cause
+the resulting executable to be covered by the GNU General Public License.
+This exception does not however invalidate any other reasons why
+the executable file might be covered by the GNU General Public License. */
+
+#ifndef _MMAPBUF_H
+#define _MMAPBUF_H
+#ifdef __GNUG__
+#pragma interface
+#endif
+
+#include <iostream.h>
+
+extern "C++" {
+// A read-only filebuf whose file is mapped into memory as a whole and
+// read straight from the mapping.  See iommap.c.
+class mmapbuf : public filebuf {
+  public:
+    mmapbuf() : filebuf() { }
+    mmapbuf(const char *filename);
+    mmapbuf* open(const char *filename);
+    mmapbuf *close() { return (mmapbuf*)filebuf::close(); }
+    virtual int underflow();
+    virtual int pbackfail(int c);
+    virtual streampos seekoff(streamoff, _seek_dir, int mode=ios::in|ios::out);
+    virtual streambuf* setbuf(char* p, int len);
+    virtual int sync();
+    virtual int sys_close();
+    ~mmapbuf();
+};
+
+class immapstream : public istream
+{
+private:
+  mmapbuf _buf;
+public:
+  immapstream () : istream(), _buf() { init (&_buf); }
+  immapstream (const char *name) : istream(), _buf()
+    { init (&_buf); open (name); }
+  void open (const char *name)
+    { clear (); if (!_buf.open (name)) set (ios::badbit); }
+  void close () { if (!_buf.close ()) set (ios::failbit); }
+  int is_open () const { return _buf.is_open (); }
+  mmapbuf* rdbuf() /* const */ { return &_buf; }
+};
+} // extern "C++"
+
+#endif /* !_MMAPBUF_H */
@@ -64,10 +64,10 @@ extern char filebuf_vtable[];
   struct _IO_FILE_plus NAME = {FILEBUF_LITERAL(CHAIN, FLAGS, FD), STD_VTABLE}
 #endif
 
-DEF_STDFILE(_IO_stdin_, 0, 0, _IO_NO_WRITES);
-DEF_STDFILE(_IO_stdout_, 1, &_IO_stdin_.file, _IO_NO_READS);
+DEF_STDFILE(_IO_stdin_, 0, 0, _IO_NO_WRITES+_IO_PLAIN_FILE);
+DEF_STDFILE(_IO_stdout_, 1, &_IO_stdin_.file, _IO_NO_READS+_IO_PLAIN_FILE);
 DEF_STDFILE(_IO_stderr_, 2, &_IO_stdout_.file,
-            _IO_NO_READS+_IO_UNBUFFERED);
+            _IO_NO_READS+_IO_UNBUFFERED+_IO_PLAIN_FILE);
 
 #ifdef _STDIO_USES_IOSTREAM
 _IO_FILE *_IO_list_all = &_IO_stderr_.file;
@@ -0,0 +1,117 @@
+/* Check that the buffer of a file is grown while it is written with
+   putc and fwrite and read back with getc and fread, and that the data
+   survive each change of buffer. */
+
+#include "libioP.h"
+#include <iostdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TMPFILE "tgrowbuf.dat"
+#define SIZE 300000
+
+static int errors = 0;
+
+static int
+byte (i)
+     long i;
+{
+  return (i * 7 + i / 251) & 0xff;
+}
+
+static void
+check (what, ok)
+     const char *what;
+     int ok;
+{
+  if (!ok)
+    {
+      printf ("FAIL: %s\n", what);
+      errors++;
+    }
+}
+
+static long
+buffer_size (fp)
+     FILE *fp;
+{
+  return fp->_IO_buf_end - fp->_IO_buf_base;
+}
+
+/* Write the first half a character at a time and the rest in chunks
+   of odd sizes. */
+
+static void
+t1 ()
+{
+  FILE *fp = fopen (TMPFILE, "w");
+  char chunk[1000];
+  long i, n, first;
+
+  check ("t1 fopen", fp != NULL);
+  if (fp == NULL)
+    return;
+  putc (byte (0), fp);
+  first = buffer_size (fp);
+  for (i = 1; i < SIZE / 2; i++)
+    putc (byte (i), fp);
+  for (n = 1; i < SIZE; i += n, n = n * 3 % 997)
+    {
+      long j;
+      if (n > SIZE - i)
+	n = SIZE - i;
+      for (j = 0; j < n; j++)
+	chunk[j] = byte (i + j);
+      check ("t1 fwrite", fwrite (chunk, 1, n, fp) == n);
+    }
+  check ("t1 buffer grew", buffer_size (fp) > first);
+  check ("t1 fclose", fclose (fp) == 0);
+  printf ("t1: wrote %ld\n", i);
+}
+
+/* Read the file back the same way. */
+
+static void
+t2 ()
+{
+  FILE *fp = fopen (TMPFILE, "r");
+  char chunk[1000];
+  long i, n, first;
+  int c, bad = 0;
+
+  check ("t2 fopen", fp != NULL);
+  if (fp == NULL)
+    return;
+  c = getc (fp);
+  bad |= c != byte (0);
+  first = buffer_size (fp);
+  for (i = 1; i < SIZE / 2; i++)
+    if (getc (fp) != byte (i))
+      bad = 1;
+  for (n = 1; i < SIZE; i += n, n = n * 3 % 997)
+    {
+      long j;
+      if (n > SIZE - i)
+	n = SIZE - i;
+      check ("t2 fread", fread (chunk, 1, n, fp) == n);
+      for (j = 0; j < n; j++)
+	if ((unsigned char) chunk[j] != byte (i + j))
+	  bad = 1;
+    }
+  check ("t2 data", !bad);
+  check ("t2 at end", getc (fp) == EOF);
+  check ("t2 buffer grew", buffer_size (fp) > first);
+  fclose (fp);
+  printf ("t2: read %ld\n", i);
+}
+
+int
+main ()
+{
+  t1 ();
+  t2 ();
+  unlink (TMPFILE);
+  if (errors == 0)
+    printf ("PASSED\n");
+  return errors != 0;
+}
@@ -0,0 +1,156 @@
+// Test immapstream by reading the same file through it and through an
+// ifstream, and checking that both give the same results.
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream.h>
+#include <mmapbuf.h>
+
+#define TMPFILE "tmmap.dat"
+
+static int errors = 0;
+
+static void
+check (const char *what, int ok)
+{
+  if (!ok)
+    {
+      cout << "FAIL: " << what << '\n';
+      errors++;
+    }
+}
+
+static void
+make_file (int lines)
+{
+  ofstream out (TMPFILE);
+  for (int i = 0; i < lines; i++)
+    out << i * 37 << ' ' << (i % 3 ? "word" : "other") << " line" << i << '\n';
+}
+
+// Read the file line by line.
+
+static void
+t1 ()
+{
+  ifstream f (TMPFILE);
+  immapstream m (TMPFILE);
+  char b1[100], b2[100];
+  int lines = 0;
+
+  check ("open", f.good () && m.good () && m.is_open ());
+  while (f.getline (b1, sizeof b1))
+    {
+      m.getline (b2, sizeof b2);
+      check ("getline", m.good () && strcmp (b1, b2) == 0);
+      lines++;
+    }
+  m.getline (b2, sizeof b2);
+  check ("getline at eof", m.eof () && m.fail ());
+  cout << "t1: " << lines << " lines\n";
+}
+
+// Read the file with operator>>.
+
+static void
+t2 ()
+{
+  ifstream f (TMPFILE);
+  immapstream m (TMPFILE);
+  char w1[50], w2[50];
+  int n1, n2, words = 0;
+
+  while (f >> n1 >> w1)
+    {
+      m >> n2 >> w2;
+      check (">>", m.good () && n1 == n2 && strcmp (w1, w2) == 0);
+      f >> w1;
+      m >> w2;
+      check (">>", m.good () && strcmp (w1, w2) == 0);
+      words += 3;
+    }
+  m >> n2;
+  check (">> at eof", m.fail ());
+  cout << "t2: " << words << " words\n";
+}
+
+// Read blocks, seek, and put characters back.
+
+static void
+t3 ()
+{
+  ifstream f (TMPFILE);
+  immapstream m (TMPFILE);
+  char b1[1000], b2[1000];
+  int c1, c2;
+
+  f.read (b1, sizeof b1);
+  m.read (b2, sizeof b2);
+  check ("read", m.gcount () == f.gcount ()
+	 && memcmp (b1, b2, m.gcount ()) == 0);
+  cout << "t3: read " << m.gcount () << ", at " << m.tellg () << '\n';
+
+  f.seekg (-10, ios::end);
+  m.seekg (-10, ios::end);
+  check ("tellg", m.tellg () == f.tellg ());
+  cout << "t3: end - 10 at " << m.tellg () << '\n';
+
+  f.seekg (123);
+  m.seekg (123);
+  c1 = f.get ();
+  c2 = m.get ();
+  check ("get", c1 == c2);
+  m.putback (c2);
+  c2 = m.get ();
+  check ("putback", c1 == c2);
+  m.putback ('#');
+  check ("putback #", m.get () == '#' && m.tellg () == 124);
+  c1 = f.get ();
+  c2 = m.get ();
+  check ("get after putback", c1 == c2);
+
+  f.seekg (123);
+  m.seekg (123);
+  check ("reread", m.get () == f.get ());
+  m.seekg (0);
+  check ("putback at start", m.putback ('#').get () == '#'
+	 && m.get () == b1[0]);
+
+  m.seekg (0, ios::end);
+  check ("get at eof", m.get () == EOF && m.eof ());
+  m.clear ();
+  m.seekg (1, ios::end);
+  check ("seek past eof", m.bad ());
+  cout << "t3: done\n";
+}
+
+// Files that cannot be mapped.
+
+static void
+t4 ()
+{
+  immapstream m ("/nonexistent/" TMPFILE);
+  check ("nonexistent", !m.is_open () && m.bad ());
+
+  ofstream out (TMPFILE);
+  out.close ();
+  m.open (TMPFILE);
+  check ("empty", m.is_open () && m.get () == EOF && m.eof ());
+  m.close ();
+  check ("close", !m.is_open ());
+  cout << "t4: done\n";
+}
+
+int
+main ()
+{
+  make_file (500);
+  t1 ();
+  t2 ();
+  t3 ();
+  t4 ();
+  unlink (TMPFILE);
+  cout << (errors ? "FAILED\n" : "PASSED\n");
+  return errors != 0;
+}
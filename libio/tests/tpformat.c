@@ -0,0 +1,169 @@
+/* Check that the fast paths of _IO_vfprintf for %d, %u and %f give
+   the same output as the general code: %f against _IO_outfloat, and
+   the integer conversions against a plain one-digit-at-a-time loop. */
+
+#include "libioP.h"
+#include "strfile.h"
+#include <iostdio.h>
+#include <string.h>
+
+static int errors = 0;
+static int cases = 0;
+
+static unsigned long random_state = 1;
+
+static unsigned long
+random_number ()
+{
+  random_state = (random_state * 1103515245 + 12345) & 0xffffffff;
+  return random_state >> 1;
+}
+
+static void
+compare (format, got, expected)
+     const char *format;
+     const char *got;
+     const char *expected;
+{
+  cases++;
+  if (strcmp (got, expected) != 0)
+    {
+      if (errors++ < 20)
+	printf ("%s: got \"%s\", expected \"%s\"\n", format, got, expected);
+    }
+}
+
+/* Print VALUE with _IO_outfloat as _IO_vfprintf would for %PREC.f with
+   the given flags and WIDTH. */
+
+static void
+outfloat (buf, value, width, prec, flag)
+     char *buf;
+     double value;
+     int width;
+     int prec;
+     int flag;
+{
+  _IO_strfile sf;
+  int fmt_flags = 0;
+  int fill = ' ';
+  int sign = 0;
+  int n;
+
+  _IO_init ((_IO_FILE *) &sf, 0);
+  _IO_JUMPS ((_IO_FILE *) &sf) = &_IO_str_jumps;
+  _IO_str_init_static ((_IO_FILE *) &sf, buf, 399, buf);
+  switch (flag)
+    {
+    case '#': fmt_flags |= _IO_SHOWPOINT; break;
+    case '-': fmt_flags |= _IO_LEFT; break;
+    case '0': fmt_flags |= _IO_INTERNAL; fill = '0'; break;
+    case '+': case ' ': sign = flag; break;
+    }
+  n = _IO_outfloat (value, (_IO_FILE *) &sf, 'f', width, prec,
+		    fmt_flags, sign, fill);
+  buf[n < 0 ? 0 : n] = '\0';
+}
+
+static double
+random_double ()
+{
+  double d = (double) random_number ();
+
+  switch (random_number () % 6)
+    {
+    case 0: return d / 1000;		/* exact in %.3f, more or less */
+    case 1: return -d / 1024;		/* halfway cases */
+    case 2: return d / 1e9;
+    case 3: return d * d;		/* too large for the fast path */
+    case 4: return (random_number () % 2000) * 0.0005;
+    default: return -d / 7;
+    }
+}
+
+static void
+test_floats ()
+{
+  static const char flags[] = "\0#-0+ ";
+  static const double fixed[] =
+    { 0.0, 0.5, 1.5, 2.5, 0.125, 0.0005, 1.0005, 9.9995, 99.5,
+      4294967295.0, 4294967296.0, 1e300, -1e-300 };
+  char format[20], got[400], expected[400];
+  double value;
+  int i, prec, width, flag;
+
+  for (i = 0; i < 20000; i++)
+    {
+      value = i < sizeof (fixed) / sizeof (fixed[0]) ? fixed[i]
+	: random_double ();
+      prec = random_number () % 11;
+      width = random_number () % 3 ? 0 : random_number () % 20;
+      flag = flags[random_number () % (sizeof (flags) - 1)];
+      if (flag)
+	sprintf (format, "%%%c%d.%df", flag, width, prec);
+      else
+	sprintf (format, "%%%d.%df", width, prec);
+      sprintf (got, format, value);
+      outfloat (expected, value, width, prec, flag);
+      compare (format, got, expected);
+    }
+}
+
+static void
+decimal (buf, value, negative)
+     char *buf;
+     unsigned long value;
+     int negative;
+{
+  char digits[40];
+  char *cp = digits + sizeof (digits);
+
+  *--cp = '\0';
+  do
+    {
+      *--cp = '0' + value % 10;
+      value /= 10;
+    }
+  while (value);
+  if (negative)
+    *--cp = '-';
+  strcpy (buf, cp);
+}
+
+static void
+test_integers ()
+{
+  char got[100], expected[100];
+  unsigned long u;
+  long l;
+  int i;
+
+  for (i = 0; i < 20000; i++)
+    {
+      u = (random_number () << (i % 16)) ^ random_number ();
+      if (i % 3 == 0)
+	u %= 1000;
+      sprintf (got, "%lu", u);
+      decimal (expected, u, 0);
+      compare ("%lu", got, expected);
+
+      l = (long) u;
+      sprintf (got, "%ld", l);
+      decimal (expected, l < 0 ? -(unsigned long) l : (unsigned long) l,
+	       l < 0);
+      compare ("%ld", got, expected);
+    }
+}
+
+int
+main ()
+{
+  test_floats ();
+  test_integers ();
+  if (errors)
+    {
+      printf ("%d of %d cases differ\n", errors, cases);
+      return 1;
+    }
+  return 0;
+}
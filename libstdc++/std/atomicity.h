@@ -0,0 +1,144 @@
+// Low-level atomic operations for the -*- C++ -*- library.
+// Copyright (C) 1999 Free Software Foundation
+
+// This file is part of the GNU ANSI C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// As a special exception, if you link this library with files
+// compiled with a GNU compiler to produce an executable, this does not cause
+// the resulting executable to be covered by the GNU General Public License.
+// This exception does not however invalidate any other reasons why
+// the executable file might be covered by the GNU General Public License.
+
+// __exchange_and_add (MEM, VAL) adds VAL to *MEM and returns the value
+// *MEM had before, as one operation that no other processor can split.
+// __atomic_add (MEM, VAL) does the same without returning anything.
+// They are only defined, along with __HAVE_ATOMICITY, for the processors
+// we know how to do this on; elsewhere callers must use a lock.
+
+#ifndef __ATOMICITY_H
+#define __ATOMICITY_H
+
+typedef int _Atomic_word;
+
+#if defined (__i486__) || defined (__pentium__) || defined (__pentiumpro__)
+
+#define __HAVE_ATOMICITY
+
+static inline _Atomic_word
+__exchange_and_add (volatile _Atomic_word *mem, int val)
+{
+  register _Atomic_word result;
+  __asm__ __volatile__ ("lock; xaddl %0,%2"
+			: "=r" (result)
+			: "0" (val), "m" (*mem)
+			: "memory");
+  return result;
+}
+
+static inline void
+__atomic_add (volatile _Atomic_word *mem, int val)
+{
+  __asm__ __volatile__ ("lock; addl %0,%1"
+			: : "ir" (val), "m" (*mem) : "memory");
+}
+
+#elif defined (__mips__) && (__mips >= 2 || defined (__linux__))
+
+// ll and sc are MIPS II instructions; the Linux kernel emulates them on
+// MIPS I processors.
+
+#define __HAVE_ATOMICITY
+
+static inline _Atomic_word
+__exchange_and_add (volatile _Atomic_word *mem, int val)
+{
+  _Atomic_word result, tmp;
+  __asm__ __volatile__ ("\t.set\tmips2\n"
+			"1:\tll\t%0,%3\n"
+			"\taddu\t%1,%4,%0\n"
+			"\tsc\t%1,%2\n"
+			"\tbeqz\t%1,1b\n"
+			"\t.set\tmips0"
+			: "=&r" (result), "=&r" (tmp), "=m" (*mem)
+			: "m" (*mem), "r" (val)
+			: "memory");
+  return result;
+}
+
+static inline void
+__atomic_add (volatile _Atomic_word *mem, int val)
+{
+  __exchange_and_add (mem, val);
+}
+
+#elif defined (__alpha__)
+
+#define __HAVE_ATOMICITY
+
+static inline _Atomic_word
+__exchange_and_add (volatile _Atomic_word *mem, int val)
+{
+  register int result, tmp;
+  __asm__ __volatile__ ("\n1:\t"
+			"ldl_l\t%0,%3\n\t"
+			"addl\t%0,%4,%1\n\t"
+			"stl_c\t%1,%2\n\t"
+			"beq\t%1,2f\n\t"
+			"mb\n\t"
+			".subsection 1\n"
+			"2:\tbr\t1b\n\t"
+			".previous"
+			: "=&r" (result), "=&r" (tmp), "=m" (*mem)
+			: "m" (*mem), "r" (val)
+			: "memory");
+  return result;
+}
+
+static inline void
+__atomic_add (volatile _Atomic_word *mem, int val)
+{
+  __exchange_and_add (mem, val);
+}
+
+#elif defined (__PPC__) || defined (__powerpc__)
+
+#define __HAVE_ATOMICITY
+
+static inline _Atomic_word
+__exchange_and_add (volatile _Atomic_word *mem, int val)
+{
+  _Atomic_word result, tmp;
+  __asm__ __volatile__ ("\n1:\t"
+			"lwarx\t%0,0,%2\n\t"
+			"add\t%1,%0,%3\n\t"
+			"stwcx.\t%1,0,%2\n\t"
+			"bne-\t1b\n\t"
+			"isync"
+			: "=&b" (result), "=&r" (tmp)
+			: "r" (mem), "r" (val)
+			: "cr0", "memory");
+  return result;
+}
+
+static inline void
+__atomic_add (volatile _Atomic_word *mem, int val)
+{
+  __exchange_and_add (mem, val);
+}
+
+#endif
+
+#endif /* __ATOMICITY_H */
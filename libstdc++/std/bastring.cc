@@ -99,7 +99,7 @@ alloc (basic_string::size_type size, bool save)
   if (! check_realloc (size))
     return;
 
-  Rep *p = Rep::create (size);
+  Rep *p = new_rep (size);
 
   if (save)
     {
@@ -161,7 +161,7 @@ replace (size_type pos, size_type n1, const charT* s, size_type n2)
 
   if (check_realloc (newlen))
     {
-      Rep *p = Rep::create (newlen);
+      Rep *p = new_rep (newlen);
       p->copy (0, data (), pos);
       p->copy (pos + n2, data () + pos + n1, len - (pos + n1));
       p->copy (pos, s, n2);
@@ -197,7 +197,7 @@ replace (size_type pos, size_type n1, size_type n2, charT c)
 
   if (check_realloc (newlen))
     {
-      Rep *p = Rep::create (newlen);
+      Rep *p = new_rep (newlen);
       p->copy (0, data (), pos);
       p->copy (pos + n2, data () + pos + n1, len - (pos + n1));
       p->set  (pos, c, n2);
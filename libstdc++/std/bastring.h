@@ -38,6 +38,16 @@
 // NOTE : This does NOT conform to the draft standard and is likely to change
 #include <alloc.h>
 
+// In a threaded library the reference counts must be changed atomically,
+// since strings that share a representation may be used in different
+// threads.
+#ifdef __STL_PTHREADS
+#include <std/atomicity.h>
+#ifdef __HAVE_ATOMICITY
+#define __STRING_ATOMIC_REFCOUNT
+#endif
+#endif
+
 extern "C++" {
 class istream; class ostream;
 
@@ -67,13 +77,25 @@ class basic_string
 {
 private:
   struct Rep {
+#ifdef __STRING_ATOMIC_REFCOUNT
+    size_t len, res;
+    _Atomic_word ref;
+#else
     size_t len, res, ref;
+#endif
     bool selfish;
 
     charT* data () { return reinterpret_cast<charT *>(this + 1); }
     charT& operator[] (size_t s) { return data () [s]; }
+#ifdef __STRING_ATOMIC_REFCOUNT
+    charT* grab ()
+      { if (selfish) return clone (); __atomic_add (&ref, 1); return data (); }
+    void release ()
+      { if (__exchange_and_add (&ref, -1) == 1) delete this; }
+#else
     charT* grab () { if (selfish) return clone (); ++ref; return data (); }
     void release () { if (--ref == 0) delete this; }
+#endif
 
     inline static void * operator new (size_t, size_t);
     inline static void operator delete (void *);
@@ -111,7 +133,47 @@ public:
 
 private:
   Rep *rep () const { return reinterpret_cast<Rep *>(dat) - 1; }
-  void repup (Rep *p) { rep ()->release (); dat = p->data (); }
+  void repup (Rep *p) { release_rep (); dat = p->data (); }
+
+#ifdef __STRING_SHORT_BUFFER
+  // A short string is kept in a Rep inside the string object itself, so
+  // making one allocates nothing and copying one touches no reference
+  // count.  The local Rep is never shared: copying a string that uses it
+  // copies the characters, and its reference count stays at 1.
+  bool is_local () const { return rep () == &local.rep; }
+  charT *empty_rep ()
+    {
+      local.rep.len = 0;
+      local.rep.res = local_size;
+      local.rep.ref = 1;
+      local.rep.selfish = false;
+      return local.rep.data ();
+    }
+  void release_rep () { if (! is_local ()) rep ()->release (); }
+  charT *share (const basic_string& str)
+    {
+      if (! str.is_local ())
+	return str.rep ()->grab ();
+      charT *d = empty_rep ();
+      local.rep.copy (0, str.data (), str.length ());
+      local.rep.len = str.length ();
+      return d;
+    }
+  Rep *new_rep (size_t n)
+    {
+      if (n < local_size && ! is_local ())
+	{
+	  empty_rep ();
+	  return &local.rep;
+	}
+      return Rep::create (n);
+    }
+#else
+  charT *empty_rep () { return nilRep.grab (); }
+  void release_rep () { rep ()->release (); }
+  charT *share (const basic_string& str) { return str.rep ()->grab (); }
+  Rep *new_rep (size_t n) { return Rep::create (n); }
+#endif
 
 public:
   const charT* data () const
@@ -130,32 +192,44 @@ public:
 // _lib.string.cons_ construct/copy/destroy:
   basic_string& operator= (const basic_string& str)
     {
-      if (&str != this) { rep ()->release (); dat = str.rep ()->grab (); }
+      if (&str != this) { release_rep (); dat = share (str); }
       return *this;
     }
 
-  explicit basic_string (): dat (nilRep.grab ()) { }
-  basic_string (const basic_string& str): dat (str.rep ()->grab ()) { }
+  explicit basic_string (): dat (empty_rep ()) { }
+  basic_string (const basic_string& str): dat (share (str)) { }
   basic_string (const basic_string& str, size_type pos, size_type n = npos)
-    : dat (nilRep.grab ()) { assign (str, pos, n); }
+    : dat (empty_rep ()) { assign (str, pos, n); }
   basic_string (const charT* s, size_type n)
-    : dat (nilRep.grab ()) { assign (s, n); }
+    : dat (empty_rep ()) { assign (s, n); }
   basic_string (const charT* s)
-    : dat (nilRep.grab ()) { assign (s); }
+    : dat (empty_rep ()) { assign (s); }
   basic_string (size_type n, charT c)
-    : dat (nilRep.grab ()) { assign (n, c); }
+    : dat (empty_rep ()) { assign (n, c); }
 #ifdef __STL_MEMBER_TEMPLATES
   template<class InputIterator>
     basic_string(InputIterator begin, InputIterator end)
 #else
   basic_string(const_iterator begin, const_iterator end)
 #endif
-    : dat (nilRep.grab ()) { assign (begin, end); }
+    : dat (empty_rep ()) { assign (begin, end); }
 
   ~basic_string ()
-    { rep ()->release (); }
+    { release_rep (); }
 
-  void swap (basic_string &s) { charT *d = dat; dat = s.dat; s.dat = d; }
+  void swap (basic_string &s)
+    {
+#ifdef __STRING_SHORT_BUFFER
+      if (is_local () || s.is_local ())
+	{
+	  basic_string tmp (*this);
+	  *this = s;
+	  s = tmp;
+	  return;
+	}
+#endif
+      charT *d = dat; dat = s.dat; s.dat = d;
+    }
 
   basic_string& append (const basic_string& str, size_type pos = 0,
 			size_type n = npos)
@@ -384,6 +458,16 @@ private:
 
   static Rep nilRep;
   charT *dat;
+
+#ifdef __STRING_SHORT_BUFFER
+  // The characters of the local Rep follow it directly, as they do in a
+  // Rep from create, so that rep () works the same for both.
+  enum { local_size = 16 / sizeof (charT) < 2 ? 2 : 16 / sizeof (charT) };
+  struct Local {
+    Rep rep;
+    charT buf[local_size];
+  } local;
+#endif
 };
 
 #ifdef __STL_MEMBER_TEMPLATES
@@ -409,7 +493,7 @@ replace (iterator i1, iterator i2, const_iterator j1, const_iterator j2)
 
   if (check_realloc (newlen))
     {
-      Rep *p = Rep::create (newlen);
+      Rep *p = new_rep (newlen);
       p->copy (0, data (), pos);
       p->copy (pos + n2, data () + pos + n1, len - (pos + n1));
       for (; j1 != j2; ++j1, ++pos)
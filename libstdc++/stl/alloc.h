@@ -30,6 +30,10 @@ using __STD::debug_alloc;
 using __STD::__default_alloc_template; 
 using __STD::alloc; 
 using __STD::single_client_alloc; 
+#ifdef __STL_PTHREADS
+using __STD::__thread_cache_alloc_template; 
+using __STD::thread_cache_alloc; 
+#endif /* __STL_PTHREADS */
 #ifdef __STL_STATIC_TEMPLATE_MEMBER_BUG
 using __STD::__malloc_alloc_oom_handler; 
 #endif /* __STL_STATIC_TEMPLATE_MEMBER_BUG */
@@ -0,0 +1,49 @@
+// Flat hash set for the -*- C++ -*- Standard Template Library.
+// Copyright (C) 1999 Free Software Foundation
+
+// This file is part of the GNU ANSI C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// As a special exception, if you link this library with files
+// compiled with a GNU compiler to produce an executable, this does not cause
+// the resulting executable to be covered by the GNU General Public License.
+// This exception does not however invalidate any other reasons why
+// the executable file might be covered by the GNU General Public License.
+
+#ifndef __SGI_STL_FLAT_HASH_SET_H
+#define __SGI_STL_FLAT_HASH_SET_H
+
+#ifndef __SGI_STL_INTERNAL_HASHTABLE_H
+#include <stl_hashtable.h>
+#endif 
+
+#ifndef __SGI_STL_INTERNAL_FLAT_HASHTABLE_H
+#include <stl_flat_hashtable.h>
+#endif 
+
+#include <stl_flat_hash_set.h>
+
+#ifdef __STL_USE_NAMESPACES
+using __STD::hash;
+using __STD::flat_hashtable;
+using __STD::flat_hash_set;
+#endif /* __STL_USE_NAMESPACES */
+
+
+#endif /* __SGI_STL_FLAT_HASH_SET_H */
+
+// Local Variables:
+// mode:C++
+// End:
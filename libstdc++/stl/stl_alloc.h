@@ -310,6 +310,10 @@ typedef malloc_alloc single_client_alloc;
   enum {__NFREELISTS = __MAX_BYTES/__ALIGN};
 #endif
 
+#ifdef __STL_PTHREADS
+template <bool threads, int inst> class __thread_cache_alloc_template;
+#endif
+
 template <bool threads, int inst>
 class __default_alloc_template {
 
@@ -346,6 +350,16 @@ private:
   // if it is inconvenient to allocate the requested number.
   static char *chunk_alloc(size_t size, int &nobjs);
 
+# ifdef __STL_PTHREADS
+    // Batch transfers for the per-thread caches.  take_batch returns a
+    // list of at most nobjs objects of size n, linked through
+    // free_list_link, and sets nobjs to its length; give_batch puts the
+    // list from first to last back.  n must be properly aligned.
+    friend class __thread_cache_alloc_template<threads, inst>;
+    static obj *take_batch(size_t n, int &nobjs);
+    static void give_batch(obj *first, obj *last, size_t n);
+# endif
+
   // Chunk allocation state.
   static char *start_free;
   static char *end_free;
@@ -437,7 +451,116 @@ public:
 
 } ;
 
+#ifdef __STL_PTHREADS
+// Thread-caching front end for the default node allocator.
+// Each thread keeps a short free list of its own for each object size,
+// and goes to the shared free lists of __default_alloc_template, under
+// its lock, only to move a batch of objects at a time: to fetch a batch
+// when its own list is empty, and to return one when its list grows
+// past __LIMIT.  Thus most allocations and deallocations take no lock
+// at all.  An object may be freed by a thread other than the one that
+// allocated it; it simply joins the freeing thread's list, and the bound
+// on that list sends it back to the shared lists in due course, so
+// unlike pthread_alloc this cannot leak storage into one thread.  The
+// lists of a thread are returned when it exits.
+// Define __STL_THREAD_CACHE_ALLOC to make this the default alloc.
+template <bool threads, int inst>
+class __thread_cache_alloc_template {
+
+private:
+  typedef __default_alloc_template<threads, inst> central;
+  typedef typename central::obj obj;
+
+  // These must agree with __default_alloc_template.
+  enum {__ALIGN = 8};
+  enum {__MAX_BYTES = 128};
+  enum {__NFREELISTS = __MAX_BYTES/__ALIGN};
+  // Objects moved to or from the shared lists at a time, and the most a
+  // thread keeps for one size.
+  enum {__BATCH = 32};
+  enum {__LIMIT = 2 * __BATCH};
+
+  struct cache {
+    obj *free_list[__NFREELISTS];
+    int count[__NFREELISTS];
+  };
+
+  static pthread_key_t key;
+  static bool key_initialized;
+  static cache *get_cache();
+	// Return the calling thread's cache, making one if need be.
+  static void destructor(void *instance);
+	// Called on thread exit to return the thread's lists.
+
+public:
+
+  /* n must be > 0      */
+  static void * allocate(size_t n)
+  {
+    cache *c;
+    obj *result;
+    size_t i;
+
+    if (n > (size_t) __MAX_BYTES) {
+        return(malloc_alloc::allocate(n));
+    }
+    if (!key_initialized || !(c = (cache *)pthread_getspecific(key))) {
+        c = get_cache();
+    }
+    i = central::FREELIST_INDEX(n);
+    result = c -> free_list[i];
+    if (result == 0) {
+        int nobjs = __BATCH;
+        result = central::take_batch(central::ROUND_UP(n), nobjs);
+        c -> count[i] = nobjs;
+    }
+    c -> free_list[i] = result -> free_list_link;
+    --c -> count[i];
+    return (result);
+  };
+
+  /* p may not be 0 */
+  static void deallocate(void *p, size_t n)
+  {
+    obj *q = (obj *)p;
+    cache *c;
+    size_t i;
+
+    if (n > (size_t) __MAX_BYTES) {
+        malloc_alloc::deallocate(p, n);
+        return;
+    }
+    if (!key_initialized || !(c = (cache *)pthread_getspecific(key))) {
+        c = get_cache();
+    }
+    i = central::FREELIST_INDEX(n);
+    q -> free_list_link = c -> free_list[i];
+    c -> free_list[i] = q;
+    if (++c -> count[i] > __LIMIT) {
+        // Give the most recently freed batch back, keeping the rest.
+        obj *last = q;
+        int j;
+
+        for (j = 1; j < __BATCH; j++)
+          last = last -> free_list_link;
+        c -> free_list[i] = last -> free_list_link;
+        c -> count[i] -= __BATCH;
+        central::give_batch(q, last, central::ROUND_UP(n));
+    }
+  }
+
+  static void * reallocate(void *p, size_t old_sz, size_t new_sz);
+
+} ;
+
+typedef __thread_cache_alloc_template<true, 0> thread_cache_alloc;
+#endif /* __STL_PTHREADS */
+
+#if defined(__STL_THREAD_CACHE_ALLOC) && defined(__STL_PTHREADS)
+typedef __thread_cache_alloc_template<__NODE_ALLOCATOR_THREADS, 0> alloc;
+#else
 typedef __default_alloc_template<__NODE_ALLOCATOR_THREADS, 0> alloc;
+#endif
 typedef __default_alloc_template<false, 0> single_client_alloc;
 
 
@@ -538,6 +661,123 @@ void* __default_alloc_template<threads, inst>::refill(size_t n)
     return(result);
 }
 
+#ifdef __STL_PTHREADS
+/* Returns a list of at most nobjs objects of size n from the size n   */
+/* free list, or from a new chunk if that list is empty.               */
+template <bool threads, int inst>
+typename __default_alloc_template<threads, inst>::obj *
+__default_alloc_template<threads, inst>::take_batch(size_t n, int& nobjs)
+{
+    obj * __VOLATILE * my_free_list = free_list + FREELIST_INDEX(n);
+    obj * result;
+    obj * last;
+    int i;
+    /*REFERENCED*/
+    lock lock_instance;
+
+    result = *my_free_list;
+    if (result == 0) {
+        char * chunk = chunk_alloc(n, nobjs);
+
+        /* Link up the objects in the chunk. */
+        result = last = (obj *)chunk;
+        for (i = 1; i < nobjs; i++) {
+            last -> free_list_link = (obj *)(chunk + i * n);
+            last = last -> free_list_link;
+        }
+        last -> free_list_link = 0;
+        return(result);
+    }
+    last = result;
+    for (i = 1; i < nobjs && last -> free_list_link != 0; i++)
+        last = last -> free_list_link;
+    *my_free_list = last -> free_list_link;
+    last -> free_list_link = 0;
+    nobjs = i;
+    return(result);
+}
+
+template <bool threads, int inst>
+void
+__default_alloc_template<threads, inst>::give_batch(obj *first, obj *last,
+                                                     size_t n)
+{
+    obj * __VOLATILE * my_free_list = free_list + FREELIST_INDEX(n);
+    /*REFERENCED*/
+    lock lock_instance;
+
+    last -> free_list_link = *my_free_list;
+    *my_free_list = first;
+}
+
+template <bool threads, int inst>
+typename __thread_cache_alloc_template<threads, inst>::cache *
+__thread_cache_alloc_template<threads, inst>::get_cache()
+{
+    cache * result;
+
+    if (!key_initialized) {
+        /*REFERENCED*/
+        typename central::lock lock_instance;
+        if (!key_initialized) {
+            if (pthread_key_create(&key, destructor)) {
+                abort();  // failed
+            }
+            key_initialized = true;
+        }
+    }
+    result = (cache *)malloc_alloc::allocate(sizeof(cache));
+    memset((void *)result, 0, sizeof(cache));
+    if (pthread_setspecific(key, result)) abort();
+    return result;
+}
+
+template <bool threads, int inst>
+void
+__thread_cache_alloc_template<threads, inst>::destructor(void *instance)
+{
+    cache * c = (cache *)instance;
+    size_t i;
+
+    for (i = 0; i < __NFREELISTS; i++) {
+        obj * first = c -> free_list[i];
+        obj * last = first;
+
+        if (first == 0) continue;
+        while (last -> free_list_link != 0)
+            last = last -> free_list_link;
+        central::give_batch(first, last, (i + 1) * __ALIGN);
+    }
+    malloc_alloc::deallocate(c, sizeof(cache));
+}
+
+template <bool threads, int inst>
+void*
+__thread_cache_alloc_template<threads, inst>::reallocate(void *p,
+                                                         size_t old_sz,
+                                                         size_t new_sz)
+{
+    void * result;
+    size_t copy_sz;
+
+    if (old_sz > (size_t) __MAX_BYTES && new_sz > (size_t) __MAX_BYTES) {
+        return(realloc(p, new_sz));
+    }
+    if (central::ROUND_UP(old_sz) == central::ROUND_UP(new_sz)) return(p);
+    result = allocate(new_sz);
+    copy_sz = new_sz > old_sz? old_sz : new_sz;
+    memcpy(result, p, copy_sz);
+    deallocate(p, old_sz);
+    return(result);
+}
+
+template <bool threads, int inst>
+pthread_key_t __thread_cache_alloc_template<threads, inst>::key;
+
+template <bool threads, int inst>
+bool __thread_cache_alloc_template<threads, inst>::key_initialized = false;
+#endif /* __STL_PTHREADS */
+
 template <bool threads, int inst>
 void*
 __default_alloc_template<threads, inst>::reallocate(void *p,
@@ -0,0 +1,642 @@
+// Open addressing hash table for the -*- C++ -*- flat hashed containers.
+// Copyright (C) 1999 Free Software Foundation
+
+// This file is part of the GNU ANSI C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 2, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this library; see the file COPYING.  If not, write to the Free
+// Software Foundation, 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+// As a special exception, if you link this library with files
+// compiled with a GNU compiler to produce an executable, this does not cause
+// the resulting executable to be covered by the GNU General Public License.
+// This exception does not however invalidate any other reasons why
+// the executable file might be covered by the GNU General Public License.
+
+/* NOTE: This is an internal header file, included by other STL headers.
+ *   You should not attempt to use it directly.
+ */
+
+#ifndef __SGI_STL_INTERNAL_FLAT_HASHTABLE_H
+#define __SGI_STL_INTERNAL_FLAT_HASHTABLE_H
+
+// Flat_hashtable class, used to implement flat_hash_set and flat_hash_map.
+// It takes the same parameters as hashtable and has much the same
+// interface, but keeps the elements themselves in one array of slots
+// instead of in a node per element, and resolves collisions by linear
+// probing.  An insert therefore allocates nothing unless the table has to
+// grow, and a lookup touches consecutive slots instead of following
+// pointers.  The price is that an insert that makes the table grow moves
+// every element, so it invalidates all iterators and pointers into the
+// table.  Erasing an element leaves a marker in its slot so that other
+// elements stay where they are; the markers are reused by later inserts
+// and dropped when the table is rebuilt.  Only unique keys are supported.
+
+__STL_BEGIN_NAMESPACE
+
+template <class Value, class Key, class HashFcn,
+          class ExtractKey, class EqualKey, class Alloc = alloc>
+class flat_hashtable;
+
+template <class Value, class Key, class HashFcn,
+          class ExtractKey, class EqualKey, class Alloc>
+struct __flat_hashtable_iterator;
+
+template <class Value, class Key, class HashFcn,
+          class ExtractKey, class EqualKey, class Alloc>
+struct __flat_hashtable_const_iterator;
+
+template <class Value, class Key, class HashFcn,
+          class ExtractKey, class EqualKey, class Alloc>
+struct __flat_hashtable_iterator {
+  typedef flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc>
+          hashtable;
+  typedef __flat_hashtable_iterator<Value, Key, HashFcn,
+                                    ExtractKey, EqualKey, Alloc>
+          iterator;
+  typedef __flat_hashtable_const_iterator<Value, Key, HashFcn,
+                                          ExtractKey, EqualKey, Alloc>
+          const_iterator;
+
+  typedef forward_iterator_tag iterator_category;
+  typedef Value value_type;
+  typedef ptrdiff_t difference_type;
+  typedef size_t size_type;
+  typedef Value& reference;
+  typedef Value* pointer;
+
+  size_type pos;
+  hashtable* ht;
+
+  __flat_hashtable_iterator(size_type n, hashtable* tab) : pos(n), ht(tab) {}
+  __flat_hashtable_iterator() {}
+  reference operator*() const { return ht->slots[pos]; }
+#ifndef __SGI_STL_NO_ARROW_OPERATOR
+  pointer operator->() const { return &(operator*()); }
+#endif /* __SGI_STL_NO_ARROW_OPERATOR */
+  iterator& operator++() { pos = ht->next_full(pos + 1); return *this; }
+  iterator operator++(int)
+  {
+    iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  bool operator==(const iterator& it) const { return pos == it.pos; }
+  bool operator!=(const iterator& it) const { return pos != it.pos; }
+};
+
+
+template <class Value, class Key, class HashFcn,
+          class ExtractKey, class EqualKey, class Alloc>
+struct __flat_hashtable_const_iterator {
+  typedef flat_hashtable<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc>
+          hashtable;
+  typedef __flat_hashtable_iterator<Value, Key, HashFcn,
+                                    ExtractKey, EqualKey, Alloc>
+          iterator;
+  typedef __flat_hashtable_const_iterator<Value, Key, HashFcn,
+                                          ExtractKey, EqualKey, Alloc>
+          const_iterator;
+
+  typedef forward_iterator_tag iterator_category;
+  typedef Value value_type;
+  typedef ptrdiff_t difference_type;
+  typedef size_t size_type;
+  typedef const Value& reference;
+  typedef const Value* pointer;
+
+  size_type pos;
+  const hashtable* ht;
+
+  __flat_hashtable_const_iterator(size_type n, const hashtable* tab)
+    : pos(n), ht(tab) {}
+  __flat_hashtable_const_iterator() {}
+  __flat_hashtable_const_iterator(const iterator& it)
+    : pos(it.pos), ht(it.ht) {}
+  reference operator*() const { return ht->slots[pos]; }
+#ifndef __SGI_STL_NO_ARROW_OPERATOR
+  pointer operator->() const { return &(operator*()); }
+#endif /* __SGI_STL_NO_ARROW_OPERATOR */
+  const_iterator& operator++() { pos = ht->next_full(pos + 1); return *this; }
+  const_iterator operator++(int)
+  {
+    const_iterator tmp = *this;
+    ++*this;
+    return tmp;
+  }
+  bool operator==(const const_iterator& it) const { return pos == it.pos; }
+  bool operator!=(const const_iterator& it) const { return pos != it.pos; }
+};
+
+
+template <class Value, class Key, class HashFcn,
+          class ExtractKey, class EqualKey,
+          class Alloc>
+class flat_hashtable {
+public:
+  typedef Key key_type;
+  typedef Value value_type;
+  typedef HashFcn hasher;
+  typedef EqualKey key_equal;
+
+  typedef size_t            size_type;
+  typedef ptrdiff_t         difference_type;
+  typedef value_type*       pointer;
+  typedef const value_type* const_pointer;
+  typedef value_type&       reference;
+  typedef const value_type& const_reference;
+
+  hasher hash_funct() const { return hash; }
+  key_equal key_eq() const { return equals; }
+
+private:
+  hasher hash;
+  key_equal equals;
+  ExtractKey get_key;
+
+  typedef simple_alloc<value_type, Alloc> slot_allocator;
+  typedef simple_alloc<char, Alloc> state_allocator;
+
+  // What is in each slot.  A deleted slot holds no element, but a probe
+  // must go on past it.
+  enum { empty_slot = 0, full_slot = 1, deleted_slot = 2 };
+
+  value_type* slots;
+  char* states;
+  size_type num_slots;
+  size_type num_elements;
+  size_type num_deleted;
+
+public:
+  typedef __flat_hashtable_iterator<Value, Key, HashFcn, ExtractKey,
+                                    EqualKey, Alloc>
+  iterator;
+
+  typedef __flat_hashtable_const_iterator<Value, Key, HashFcn, ExtractKey,
+                                          EqualKey, Alloc>
+  const_iterator;
+
+  friend struct
+  __flat_hashtable_iterator<Value, Key, HashFcn, ExtractKey, EqualKey, Alloc>;
+  friend struct
+  __flat_hashtable_const_iterator<Value, Key, HashFcn, ExtractKey, EqualKey,
+                                  Alloc>;
+
+public:
+  flat_hashtable(size_type n,
+                 const HashFcn&    hf,
+                 const EqualKey&   eql,
+                 const ExtractKey& ext)
+    : hash(hf), equals(eql), get_key(ext)
+  {
+    initialize_slots(n);
+  }
+
+  flat_hashtable(size_type n,
+                 const HashFcn&    hf,
+                 const EqualKey&   eql)
+    : hash(hf), equals(eql), get_key(ExtractKey())
+  {
+    initialize_slots(n);
+  }
+
+  flat_hashtable(const flat_hashtable& ht)
+    : hash(ht.hash), equals(ht.equals), get_key(ht.get_key),
+      slots(0), states(0), num_slots(0), num_elements(0), num_deleted(0)
+  {
+    copy_from(ht);
+  }
+
+  flat_hashtable& operator= (const flat_hashtable& ht)
+  {
+    if (&ht != this) {
+      clear();
+      free_slots();
+      hash = ht.hash;
+      equals = ht.equals;
+      get_key = ht.get_key;
+      copy_from(ht);
+    }
+    return *this;
+  }
+
+  ~flat_hashtable() { clear(); free_slots(); }
+
+  size_type size() const { return num_elements; }
+  size_type max_size() const { return size_type(-1); }
+  bool empty() const { return size() == 0; }
+
+  void swap(flat_hashtable& ht)
+  {
+    __STD::swap(hash, ht.hash);
+    __STD::swap(equals, ht.equals);
+    __STD::swap(get_key, ht.get_key);
+    __STD::swap(slots, ht.slots);
+    __STD::swap(states, ht.states);
+    __STD::swap(num_slots, ht.num_slots);
+    __STD::swap(num_elements, ht.num_elements);
+    __STD::swap(num_deleted, ht.num_deleted);
+  }
+
+  iterator begin() { return iterator(next_full(0), this); }
+  iterator end() { return iterator(num_slots, this); }
+  const_iterator begin() const { return const_iterator(next_full(0), this); }
+  const_iterator end() const { return const_iterator(num_slots, this); }
+
+  friend bool
+  operator== __STL_NULL_TMPL_ARGS (const flat_hashtable&,
+                                   const flat_hashtable&);
+
+public:
+
+  // Each slot counts as a bucket that holds at most one element.
+  size_type bucket_count() const { return num_slots; }
+
+  size_type max_bucket_count() const
+    { return __stl_prime_list[__stl_num_primes - 1]; }
+
+  size_type elems_in_bucket(size_type bucket) const
+  {
+    return states[bucket] == full_slot ? 1 : 0;
+  }
+
+  pair<iterator, bool> insert_unique(const value_type& obj)
+  {
+    make_room(1);
+    return insert_unique_noresize(obj);
+  }
+
+  pair<iterator, bool> insert_unique_noresize(const value_type& obj);
+
+#ifdef __STL_MEMBER_TEMPLATES
+  template <class InputIterator>
+  void insert_unique(InputIterator f, InputIterator l)
+  {
+    insert_unique(f, l, iterator_category(f));
+  }
+
+  template <class InputIterator>
+  void insert_unique(InputIterator f, InputIterator l,
+                     input_iterator_tag)
+  {
+    for ( ; f != l; ++f)
+      insert_unique(*f);
+  }
+
+  template <class ForwardIterator>
+  void insert_unique(ForwardIterator f, ForwardIterator l,
+                     forward_iterator_tag)
+  {
+    size_type n = 0;
+    distance(f, l, n);
+    make_room(n);
+    for ( ; n > 0; --n, ++f)
+      insert_unique_noresize(*f);
+  }
+
+#else /* __STL_MEMBER_TEMPLATES */
+  void insert_unique(const value_type* f, const value_type* l)
+  {
+    size_type n = l - f;
+    make_room(n);
+    for ( ; n > 0; --n, ++f)
+      insert_unique_noresize(*f);
+  }
+
+  void insert_unique(const_iterator f, const_iterator l)
+  {
+    size_type n = 0;
+    distance(f, l, n);
+    make_room(n);
+    for ( ; n > 0; --n, ++f)
+      insert_unique_noresize(*f);
+  }
+#endif /*__STL_MEMBER_TEMPLATES */
+
+  reference find_or_insert(const value_type& obj);
+
+  iterator find(const key_type& key)
+  {
+    return iterator(find_pos(key), this);
+  }
+
+  const_iterator find(const key_type& key) const
+  {
+    return const_iterator(find_pos(key), this);
+  }
+
+  size_type count(const key_type& key) const
+  {
+    return find_pos(key) == num_slots ? 0 : 1;
+  }
+
+  pair<iterator, iterator> equal_range(const key_type& key)
+  {
+    typedef pair<iterator, iterator> pii;
+    const size_type n = find_pos(key);
+    if (n == num_slots)
+      return pii(end(), end());
+    return pii(iterator(n, this), iterator(next_full(n + 1), this));
+  }
+
+  pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+  {
+    typedef pair<const_iterator, const_iterator> pii;
+    const size_type n = find_pos(key);
+    if (n == num_slots)
+      return pii(end(), end());
+    return pii(const_iterator(n, this),
+               const_iterator(next_full(n + 1), this));
+  }
+
+  size_type erase(const key_type& key)
+  {
+    const size_type n = find_pos(key);
+    if (n == num_slots)
+      return 0;
+    erase_slot(n);
+    return 1;
+  }
+
+  void erase(const iterator& it) { erase_slot(it.pos); }
+  void erase(iterator first, iterator last)
+  {
+    for ( ; first.pos < last.pos; ++first.pos)
+      if (states[first.pos] == full_slot)
+        erase_slot(first.pos);
+  }
+
+  void erase(const const_iterator& it) { erase_slot(it.pos); }
+  void erase(const_iterator first, const_iterator last)
+  {
+    erase(iterator(first.pos, this), iterator(last.pos, this));
+  }
+
+  void resize(size_type num_elements_hint);
+  void clear();
+
+private:
+  size_type next_size(size_type n) const { return __stl_next_prime(n); }
+
+  // The number of slots needed to hold n elements without letting the
+  // table get more than three quarters full.
+  static size_type slots_for(size_type n) { return n + n / 3 + 1; }
+
+  void initialize_slots(size_type n)
+  {
+    num_slots = next_size(slots_for(n));
+    slots = slot_allocator::allocate(num_slots);
+    states = state_allocator::allocate(num_slots);
+    memset(states, empty_slot, num_slots);
+    num_elements = 0;
+    num_deleted = 0;
+  }
+
+  void free_slots()
+  {
+    if (num_slots) {
+      slot_allocator::deallocate(slots, num_slots);
+      state_allocator::deallocate(states, num_slots);
+    }
+    slots = 0;
+    states = 0;
+    num_slots = 0;
+  }
+
+  // Make sure that n more elements can go in without the table getting
+  // too full, counting deleted slots as full since a probe cannot stop
+  // at them.
+  void make_room(size_type n)
+  {
+    if (slots_for(num_elements + num_deleted + n) > num_slots)
+      rehash(next_size(slots_for(2 * (num_elements + n))));
+  }
+
+  size_type next_slot(size_type n) const
+  {
+    return n + 1 == num_slots ? 0 : n + 1;
+  }
+
+  // The first full slot at n or after it, or num_slots if there is none.
+  size_type next_full(size_type n) const
+  {
+    while (n < num_slots && states[n] != full_slot)
+      ++n;
+    return n;
+  }
+
+  // The slot holding key, or num_slots if there is none.  There is
+  // always at least one empty slot, which ends the search.
+  size_type find_pos(const key_type& key) const
+  {
+    size_type n = hash(key) % num_slots;
+    for (;;) {
+      if (states[n] == empty_slot)
+        return num_slots;
+      if (states[n] == full_slot && equals(get_key(slots[n]), key))
+        return n;
+      n = next_slot(n);
+    }
+  }
+
+  void erase_slot(size_type n);
+  void rehash(size_type n);
+  void copy_from(const flat_hashtable& ht);
+
+};
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+bool operator==(const flat_hashtable<V, K, HF, Ex, Eq, A>& ht1,
+                const flat_hashtable<V, K, HF, Ex, Eq, A>& ht2)
+{
+  typedef typename flat_hashtable<V, K, HF, Ex, Eq, A>::size_type size_type;
+  if (ht1.num_elements != ht2.num_elements)
+    return false;
+  for (size_type n = ht1.next_full(0); n < ht1.num_slots;
+       n = ht1.next_full(n + 1)) {
+    size_type m = ht2.find_pos(ht1.get_key(ht1.slots[n]));
+    if (m == ht2.num_slots || !(ht1.slots[n] == ht2.slots[m]))
+      return false;
+  }
+  return true;
+}
+
+#ifdef __STL_FUNCTION_TMPL_PARTIAL_ORDER
+
+template <class Val, class Key, class HF, class Extract, class EqKey, class A>
+inline void swap(flat_hashtable<Val, Key, HF, Extract, EqKey, A>& ht1,
+                 flat_hashtable<Val, Key, HF, Extract, EqKey, A>& ht2) {
+  ht1.swap(ht2);
+}
+
+#endif /* __STL_FUNCTION_TMPL_PARTIAL_ORDER */
+
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+pair<typename flat_hashtable<V, K, HF, Ex, Eq, A>::iterator, bool>
+flat_hashtable<V, K, HF, Ex, Eq, A>::insert_unique_noresize(const value_type& obj)
+{
+  // Even without a resize there must be an empty slot left afterwards.
+  if (num_elements + num_deleted + 1 >= num_slots)
+    make_room(1);
+
+  size_type n = hash(get_key(obj)) % num_slots;
+  size_type free_slot = num_slots;
+
+  for ( ; states[n] != empty_slot; n = next_slot(n)) {
+    if (states[n] == full_slot) {
+      if (equals(get_key(slots[n]), get_key(obj)))
+        return pair<iterator, bool>(iterator(n, this), false);
+    }
+    else if (free_slot == num_slots)
+      free_slot = n;
+  }
+
+  // Reuse the first deleted slot on the way, if there was one.
+  if (free_slot != num_slots) {
+    n = free_slot;
+    --num_deleted;
+  }
+  construct(&slots[n], obj);
+  states[n] = full_slot;
+  ++num_elements;
+  return pair<iterator, bool>(iterator(n, this), true);
+}
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+typename flat_hashtable<V, K, HF, Ex, Eq, A>::reference
+flat_hashtable<V, K, HF, Ex, Eq, A>::find_or_insert(const value_type& obj)
+{
+  size_type n = find_pos(get_key(obj));
+  if (n != num_slots)
+    return slots[n];
+  make_room(1);
+  return *insert_unique_noresize(obj).first;
+}
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void flat_hashtable<V, K, HF, Ex, Eq, A>::erase_slot(size_type n)
+{
+  destroy(&slots[n]);
+  states[n] = deleted_slot;
+  --num_elements;
+  ++num_deleted;
+
+  // If the next slot is empty, no probe goes on past this one, so it and
+  // any deleted slots just before it can be made empty again.
+  if (states[next_slot(n)] == empty_slot)
+    while (states[n] == deleted_slot) {
+      states[n] = empty_slot;
+      --num_deleted;
+      n = n == 0 ? num_slots - 1 : n - 1;
+    }
+}
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void flat_hashtable<V, K, HF, Ex, Eq, A>::resize(size_type num_elements_hint)
+{
+  if (slots_for(num_elements_hint) > num_slots)
+    rehash(next_size(slots_for(num_elements_hint)));
+}
+
+// Move the elements into a table of n slots, dropping the deleted slots.
+// If copying an element throws, the table is left as it was.
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void flat_hashtable<V, K, HF, Ex, Eq, A>::rehash(size_type n)
+{
+  value_type* new_slots = slot_allocator::allocate(n);
+  char* new_states;
+  size_type i;
+
+  __STL_TRY {
+    new_states = state_allocator::allocate(n);
+  }
+  __STL_UNWIND(slot_allocator::deallocate(new_slots, n));
+  memset(new_states, empty_slot, n);
+
+  __STL_TRY {
+    for (i = 0; i < num_slots; ++i)
+      if (states[i] == full_slot) {
+        size_type j = hash(get_key(slots[i])) % n;
+        while (new_states[j] != empty_slot)
+          j = j + 1 == n ? 0 : j + 1;
+        construct(&new_slots[j], slots[i]);
+        new_states[j] = full_slot;
+      }
+  }
+#         ifdef __STL_USE_EXCEPTIONS
+  catch(...) {
+    for (i = 0; i < n; ++i)
+      if (new_states[i] == full_slot)
+        destroy(&new_slots[i]);
+    slot_allocator::deallocate(new_slots, n);
+    state_allocator::deallocate(new_states, n);
+    throw;
+  }
+#         endif /* __STL_USE_EXCEPTIONS */
+
+  clear();
+  free_slots();
+  slots = new_slots;
+  states = new_states;
+  num_slots = n;
+  for (i = 0; i < n; ++i)
+    if (states[i] == full_slot)
+      ++num_elements;
+}
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void flat_hashtable<V, K, HF, Ex, Eq, A>::clear()
+{
+  for (size_type i = 0; i < num_slots; ++i) {
+    if (states[i] == full_slot)
+      destroy(&slots[i]);
+    states[i] = empty_slot;
+  }
+  num_elements = 0;
+  num_deleted = 0;
+}
+
+
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void flat_hashtable<V, K, HF, Ex, Eq, A>::copy_from(const flat_hashtable& ht)
+{
+  slots = slot_allocator::allocate(ht.num_slots);
+  __STL_TRY {
+    states = state_allocator::allocate(ht.num_slots);
+  }
+  __STL_UNWIND((slot_allocator::deallocate(slots, ht.num_slots), slots = 0));
+  num_slots = ht.num_slots;
+  num_elements = 0;
+  num_deleted = 0;
+  memset(states, empty_slot, num_slots);
+  __STL_TRY {
+    for (size_type i = 0; i < num_slots; ++i)
+      if (ht.states[i] == full_slot) {
+        construct(&slots[i], ht.slots[i]);
+        states[i] = full_slot;
+        ++num_elements;
+      }
+      else
+        states[i] = ht.states[i];
+    num_deleted = ht.num_deleted;
+  }
+  __STL_UNWIND((clear(), free_slots()));
+}
+
+__STL_END_NAMESPACE
+
+#endif /* __SGI_STL_INTERNAL_FLAT_HASHTABLE_H */
+
+// Local Variables:
+// mode:C++
+// End:
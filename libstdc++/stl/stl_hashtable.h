@@ -34,6 +34,18 @@
 // Hashtable class, used to implement the hashed associative containers
 // hash_set, hash_map, hash_multiset, and hash_multimap.
 
+// Two options change how the table works inside, without changing its
+// interface.  Define __STL_HASHTABLE_CACHE_HASH to keep each element's
+// hash code in its node, so that growing the table and stepping an
+// iterator never call the hash function, and most unequal keys in a
+// bucket are rejected without calling the equality function.  Define
+// __STL_HASHTABLE_INCREMENTAL_RESIZE to have an insert that makes the
+// table grow move the elements into the new buckets a few old buckets at
+// a time over the following inserts, instead of all at once; until they
+// are all moved, an element lives in the new buckets if its old bucket
+// has been emptied and in its old bucket otherwise.  An explicit resize
+// still rehashes everything at once.
+
 #include <stl_algobase.h>
 #include <stl_alloc.h>
 #include <stl_construct.h>
@@ -50,6 +62,9 @@ template <class Value>
 struct __hashtable_node
 {
   __hashtable_node* next;
+#ifdef __STL_HASHTABLE_CACHE_HASH
+  size_t hash_code;
+#endif
   Value val;
 };  
 
@@ -158,6 +173,13 @@ inline unsigned long __stl_next_prime(unsigned long n)
   return pos == last ? *(last - 1) : *pos;
 }
 
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+// Number of old buckets emptied by each insert while an incremental resize
+// is going on.  The next resize is at least as many inserts away as there
+// are old buckets, so any value of 1 or more finishes in time.
+static const int __stl_rehash_step = 2;
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
+
 
 template <class Value, class Key, class HashFcn,
           class ExtractKey, class EqualKey,
@@ -188,6 +210,15 @@ private:
   typedef simple_alloc<node, Alloc> node_allocator;
 
   vector<node*,Alloc> buckets;
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+  // The buckets an incremental resize is moving elements out of, and the
+  // first of them that has not been emptied yet.  old_buckets is empty
+  // and rehash_pos zero when no resize is going on.  Both sets of buckets
+  // together are indexed by a position: positions below old_buckets.size()
+  // are old buckets, and the ones above are the current buckets.
+  vector<node*,Alloc> old_buckets;
+  size_type rehash_pos;
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
   size_type num_elements;
 
 public:
@@ -252,25 +283,20 @@ public:
     __STD::swap(equals, ht.equals);
     __STD::swap(get_key, ht.get_key);
     buckets.swap(ht.buckets);
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+    old_buckets.swap(ht.old_buckets);
+    __STD::swap(rehash_pos, ht.rehash_pos);
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
     __STD::swap(num_elements, ht.num_elements);
   }
 
-  iterator begin()
-  { 
-    for (size_type n = 0; n < buckets.size(); ++n)
-      if (buckets[n])
-        return iterator(buckets[n], this);
-    return end();
-  }
+  iterator begin() { return iterator(first_from(0), this); }
 
   iterator end() { return iterator(0, this); }
 
   const_iterator begin() const
   {
-    for (size_type n = 0; n < buckets.size(); ++n)
-      if (buckets[n])
-        return const_iterator(buckets[n], this);
-    return end();
+    return const_iterator(first_from(0), this);
   }
 
   const_iterator end() const { return const_iterator(0, this); }
@@ -290,18 +316,25 @@ public:
     size_type result = 0;
     for (node* cur = buckets[bucket]; cur; cur = cur->next)
       result += 1;
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+    // Count the elements that are still to be moved into this bucket.
+    for (size_type pos = rehash_pos; pos < old_buckets.size(); ++pos)
+      for (node* cur = old_buckets[pos]; cur; cur = cur->next)
+        if (node_hash(cur) % buckets.size() == bucket)
+          result += 1;
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
     return result;
   }
 
   pair<iterator, bool> insert_unique(const value_type& obj)
   {
-    resize(num_elements + 1);
+    grow(num_elements + 1);
     return insert_unique_noresize(obj);
   }
 
   iterator insert_equal(const value_type& obj)
   {
-    resize(num_elements + 1);
+    grow(num_elements + 1);
     return insert_equal_noresize(obj);
   }
 
@@ -399,10 +432,10 @@ public:
 
   iterator find(const key_type& key) 
   {
-    size_type n = bkt_num_key(key);
+    const size_type h = hash(key);
     node* first;
-    for ( first = buckets[n];
-          first && !equals(get_key(first->val), key);
+    for ( first = chain(hash_pos(h));
+          first && !node_has_key(first, h, key);
           first = first->next)
       {}
     return iterator(first, this);
@@ -410,10 +443,10 @@ public:
 
   const_iterator find(const key_type& key) const
   {
-    size_type n = bkt_num_key(key);
+    const size_type h = hash(key);
     const node* first;
-    for ( first = buckets[n];
-          first && !equals(get_key(first->val), key);
+    for ( first = chain(hash_pos(h));
+          first && !node_has_key(first, h, key);
           first = first->next)
       {}
     return const_iterator(first, this);
@@ -421,11 +454,11 @@ public:
 
   size_type count(const key_type& key) const
   {
-    const size_type n = bkt_num_key(key);
+    const size_type h = hash(key);
     size_type result = 0;
 
-    for (const node* cur = buckets[n]; cur; cur = cur->next)
-      if (equals(get_key(cur->val), key))
+    for (const node* cur = chain(hash_pos(h)); cur; cur = cur->next)
+      if (node_has_key(cur, h, key))
         ++result;
     return result;
   }
@@ -451,28 +484,96 @@ private:
     const size_type n_buckets = next_size(n);
     buckets.reserve(n_buckets);
     buckets.insert(buckets.end(), n_buckets, (node*) 0);
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+    rehash_pos = 0;
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
     num_elements = 0;
   }
 
-  size_type bkt_num_key(const key_type& key) const
+#ifdef __STL_HASHTABLE_CACHE_HASH
+  size_type node_hash(const node* n) const { return n->hash_code; }
+  void set_node_hash(node* n, size_type h) { n->hash_code = h; }
+  void copy_node_hash(node* to, const node* from)
+    { to->hash_code = from->hash_code; }
+
+  bool node_has_key(const node* n, size_type h, const key_type& key) const
+  {
+    return n->hash_code == h && equals(get_key(n->val), key);
+  }
+#else /* __STL_HASHTABLE_CACHE_HASH */
+  size_type node_hash(const node* n) const { return hash(get_key(n->val)); }
+  void set_node_hash(node*, size_type) {}
+  void copy_node_hash(node*, const node*) {}
+
+  bool node_has_key(const node* n, size_type, const key_type& key) const
+  {
+    return equals(get_key(n->val), key);
+  }
+#endif /* __STL_HASHTABLE_CACHE_HASH */
+
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+  // The chain of elements at bucket position pos.
+  node*& chain(size_type pos)
   {
-    return bkt_num_key(key, buckets.size());
+    return pos < old_buckets.size() ? old_buckets[pos]
+                                    : buckets[pos - old_buckets.size()];
   }
 
-  size_type bkt_num(const value_type& obj) const
+  node* chain(size_type pos) const
   {
-    return bkt_num_key(get_key(obj));
+    return pos < old_buckets.size() ? old_buckets[pos]
+                                    : buckets[pos - old_buckets.size()];
   }
 
-  size_type bkt_num_key(const key_type& key, size_t n) const
+  size_type end_pos() const { return old_buckets.size() + buckets.size(); }
+
+  // The bucket position of elements with hash code h.
+  size_type hash_pos(size_type h) const
+  {
+    if (!old_buckets.empty() && h % old_buckets.size() >= rehash_pos)
+      return h % old_buckets.size();
+    return old_buckets.size() + h % buckets.size();
+  }
+
+  size_type bucket_pos(const node* n) const { return hash_pos(node_hash(n)); }
+
+  // The first element at bucket position pos or after it.  The old
+  // buckets below rehash_pos are all empty.
+  node* first_from(size_type pos) const
   {
-    return hash(key) % n;
+    if (pos < rehash_pos)
+      pos = rehash_pos;
+    for ( ; pos < end_pos(); ++pos)
+      if (node* first = chain(pos))
+        return first;
+    return 0;
   }
 
-  size_type bkt_num(const value_type& obj, size_t n) const
+  void rehash_step(size_type count);
+  void finish_rehash()
   {
-    return bkt_num_key(get_key(obj), n);
+    if (!old_buckets.empty())
+      rehash_step(old_buckets.size());
   }
+#else /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
+  node*& chain(size_type pos) { return buckets[pos]; }
+  node* chain(size_type pos) const { return buckets[pos]; }
+  size_type end_pos() const { return buckets.size(); }
+  size_type hash_pos(size_type h) const { return h % buckets.size(); }
+  size_type bucket_pos(const node* n) const { return hash_pos(node_hash(n)); }
+
+  node* first_from(size_type pos) const
+  {
+    for ( ; pos < buckets.size(); ++pos)
+      if (buckets[pos])
+        return buckets[pos];
+    return 0;
+  }
+
+  void finish_rehash() {}
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
+
+  void grow(size_type num_elements_hint);
 
   node* new_node(const value_type& obj)
   {
@@ -491,8 +592,8 @@ private:
     node_allocator::deallocate(n);
   }
 
-  void erase_bucket(const size_type n, node* first, node* last);
-  void erase_bucket(const size_type n, node* last);
+  void erase_bucket(const size_type pos, node* first, node* last);
+  void erase_bucket(const size_type pos, node* last);
 
   void copy_from(const hashtable& ht);
 
@@ -504,11 +605,8 @@ __hashtable_iterator<V, K, HF, ExK, EqK, A>::operator++()
 {
   const node* old = cur;
   cur = cur->next;
-  if (!cur) {
-    size_type bucket = ht->bkt_num(old->val);
-    while (!cur && ++bucket < ht->buckets.size())
-      cur = ht->buckets[bucket];
-  }
+  if (!cur)
+    cur = ht->first_from(ht->bucket_pos(old) + 1);
   return *this;
 }
 
@@ -527,11 +625,8 @@ __hashtable_const_iterator<V, K, HF, ExK, EqK, A>::operator++()
 {
   const node* old = cur;
   cur = cur->next;
-  if (!cur) {
-    size_type bucket = ht->bkt_num(old->val);
-    while (!cur && ++bucket < ht->buckets.size())
-      cur = ht->buckets[bucket];
-  }
+  if (!cur)
+    cur = ht->first_from(ht->bucket_pos(old) + 1);
   return *this;
 }
 
@@ -594,11 +689,16 @@ bool operator==(const hashtable<V, K, HF, Ex, Eq, A>& ht1,
                 const hashtable<V, K, HF, Ex, Eq, A>& ht2)
 {
   typedef typename hashtable<V, K, HF, Ex, Eq, A>::node node;
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+  if (ht1.old_buckets.size() != ht2.old_buckets.size()
+      || ht1.rehash_pos != ht2.rehash_pos)
+    return false;
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
   if (ht1.buckets.size() != ht2.buckets.size())
     return false;
-  for (int n = 0; n < ht1.buckets.size(); ++n) {
-    node* cur1 = ht1.buckets[n];
-    node* cur2 = ht2.buckets[n];
+  for (size_t n = 0; n < ht1.end_pos(); ++n) {
+    node* cur1 = ht1.chain(n);
+    node* cur2 = ht2.chain(n);
     for ( ; cur1 && cur2 && cur1->val == cur2->val;
           cur1 = cur1->next, cur2 = cur2->next)
       {}
@@ -623,16 +723,18 @@ template <class V, class K, class HF, class Ex, class Eq, class A>
 pair<typename hashtable<V, K, HF, Ex, Eq, A>::iterator, bool> 
 hashtable<V, K, HF, Ex, Eq, A>::insert_unique_noresize(const value_type& obj)
 {
-  const size_type n = bkt_num(obj);
-  node* first = buckets[n];
+  const size_type h = hash(get_key(obj));
+  const size_type n = hash_pos(h);
+  node* first = chain(n);
 
   for (node* cur = first; cur; cur = cur->next) 
-    if (equals(get_key(cur->val), get_key(obj)))
+    if (node_has_key(cur, h, get_key(obj)))
       return pair<iterator, bool>(iterator(cur, this), false);
 
   node* tmp = new_node(obj);
+  set_node_hash(tmp, h);
   tmp->next = first;
-  buckets[n] = tmp;
+  chain(n) = tmp;
   ++num_elements;
   return pair<iterator, bool>(iterator(tmp, this), true);
 }
@@ -641,12 +743,14 @@ template <class V, class K, class HF, class Ex, class Eq, class A>
 typename hashtable<V, K, HF, Ex, Eq, A>::iterator 
 hashtable<V, K, HF, Ex, Eq, A>::insert_equal_noresize(const value_type& obj)
 {
-  const size_type n = bkt_num(obj);
-  node* first = buckets[n];
+  const size_type h = hash(get_key(obj));
+  const size_type n = hash_pos(h);
+  node* first = chain(n);
 
   for (node* cur = first; cur; cur = cur->next) 
-    if (equals(get_key(cur->val), get_key(obj))) {
+    if (node_has_key(cur, h, get_key(obj))) {
       node* tmp = new_node(obj);
+      set_node_hash(tmp, h);
       tmp->next = cur->next;
       cur->next = tmp;
       ++num_elements;
@@ -654,8 +758,9 @@ hashtable<V, K, HF, Ex, Eq, A>::insert_equal_noresize(const value_type& obj)
     }
 
   node* tmp = new_node(obj);
+  set_node_hash(tmp, h);
   tmp->next = first;
-  buckets[n] = tmp;
+  chain(n) = tmp;
   ++num_elements;
   return iterator(tmp, this);
 }
@@ -664,18 +769,20 @@ template <class V, class K, class HF, class Ex, class Eq, class A>
 typename hashtable<V, K, HF, Ex, Eq, A>::reference 
 hashtable<V, K, HF, Ex, Eq, A>::find_or_insert(const value_type& obj)
 {
-  resize(num_elements + 1);
+  grow(num_elements + 1);
 
-  size_type n = bkt_num(obj);
-  node* first = buckets[n];
+  const size_type h = hash(get_key(obj));
+  const size_type n = hash_pos(h);
+  node* first = chain(n);
 
   for (node* cur = first; cur; cur = cur->next)
-    if (equals(get_key(cur->val), get_key(obj)))
+    if (node_has_key(cur, h, get_key(obj)))
       return cur->val;
 
   node* tmp = new_node(obj);
+  set_node_hash(tmp, h);
   tmp->next = first;
-  buckets[n] = tmp;
+  chain(n) = tmp;
   ++num_elements;
   return tmp->val;
 }
@@ -686,18 +793,15 @@ pair<typename hashtable<V, K, HF, Ex, Eq, A>::iterator,
 hashtable<V, K, HF, Ex, Eq, A>::equal_range(const key_type& key)
 {
   typedef pair<iterator, iterator> pii;
-  const size_type n = bkt_num_key(key);
+  const size_type h = hash(key);
+  const size_type n = hash_pos(h);
 
-  for (node* first = buckets[n]; first; first = first->next) {
-    if (equals(get_key(first->val), key)) {
+  for (node* first = chain(n); first; first = first->next) {
+    if (node_has_key(first, h, key)) {
       for (node* cur = first->next; cur; cur = cur->next)
-        if (!equals(get_key(cur->val), key))
+        if (!node_has_key(cur, h, key))
           return pii(iterator(first, this), iterator(cur, this));
-      for (size_type m = n + 1; m < buckets.size(); ++m)
-        if (buckets[m])
-          return pii(iterator(first, this),
-                     iterator(buckets[m], this));
-      return pii(iterator(first, this), end());
+      return pii(iterator(first, this), iterator(first_from(n + 1), this));
     }
   }
   return pii(end(), end());
@@ -709,19 +813,17 @@ pair<typename hashtable<V, K, HF, Ex, Eq, A>::const_iterator,
 hashtable<V, K, HF, Ex, Eq, A>::equal_range(const key_type& key) const
 {
   typedef pair<const_iterator, const_iterator> pii;
-  const size_type n = bkt_num_key(key);
+  const size_type h = hash(key);
+  const size_type n = hash_pos(h);
 
-  for (const node* first = buckets[n] ; first; first = first->next) {
-    if (equals(get_key(first->val), key)) {
+  for (const node* first = chain(n) ; first; first = first->next) {
+    if (node_has_key(first, h, key)) {
       for (const node* cur = first->next; cur; cur = cur->next)
-        if (!equals(get_key(cur->val), key))
+        if (!node_has_key(cur, h, key))
           return pii(const_iterator(first, this),
                      const_iterator(cur, this));
-      for (size_type m = n + 1; m < buckets.size(); ++m)
-        if (buckets[m])
-          return pii(const_iterator(first, this),
-                     const_iterator(buckets[m], this));
-      return pii(const_iterator(first, this), end());
+      return pii(const_iterator(first, this),
+                 const_iterator(first_from(n + 1), this));
     }
   }
   return pii(end(), end());
@@ -731,15 +833,16 @@ template <class V, class K, class HF, class Ex, class Eq, class A>
 typename hashtable<V, K, HF, Ex, Eq, A>::size_type 
 hashtable<V, K, HF, Ex, Eq, A>::erase(const key_type& key)
 {
-  const size_type n = bkt_num_key(key);
-  node* first = buckets[n];
+  const size_type h = hash(key);
+  const size_type n = hash_pos(h);
+  node* first = chain(n);
   size_type erased = 0;
 
   if (first) {
     node* cur = first;
     node* next = cur->next;
     while (next) {
-      if (equals(get_key(next->val), key)) {
+      if (node_has_key(next, h, key)) {
         cur->next = next->next;
         delete_node(next);
         next = cur->next;
@@ -751,8 +854,8 @@ hashtable<V, K, HF, Ex, Eq, A>::erase(const key_type& key)
         next = cur->next;
       }
     }
-    if (equals(get_key(first->val), key)) {
-      buckets[n] = first->next;
+    if (node_has_key(first, h, key)) {
+      chain(n) = first->next;
       delete_node(first);
       ++erased;
       --num_elements;
@@ -765,11 +868,11 @@ template <class V, class K, class HF, class Ex, class Eq, class A>
 void hashtable<V, K, HF, Ex, Eq, A>::erase(const iterator& it)
 {
   if (node* const p = it.cur) {
-    const size_type n = bkt_num(p->val);
-    node* cur = buckets[n];
+    const size_type n = bucket_pos(p);
+    node* cur = chain(n);
 
     if (cur == p) {
-      buckets[n] = cur->next;
+      chain(n) = cur->next;
       delete_node(cur);
       --num_elements;
     }
@@ -794,8 +897,8 @@ void hashtable<V, K, HF, Ex, Eq, A>::erase(const iterator& it)
 template <class V, class K, class HF, class Ex, class Eq, class A>
 void hashtable<V, K, HF, Ex, Eq, A>::erase(iterator first, iterator last)
 {
-  size_type f_bucket = first.cur ? bkt_num(first.cur->val) : buckets.size();
-  size_type l_bucket = last.cur ? bkt_num(last.cur->val) : buckets.size();
+  size_type f_bucket = first.cur ? bucket_pos(first.cur) : end_pos();
+  size_type l_bucket = last.cur ? bucket_pos(last.cur) : end_pos();
 
   if (first.cur == last.cur)
     return;
@@ -805,7 +908,7 @@ void hashtable<V, K, HF, Ex, Eq, A>::erase(iterator first, iterator last)
     erase_bucket(f_bucket, first.cur, 0);
     for (size_type n = f_bucket + 1; n < l_bucket; ++n)
       erase_bucket(n, 0);
-    if (l_bucket != buckets.size())
+    if (l_bucket != end_pos())
       erase_bucket(l_bucket, last.cur);
   }
 }
@@ -832,6 +935,7 @@ hashtable<V, K, HF, Ex, Eq, A>::erase(const const_iterator& it)
 template <class V, class K, class HF, class Ex, class Eq, class A>
 void hashtable<V, K, HF, Ex, Eq, A>::resize(size_type num_elements_hint)
 {
+  finish_rehash();
   const size_type old_n = buckets.size();
   if (num_elements_hint > old_n) {
     const size_type n = next_size(num_elements_hint);
@@ -841,7 +945,7 @@ void hashtable<V, K, HF, Ex, Eq, A>::resize(size_type num_elements_hint)
         for (size_type bucket = 0; bucket < old_n; ++bucket) {
           node* first = buckets[bucket];
           while (first) {
-            size_type new_bucket = bkt_num(first->val, n);
+            size_type new_bucket = node_hash(first) % n;
             buckets[bucket] = first->next;
             first->next = tmp[new_bucket];
             tmp[new_bucket] = first;
@@ -866,13 +970,67 @@ void hashtable<V, K, HF, Ex, Eq, A>::resize(size_type num_elements_hint)
   }
 }
 
+// Make room for num_elements_hint elements the way an insert should:
+// at once, or by starting or continuing an incremental resize.
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void hashtable<V, K, HF, Ex, Eq, A>::grow(size_type num_elements_hint)
+{
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+  if (!old_buckets.empty()) {
+    if (num_elements_hint > buckets.size())
+      finish_rehash();
+    else
+      rehash_step(__stl_rehash_step);
+  }
+  if (old_buckets.empty() && num_elements_hint > buckets.size()) {
+    const size_type n = next_size(num_elements_hint);
+    if (n > buckets.size()) {
+      vector<node*, A> tmp(n, (node*) 0);
+      old_buckets.swap(buckets);
+      buckets.swap(tmp);
+      rehash_pos = 0;
+      rehash_step(__stl_rehash_step);
+    }
+  }
+#else /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
+  resize(num_elements_hint);
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
+}
+
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+// Move the elements of the next count old buckets into the current ones,
+// and drop the old buckets once they are all empty.
+template <class V, class K, class HF, class Ex, class Eq, class A>
+void hashtable<V, K, HF, Ex, Eq, A>::rehash_step(size_type count)
+{
+  const size_type old_n = old_buckets.size();
+  const size_type n = buckets.size();
+
+  for ( ; count > 0 && rehash_pos < old_n; --count, ++rehash_pos) {
+    node* first = old_buckets[rehash_pos];
+    while (first) {
+      size_type new_bucket = node_hash(first) % n;
+      old_buckets[rehash_pos] = first->next;
+      first->next = buckets[new_bucket];
+      buckets[new_bucket] = first;
+      first = old_buckets[rehash_pos];
+    }
+  }
+  if (rehash_pos == old_n) {
+    vector<node*, A> tmp;
+    old_buckets.swap(tmp);
+    rehash_pos = 0;
+  }
+}
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
+
 template <class V, class K, class HF, class Ex, class Eq, class A>
-void hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type n, 
+void hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type pos, 
                                                   node* first, node* last)
 {
-  node* cur = buckets[n];
+  node* cur = chain(pos);
   if (cur == first)
-    erase_bucket(n, last);
+    erase_bucket(pos, last);
   else {
     node* next;
     for (next = cur->next; next != first; cur = next, next = cur->next)
@@ -888,14 +1046,14 @@ void hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type n,
 
 template <class V, class K, class HF, class Ex, class Eq, class A>
 void 
-hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type n, node* last)
+hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type pos, node* last)
 {
-  node* cur = buckets[n];
+  node* cur = chain(pos);
   while (cur != last) {
     node* next = cur->next;
     delete_node(cur);
     cur = next;
-    buckets[n] = cur;
+    chain(pos) = cur;
     --num_elements;
   }
 }
@@ -903,15 +1061,22 @@ hashtable<V, K, HF, Ex, Eq, A>::erase_bucket(const size_type n, node* last)
 template <class V, class K, class HF, class Ex, class Eq, class A>
 void hashtable<V, K, HF, Ex, Eq, A>::clear()
 {
-  for (size_type i = 0; i < buckets.size(); ++i) {
-    node* cur = buckets[i];
+  for (size_type i = 0; i < end_pos(); ++i) {
+    node* cur = chain(i);
     while (cur != 0) {
       node* next = cur->next;
       delete_node(cur);
       cur = next;
     }
-    buckets[i] = 0;
+    chain(i) = 0;
+  }
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+  if (!old_buckets.empty()) {
+    vector<node*, A> tmp;
+    old_buckets.swap(tmp);
+    rehash_pos = 0;
   }
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
   num_elements = 0;
 }
 
@@ -922,15 +1087,22 @@ void hashtable<V, K, HF, Ex, Eq, A>::copy_from(const hashtable& ht)
   buckets.clear();
   buckets.reserve(ht.buckets.size());
   buckets.insert(buckets.end(), ht.buckets.size(), (node*) 0);
+#ifdef __STL_HASHTABLE_INCREMENTAL_RESIZE
+  old_buckets.clear();
+  old_buckets.insert(old_buckets.end(), ht.old_buckets.size(), (node*) 0);
+  rehash_pos = ht.rehash_pos;
+#endif /* __STL_HASHTABLE_INCREMENTAL_RESIZE */
   __STL_TRY {
-    for (size_type i = 0; i < ht.buckets.size(); ++i) {
-      if (const node* cur = ht.buckets[i]) {
+    for (size_type i = 0; i < ht.end_pos(); ++i) {
+      if (const node* cur = ht.chain(i)) {
         node* copy = new_node(cur->val);
-        buckets[i] = copy;
+        copy_node_hash(copy, cur);
+        chain(i) = copy;
 
         for (node* next = cur->next; next; cur = next, next = cur->next) {
           copy->next = new_node(next->val);
           copy = copy->next;
+          copy_node_hash(copy, next);
         }
       }
     }
@@ -0,0 +1,143 @@
+// Test the flat hashed containers against hash_map and hash_set: both
+// are given the same inserts, lookups and erasures, and must agree on
+// what they hold.
+
+#include <iostream.h>
+#include <hash_map.h>
+#include <hash_set.h>
+#include <flat_hash_map.h>
+#include <flat_hash_set.h>
+#include <string>
+#include <stdio.h>
+
+static unsigned long random_state = 1;
+
+// Return a pseudo-random number, so that the keys do not depend on the
+// host's rand.
+static unsigned long
+random_number ()
+{
+  random_state = (random_state * 1103515245 + 12345) & 0xffffffff;
+  return random_state >> 1;
+}
+
+static string
+make_string (int n)
+{
+  char buf[32];
+  sprintf (buf, "key-%d", n);
+  return buf;
+}
+
+struct string_hash
+{
+  size_t operator() (const string& s) const
+    { return __stl_hash_string (s.c_str ()); }
+};
+
+// The element holding key K, for sets and for maps.
+
+inline int
+value_of (int k, int *)
+{
+  return k;
+}
+
+template <class Key>
+inline pair<const Key, int>
+value_of (const Key& k, pair<const Key, int> *)
+{
+  return pair<const Key, int> (k, 0);
+}
+
+inline int
+key_of (int k)
+{
+  return k;
+}
+
+template <class Key>
+inline Key
+key_of (const pair<const Key, int>& p)
+{
+  return p.first;
+}
+
+// Insert, look up and erase KEYS in a Table, and return a checksum of
+// the results and of the keys that are left.  Half the keys are
+// inserted twice and some of them are erased, also twice, so that
+// erased slots are reused.
+
+template <class Table, class Key>
+struct exercise
+{
+  static unsigned long
+  run (const Key *keys, int n)
+  {
+    typedef typename Table::value_type value_type;
+    unsigned long sum = 0;
+    Table t;
+    int i;
+
+    for (i = 0; i < n; i++)
+      sum = sum * 3 + t.insert (value_of (keys[i], (value_type *) 0)).second;
+    for (i = 0; i < n; i++)
+      {
+	sum = sum * 3 + t.count (keys[i]);
+	sum = sum * 3 + (t.find (keys[n - 1 - i]) != t.end ());
+      }
+    for (i = 0; i < n; i += 3)
+      sum = sum * 3 + t.erase (keys[i]);
+    for (i = 0; i < n; i += 5)
+      sum = sum * 3 + t.insert (value_of (keys[i], (value_type *) 0)).second;
+
+    // The order of iteration differs between the two kinds of table, so
+    // add up the keys left instead.
+    unsigned long left = 0;
+    int count = 0;
+    for (typename Table::const_iterator it = t.begin (); it != t.end (); ++it)
+      {
+	left += t.count (key_of (*it));
+	count++;
+      }
+    if (count != t.size () || left != t.size ())
+      sum = 0;
+    return sum * 31 + t.size ();
+  }
+};
+
+static void
+check (const char *what, unsigned long expected, unsigned long sum)
+{
+  cout << what << (sum == expected ? " agrees" : " DISAGREES")
+       << " with the chained table\n";
+}
+
+#define N 3000
+
+int
+main ()
+{
+  int keys[N];
+  string strings[N];
+  int i;
+
+  for (i = 0; i < N; i++)
+    {
+      keys[i] = random_number () % (N * 2 / 3);
+      strings[i] = make_string (keys[i]);
+    }
+
+  check ("flat_hash_map<int>",
+	 exercise<hash_map<int, int>, int>::run (keys, N),
+	 exercise<flat_hash_map<int, int>, int>::run (keys, N));
+  check ("flat_hash_map<string>",
+	 exercise<hash_map<string, int, string_hash>, string>
+	 ::run (strings, N),
+	 exercise<flat_hash_map<string, int, string_hash>, string>
+	 ::run (strings, N));
+  check ("flat_hash_set<int>",
+	 exercise<hash_set<int>, int>::run (keys, N),
+	 exercise<flat_hash_set<int>, int>::run (keys, N));
+  return 0;
+}